@@ -0,0 +1,62 @@
+/**
+ * @file BenchmarkMachine.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "BenchmarkMachine.h"
+
+#include <Machine.h>
+#include <Crank.h>
+#include <Shaft.h>
+#include <Pulley.h>
+
+/// Horizontal distance between stages in pixels
+const int StageSpacing = 40;
+
+/**
+ * Create a machine driven by a crank through a train of stages.
+ *
+ * Each stage is a shaft turning a small pulley belted to a large
+ * pulley, which turns the next stage. A stage adds three models
+ * and three rotation connections.
+ *
+ * @param stages Number of stages
+ * @return Machine
+ */
+std::shared_ptr<Machine> CreateBenchmarkMachine(int stages)
+{
+    auto machine = std::make_shared<Machine>();
+
+    auto crank = std::make_shared<Crank>();
+    crank->SetPosition(0, -100);
+    crank->SetSpeed(0.5);
+    machine->AddComponent(crank);
+
+    RotationSource* source = crank->GetSource();
+    for (int i = 0; i < stages; i++)
+    {
+        int x = -StageSpacing * (i + 1);
+
+        auto shaft = std::make_shared<Shaft>();
+        shaft->SetPosition(x, -100);
+        shaft->SetSize(10, StageSpacing);
+        machine->AddComponent(shaft);
+        source->AddSink(shaft->GetSink());
+
+        auto small = std::make_shared<Pulley>(30, 15);
+        small->SetPosition(x, -100);
+        machine->AddComponent(small);
+        shaft->GetSource()->AddSink(small->GetSink());
+
+        auto large = std::make_shared<Pulley>(80, 15);
+        large->SetPosition(x, -20);
+        machine->AddComponent(large);
+        small->BeltTo(large);
+
+        source = large->GetSource();
+    }
+
+    machine->Compile();
+    return machine;
+}
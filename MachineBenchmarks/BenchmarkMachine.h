@@ -0,0 +1,17 @@
+/**
+ * @file BenchmarkMachine.h
+ * @author Thomas Conley
+ *
+ * Machines of any size for the benchmarks.
+ */
+
+#ifndef BENCHMARKMACHINE_H
+#define BENCHMARKMACHINE_H
+
+#include <memory>
+
+class Machine;
+
+std::shared_ptr<Machine> CreateBenchmarkMachine(int stages);
+
+#endif //BENCHMARKMACHINE_H
@@ -0,0 +1,125 @@
+/**
+ * @file DrawingBenchmarks.cpp
+ * @author Thomas Conley
+ *
+ * Benchmarks of the drawing hot paths. Everything is drawn
+ * into an offscreen image.
+ */
+
+#include "pch.h"
+#include <benchmark/benchmark.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include <Cylinder.h>
+#include <Polygon.h>
+#include <Sparty.h>
+
+/// Size of the offscreen image in pixels
+const int ImageSize = 512;
+
+/**
+ * Create a graphics context that draws on an offscreen image
+ * @param image Image to draw on, must outlive the context
+ * @return Graphics context
+ */
+static std::shared_ptr<wxGraphicsContext> CreateGraphics(wxImage& image)
+{
+    image.Create(ImageSize, ImageSize);
+    return std::shared_ptr<wxGraphicsContext>(wxGraphicsContext::Create(image));
+}
+
+/**
+ * Draw a cylinder. The argument is the number of lines on it.
+ * @param state Benchmark state
+ */
+static void BM_CylinderDraw(benchmark::State& state)
+{
+    wxImage image;
+    auto graphics = CreateGraphics(image);
+
+    cse335::Cylinder cylinder;
+    cylinder.SetSize(80, 15);
+    cylinder.SetColour(wxColour(205, 250, 5));
+    cylinder.SetLines(wxColour(139, 168, 7), 4, (int)state.range(0));
+
+    double rotation = 0;
+    for (auto _ : state)
+    {
+        rotation += 0.01;
+        cylinder.Draw(graphics, ImageSize / 2, ImageSize / 2, rotation);
+    }
+}
+BENCHMARK(BM_CylinderDraw)->Arg(0)->Arg(5)->Arg(15)->Arg(50);
+
+/**
+ * Draw a color polygon. The argument is the number of points.
+ * @param state Benchmark state
+ */
+static void BM_PolygonDrawColor(benchmark::State& state)
+{
+    wxImage image;
+    auto graphics = CreateGraphics(image);
+
+    cse335::Polygon polygon;
+    polygon.SetColor(wxColour(255, 0, 0));
+    polygon.Circle(100, (int)state.range(0));
+
+    double rotation = 0;
+    for (auto _ : state)
+    {
+        rotation += 0.01;
+        polygon.DrawPolygon(graphics, ImageSize / 2, ImageSize / 2, rotation);
+    }
+}
+BENCHMARK(BM_PolygonDrawColor)->Arg(4)->Arg(32)->Arg(256);
+
+/**
+ * Draw an image polygon. The argument is the image size in pixels.
+ * @param state Benchmark state
+ */
+static void BM_PolygonDrawImage(benchmark::State& state)
+{
+    wxImage image;
+    auto graphics = CreateGraphics(image);
+
+    int size = (int)state.range(0);
+    wxImage texture(size, size);
+    texture.InitAlpha();
+    wxString filename = wxFileName::CreateTempFileName("bench") + ".png";
+    texture.SaveFile(filename, wxBITMAP_TYPE_PNG);
+
+    cse335::Polygon polygon;
+    polygon.SetImage(filename.ToStdWstring());
+    polygon.Rectangle(-size / 2, 0, size, size);
+
+    double rotation = 0;
+    for (auto _ : state)
+    {
+        rotation += 0.01;
+        polygon.DrawPolygon(graphics, ImageSize / 2, ImageSize / 2, rotation);
+    }
+
+    wxRemoveFile(filename);
+}
+BENCHMARK(BM_PolygonDrawImage)->Arg(32)->Arg(128)->Arg(512);
+
+/**
+ * Draw Sparty's spring. The argument is the number of links.
+ * @param state Benchmark state
+ */
+static void BM_SpartyDrawSpring(benchmark::State& state)
+{
+    wxImage image;
+    auto graphics = CreateGraphics(image);
+
+    Sparty sparty(L"sparty.png", 212, 260, 80, (int)state.range(0));
+
+    double length = 40;
+    for (auto _ : state)
+    {
+        length = length < 260 ? length + 1 : 40;
+        sparty.DrawSpring(graphics, ImageSize / 2, ImageSize - 10, length, 80, (int)state.range(0));
+    }
+}
+BENCHMARK(BM_SpartyDrawSpring)->Arg(5)->Arg(15)->Arg(60);
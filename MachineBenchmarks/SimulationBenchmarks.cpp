@@ -0,0 +1,150 @@
+/**
+ * @file SimulationBenchmarks.cpp
+ * @author Thomas Conley
+ *
+ * Benchmarks of stepping and seeking the machine simulation.
+ * The argument of each benchmark is the number of machine stages.
+ */
+
+#include "pch.h"
+#include <benchmark/benchmark.h>
+
+#include <MachineSystem.h>
+#include <Machine.h>
+#include <RotationSource.h>
+#include <RotatingModel.h>
+#include "BenchmarkMachine.h"
+
+/**
+ * Run a benchmark for each machine size
+ * @param benchmark Benchmark to add the sizes to
+ */
+static void MachineSizes(benchmark::internal::Benchmark* benchmark)
+{
+    for (int stages : {1, 10, 100, 1000})
+    {
+        benchmark->Arg(stages);
+    }
+}
+
+/**
+ * Advance a machine by one frame
+ * @param state Benchmark state
+ */
+static void BM_MachineAdvance(benchmark::State& state)
+{
+    auto machine = CreateBenchmarkMachine((int)state.range(0));
+    for (auto _ : state)
+    {
+        machine->Advance(1.0 / 30.0);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MachineAdvance)->Apply(MachineSizes);
+
+/**
+ * Seek forward 300 frames. The second argument selects
+ * direct evaluation (1) or stepping (0). Checkpoints are off,
+ * so stepping runs every tick instead of restoring the last one.
+ * @param state Benchmark state
+ */
+static void BM_SetMachineFrameForward(benchmark::State& state)
+{
+    MachineSystem system(L".");
+    system.SetMachine(CreateBenchmarkMachine((int)state.range(0)));
+    system.SetEvaluateDirectly(state.range(1) != 0);
+    system.SetCheckpointInterval(0);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        system.SetMachineFrame(0);
+        state.ResumeTiming();
+
+        system.SetMachineFrame(300);
+    }
+}
+BENCHMARK(BM_SetMachineFrameForward)->ArgsProduct({{1, 10, 100, 1000}, {0, 1}});
+
+/**
+ * Seek backward from frame 900 to frame 450, using checkpoints
+ * when stepping. The second argument selects direct evaluation
+ * (1) or stepping (0).
+ * @param state Benchmark state
+ */
+static void BM_SetMachineFrameBackward(benchmark::State& state)
+{
+    MachineSystem system(L".");
+    system.SetMachine(CreateBenchmarkMachine((int)state.range(0)));
+    system.SetEvaluateDirectly(state.range(1) != 0);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        system.SetMachineFrame(900);
+        state.ResumeTiming();
+
+        system.SetMachineFrame(450);
+    }
+}
+BENCHMARK(BM_SetMachineFrameBackward)->ArgsProduct({{1, 10, 100, 1000}, {0, 1}});
+
+/**
+ * Rotate a source that fans out to many sinks
+ * @param state Benchmark state
+ */
+static void BM_RotationSourceRotate(benchmark::State& state)
+{
+    RotationSource source;
+    std::vector<std::shared_ptr<RotatingModel>> sinks;
+    for (int i = 0; i < state.range(0); i++)
+    {
+        auto sink = std::make_shared<RotatingModel>();
+        source.AddSink(sink);
+        sinks.push_back(sink);
+    }
+
+    double rotation = 0;
+    for (auto _ : state)
+    {
+        rotation += 0.01;
+        source.Rotate(rotation);
+    }
+
+    benchmark::DoNotOptimize(sinks.back()->GetRotation());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RotationSourceRotate)->Apply(MachineSizes);
+
+/**
+ * Build a machine and make it the current machine
+ * @param state Benchmark state
+ */
+static void BM_SetMachine(benchmark::State& state)
+{
+    MachineSystem system(L".");
+    for (auto _ : state)
+    {
+        system.SetMachine(CreateBenchmarkMachine((int)state.range(0)));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SetMachine)->Apply(MachineSizes);
+
+/**
+ * Flip between the two machines with the machine cache
+ * @param state Benchmark state
+ */
+static void BM_ChooseMachineCached(benchmark::State& state)
+{
+    MachineSystem system(L".");
+    int machine = 1;
+    for (auto _ : state)
+    {
+        machine = 3 - machine;
+        system.ChooseMachine(machine);
+    }
+}
+BENCHMARK(BM_ChooseMachineCached);
@@ -0,0 +1,64 @@
+/**
+ * @file benchmark_main.cpp
+ * @author Thomas Conley
+ *
+ * Entry point for the machine benchmarks. Results are written
+ * to MachineBenchmarks.json unless --benchmark_out is given.
+ */
+
+#include "pch.h"
+#include <benchmark/benchmark.h>
+#include <ImageCache.h>
+#include <cstring>
+#include <vector>
+
+/**
+ * Main entry point
+ * @param argc Argument count
+ * @param argv Arguments
+ * @return Exit code
+ */
+int main(int argc, char** argv)
+{
+    // Drawing benchmarks need the GUI library initialized,
+    // but no window or event loop is ever created
+    wxApp::SetInstance(new wxApp());
+    if (!wxEntryStart(argc, argv))
+    {
+        fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+
+    wxInitAllImageHandlers();
+
+    std::vector<char*> args(argv, argv + argc);
+    bool hasOut = false;
+    for (int i = 1; i < argc; i++)
+    {
+        hasOut = hasOut || strncmp(argv[i], "--benchmark_out=", 16) == 0;
+    }
+
+    char out[] = "--benchmark_out=MachineBenchmarks.json";
+    char format[] = "--benchmark_out_format=json";
+    if (!hasOut)
+    {
+        args.push_back(out);
+        args.push_back(format);
+    }
+
+    int count = (int)args.size();
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data()))
+    {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    // The drawing benchmarks draw polygons outside of any machine
+    // system, so their cached graphics bitmaps must go before wxWidgets does
+    cse335::ImageCache::Get().Clear();
+    wxEntryCleanup();
+    return 0;
+}
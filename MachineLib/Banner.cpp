@@ -5,6 +5,7 @@
 
 #include "pch.h"
 #include "Banner.h"
+#include "MachineArena.h"
 #include <wx/graphics.h>
 #include <wx/region.h>
 #include <memory>
@@ -26,11 +27,6 @@ const double BannerRollHeight = 300 * BannerScale;
 /// Width of the banner roll image in pixels
 double const BannerRollWidth = 16 * BannerScale;
 
-/// How fast ot unfurl the banner in pixels per second
-double const BannerSpeed = 41.65;
-
-/// Minimum number of pixels to start with as unfurled
-const double BannerMinimum = 15;
 
 
 
@@ -40,9 +36,7 @@ const double BannerMinimum = 15;
  */
 Banner::Banner(const std::wstring& imagesDir)
     : mImagesDir(imagesDir),
-      mCurrentHeight(BannerMinimum),
-      mUnfurlSpeed(BannerSpeed),
-      mUnfurlProgress(0)
+      mModel(MachineArena::Make<BannerModel>(BannerWidth))
 {
     // Initialize the banner polygon as a rectangle (this defines the banner's shape)
     mBanner.Rectangle(-BannerWidth / 2, 0, BannerWidth, BannerHeight);  // Centered banner
@@ -53,36 +47,6 @@ Banner::Banner(const std::wstring& imagesDir)
 }
 
 
-/**
- * Method to trigger the unfurling when the key is dropped
- * @param keyY
- */
-void Banner::KeyDroppedTriggered(double keyY) {
-    mIsUnfurling = true;
-    mUnfurlProgress = 0;
-}
-
-/**
- * Update method to handle the banner's unfurling progress
- * @param delta
- */
-void Banner::Advance(double delta)
-{
-    if (mIsUnfurling) {
-        // Gradually increase the progress of the unfurling
-        mUnfurlProgress += mUnfurlSpeed * delta;
-
-        // Ensure that unfurl progress does not exceed the banner width
-        if (mUnfurlProgress >= BannerWidth) {
-            mUnfurlProgress = BannerWidth;  // Cap progress to the banner width
-            mIsUnfurling = false;  // Stop unfurling once fully revealed
-        }
-
-        mCurrentHeight = mUnfurlProgress;  // Set the current height to the unfurl progress
-    }
-}
-
-
 /**
  * Method to draw the banner
  * @param graphics
@@ -94,7 +58,7 @@ void Banner::Draw(std::shared_ptr<wxGraphicsContext> graphics) {
     DrawBannerRoll(graphics, GetPosition().x + BannerWidth/2, GetPosition().y);
 
     // If the banner is still unfurling or partially unfurled, draw the banner image
-    if (mIsUnfurling || (mUnfurlProgress > 0)) {
+    if (mModel->IsUnfurling() || (mModel->GetUnfurlProgress() > 0)) {
         // Draw the banner image that is being unfurled, coming out from the left
         DrawBannerImage(graphics, GetPosition().x - BannerWidth / 2, GetPosition().y - BannerHeight);
     }
@@ -123,7 +87,7 @@ void Banner::DrawBannerImage(std::shared_ptr<wxGraphicsContext> graphics, int x,
 
     // Define the clipping rectangle: Only show the banner portion to the left of the roll
     //int clipWidth = mUnfurlProgress - BannerWidth;
-    wxRect clipRect(x + BannerWidth, y, -mUnfurlProgress, BannerHeight);  // Clip to the left portion of the banner
+    wxRect clipRect(x + BannerWidth, y, -mModel->GetUnfurlProgress(), BannerHeight);  // Clip to the left portion of the banner
 
     // Create a region from the clipping rectangle
     wxRegion region(clipRect);
@@ -142,22 +106,31 @@ void Banner::DrawBannerImage(std::shared_ptr<wxGraphicsContext> graphics, int x,
 }
 
 /**
- * Reset the banner
+ * Get the area the banner and its roll draw in
+ * @return Bounding box
  */
-void Banner::Reset()
+wxRect Banner::GetBoundingBox()
 {
-    mUnfurlProgress = 0;
-    mIsUnfurling = false;
+    auto position = GetPosition();
+    double rollX = position.x + BannerWidth / 2;
+    return BoundingBox(rollX - std::max(mModel->GetUnfurlProgress(), BannerRollWidth / 2),
+                       position.y - BannerHeight, rollX + BannerRollWidth / 2, position.y);
 }
 
+/**
+ * Get the values the banner's drawing depends on
+ * @param appearance Vector to append the values to
+ */
+void Banner::GetAppearance(std::vector<double>& appearance)
+{
+    appearance.push_back(mModel->GetUnfurlProgress());
+}
 
-
-
-
-
-
-
-
-
-
-
+/**
+ * Decode the banner images
+ */
+void Banner::LoadImages()
+{
+    mBanner.PreloadImage();
+    mBannerRoll.PreloadImage();
+}
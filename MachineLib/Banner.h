@@ -12,11 +12,11 @@
 #include <wx/bitmap.h>
 
 #include "Component.h"
-#include "IKeyDropListener.h"
 #include "Polygon.h"
+#include "BannerModel.h"
 
 /// Creates and draws the banner
-class Banner : public Component, public IKeyDropListener
+class Banner : public Component
 {
 private:
  /// Helper methods for drawing banner components
@@ -30,39 +30,31 @@ private:
  /// the banner pulled out
  cse335::Polygon mBanner;
 
- /// height of the banner
- double mCurrentHeight;        // Current height of the banner
- /// Flag to check if the banner is unfurling
- bool mIsUnfurling = false;
- /// Speed at which the banner unfurls
- double mUnfurlSpeed;
- /// the progress
- double mUnfurlProgress;
+ /// Simulation of the unfurling banner
+ std::shared_ptr<BannerModel> mModel;
 
 public:
  /// Constructor
  Banner(const std::wstring& imagesDir);
 
- /// Method to trigger the unfurling process
- void KeyDroppedTriggered(double keyY) override;
-
- /// Update method to handle the unfurling logic
- /// @param delta
- void Update(double delta) override {}
-
  /// Method to draw the banner using wxGraphicsContext
  void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
 
- void Reset() override;
+ /// Get the simulation model
+ /// @return BannerModel
+ std::shared_ptr<ComponentModel> GetModel() override {return mModel;}
 
- /// Set the frame
- void SetFrame() override{}
+ /// Get the name of the kind of component
+ /// @return Name
+ std::wstring GetName() override {return L"Banner";}
 
- /// Set the Time
- /// @param time
- void SetTime(double time) override{}
+ wxRect GetBoundingBox() override;
+ void GetAppearance(std::vector<double>& appearance) override;
+ void LoadImages() override;
 
- void Advance(double delta) override;
+ /// Get the listener that unfurls the banner when the key drops
+ /// @return IKeyDropListener
+ IKeyDropListener* GetKeyDropListener() {return mModel.get();}
 };
 
 
@@ -0,0 +1,92 @@
+/**
+ * @file BannerModel.cpp
+ * @author Thomas Conley
+ */
+
+#include "BannerModel.h"
+
+/// How fast ot unfurl the banner in pixels per second
+const double BannerSpeed = 41.65;
+
+/**
+ * Constructor
+ * @param width Width of the fully unfurled banner in pixels
+ */
+BannerModel::BannerModel(double width) : mWidth(width)
+{
+}
+
+/**
+ * Method to trigger the unfurling when the key is dropped
+ * @param time Machine time the key dropped
+ */
+void BannerModel::KeyDroppedTriggered(double time)
+{
+    mUnfurlTime = time;
+}
+
+/**
+ * Set the banner to a machine time. It unfurls again
+ * if the key drop is reported for this time.
+ * @param time Machine time in seconds
+ */
+void BannerModel::EvaluateAt(double time)
+{
+    *mTime = time;
+    mUnfurlTime = -1;
+}
+
+/**
+ * Reset the banner
+ */
+void BannerModel::Reset()
+{
+    *mTime = 0;
+    mUnfurlTime = -1;
+}
+
+/**
+ * Get how much of the banner is unfurled
+ * @return Unfurled width in pixels
+ */
+double BannerModel::GetUnfurlProgress() const
+{
+    if (mUnfurlTime < 0 || *mTime <= mUnfurlTime) {
+        return 0;
+    }
+
+    // Cap progress to the banner width
+    double progress = BannerSpeed * (*mTime - mUnfurlTime);
+    return progress < mWidth ? progress : mWidth;
+}
+
+/**
+ * Is the banner unfurling?
+ * @return true while the banner is still unfurling
+ */
+bool BannerModel::IsUnfurling() const
+{
+    return mUnfurlTime >= 0 && GetUnfurlProgress() < mWidth;
+}
+
+/**
+ * Save the unfurl state to a checkpoint
+ * @param state
+ */
+void BannerModel::SaveState(std::vector<double>& state)
+{
+    state.push_back(*mTime);
+    state.push_back(mUnfurlTime);
+}
+
+/**
+ * Restore the unfurl state from a checkpoint
+ * @param state
+ * @return Pointer past the values this banner saved
+ */
+const double* BannerModel::RestoreState(const double* state)
+{
+    *mTime = *state++;
+    mUnfurlTime = *state++;
+    return state;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file BannerModel.h
+ * @author Thomas Conley
+ *
+ *
+ */
+ 
+#ifndef BANNERMODEL_H
+#define BANNERMODEL_H
+#include "ComponentModel.h"
+#include "IKeyDropListener.h"
+#include "PooledState.h"
+
+/// Simulation of the banner, which unfurls when the key drops
+class BannerModel final : public ComponentModel, public IKeyDropListener {
+private:
+ /// Width of the fully unfurled banner in pixels
+ double mWidth;
+
+ /// Machine time in seconds, stepped by Mechanism with the other clocks
+ PooledState<double> mTime;
+
+ /// Machine time the banner started to unfurl, negative until the key drops
+ double mUnfurlTime = -1;
+
+public:
+ BannerModel(double width);
+ void Reset() override;
+
+ /// Advance the model clock
+ /// @param delta Time to advance in seconds
+ void Advance(double delta) override {*mTime += delta;}
+
+ /// Get the model clock, for Mechanism to pool
+ /// @return Machine time in seconds
+ PooledState<double>& GetClock() {return mTime;}
+
+ void EvaluateAt(double time) override;
+ void KeyDroppedTriggered(double time) override;
+ void SaveState(std::vector<double>& state) override;
+ const double* RestoreState(const double* state) override;
+ double GetUnfurlProgress() const;
+ bool IsUnfurling() const;
+
+ /// The unfurl progress is a function of the time since the key dropped
+ /// @return true
+ bool CanEvaluate() const override {return true;}
+};
+
+
+
+#endif //BANNERMODEL_H
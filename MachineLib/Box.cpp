@@ -6,6 +6,7 @@
 
 #include "pch.h"
 #include "Box.h"
+#include "MachineArena.h"
 
 ///To get the lid into the right place
 const int lidOffset = 250;
@@ -21,9 +22,7 @@ Box::Box(const std::wstring& imagesDir, int boxSize, int lidSize)
       mImagesDir(imagesDir),
       mBoxSize(boxSize),
       mLidSize(lidSize),
-      mLidAngle(0),
-      mAngleIncrement(1.0),
-      mIsOpen(false)  // Set mIsOpen to false initially
+      mModel(MachineArena::Make<BoxModel>())
 {
     mBox.Rectangle(-mBoxSize / 2, 0, mBoxSize, mBoxSize);
     mBox.SetImage(mImagesDir + L"/box-background.png");
@@ -41,27 +40,24 @@ Box::Box(const std::wstring& imagesDir, int boxSize, int lidSize)
  */
 void Box::Draw(std::shared_ptr<wxGraphicsContext> graphics)
 {
-    UpdatePosition();
-
     // Draw the box
     mBox.DrawPolygon(graphics, 0, 0);
 
     graphics->PushState();
 
     // Translate to lid position
-    double lidX = GetPosition().x;
-    double lidY = GetPosition().y - (mLid.GetImageHeight() / 2.0);
     graphics->Translate(0, 0);
 
     // Calculate the scale factor based on the lid angle
-    double sinValue = std::sin(mLidAngle);
-    mLidScale = mLidZeroAngleScale + (1.0 - mLidZeroAngleScale) * sinValue;
+    double sinValue = std::sin(mModel->GetLidAngle());
+    double lidScale = mLidZeroAngleScale + (1.0 - mLidZeroAngleScale) * sinValue;
+    lidScale = std::max(mLidZeroAngleScale, lidScale);
 
     // Adjust lid's position based on scale
-    double adjustedY = mLid.GetImageHeight() * (1.0 - mLidScale) / 2.0;
+    double adjustedY = mLid.GetImageHeight() * (1.0 - lidScale) / 2.0;
 
     graphics->Translate(0, -adjustedY);
-    graphics->Scale(1.0, mLidScale);
+    graphics->Scale(1.0, lidScale);
 
     // Draw the lid
     mLid.DrawPolygon(graphics, 0, 0);
@@ -83,71 +79,35 @@ void Box::DrawForeground(std::shared_ptr<wxGraphicsContext> graphics)
     graphics->PopState();
 }
 
-/// Update the lid position
-void Box::UpdatePosition()
-{
-    mLidScale = std::max(mLidZeroAngleScale, mLidScale);
-}
-
 /**
- * Advance the animation of lid opening
- * @param delta time
+ * Get the area the box and its lid draw in
+ * @return Bounding box
  */
-void Box::Advance(double delta)
+wxRect Box::GetBoundingBox()
 {
-    if (mIsOpen && mLidAngle <= M_PI / 2)
-    {
-        mLidAngle = mLidAngle + (M_PI / 2) * delta / mLidSpeed;
-        if (mLidAngle > M_PI / 2)
-        {
-            mLidAngle = M_PI / 2;
-        }
-        UpdatePosition();
-    }
-}
+    // The lid is squashed toward the middle of its image while closed
+    double lidTop = -2.0 * mLidSize;
+    double closedTop = lidTop * mLidZeroAngleScale -
+        mLid.GetImageHeight() * (1.0 - mLidZeroAngleScale) / 2.0;
 
-/// Reset the box to its original state
-void Box::Reset()
-{
-    mLidAngle = 0.0;
-    mIsOpen = false;
-    UpdatePosition();
-}
-
-/// Set the frame
-void Box::SetFrame()
-{
-    // Placeholder for setting the current frame of the box animation
+    return BoundingBox(-mBoxSize / 2, std::min(lidTop, closedTop), mBoxSize / 2, 0);
 }
 
-/// Set Time for lid animation
-/// @param time
-void Box::SetTime(double time)
-{
-    mLidScale = mLidZeroAngleScale + (time / mLidSpeed) * (1 - mLidZeroAngleScale);
-    mLidScale = std::min(mLidScale, 1.0);
-
-    UpdatePosition();
-}
-
-/// Flag for if the box is open
-/// @param open
-void Box::Open(bool open)
+/**
+ * Get the values the box's drawing depends on
+ * @param appearance Vector to append the values to
+ */
+void Box::GetAppearance(std::vector<double>& appearance)
 {
-    mIsOpen = open;
+    appearance.push_back(mModel->GetLidAngle());
 }
 
 /**
- * Connection to interface to see if the key has dropped
- * @param keyY
+ * Decode the box images
  */
-void Box::KeyDroppedTriggered(double keyY)
+void Box::LoadImages()
 {
-    // Only trigger the lid opening if it's not already open
-    if (!mIsOpen)
-    {
-        mIsOpen = true;  // This triggers the opening of the box lid
-    }
+    mBox.PreloadImage();
+    mLid.PreloadImage();
+    mForeground.PreloadImage();
 }
-
-
@@ -9,12 +9,12 @@
 #define BOX_H
 #include "Component.h"
 #include "Polygon.h"
-#include "IKeyDropListener.h"
+#include "BoxModel.h"
 
 /**
  * Creates and builds the box and lid
  */
-class Box : public Component, public IKeyDropListener { //, public IKeyDrop {
+class Box : public Component {
 private:
  /// The box background image
  cse335::Polygon mBox;
@@ -34,46 +34,40 @@ private:
  /// Size of the lid in pixels
  int mLidSize;
 
- /// Help with scaling the lid
- double mLidScale;
-
- /// Angle to determine lid position (in radians)
- double mLidAngle;
-
  /// Scale when the lid is fully closed
  const double mLidZeroAngleScale = 0.02;
 
- /// Increment for updating the angle (rate of change)
- double mAngleIncrement;
-
- /// flag to see if lid is open
- bool mIsOpen;
-
- /// lid opening speed
- const double mLidSpeed = 0.25;
+ /// Simulation of the lid
+ std::shared_ptr<BoxModel> mModel;
 
 public:
  Box(const std::wstring& imagesDir, int boxSize, int lidSize);
  void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
  void DrawForeground(std::shared_ptr<wxGraphicsContext> graphics) override;
- void UpdatePosition();
- void Advance(double delta) override;
- void Reset() override;
- void SetFrame() override;
- void SetTime(double time) override;
- void Open(bool open);
- void KeyDroppedTriggered(double keyY) override;
-
- /// Update the box if needed
- /// @param time
- void Update(double time) {};
 
- /// Set the lid angle
- /// @param angle
- void SetLidAngle(double angle) {mLidAngle = angle;}
+ /// Get the simulation model
+ /// @return BoxModel
+ std::shared_ptr<ComponentModel> GetModel() override {return mModel;}
+
+ /// Get the name of the kind of component
+ /// @return Name
+ std::wstring GetName() override {return L"Box";}
+
+ wxRect GetBoundingBox() override;
+ void GetAppearance(std::vector<double>& appearance) override;
+ void LoadImages() override;
 
+ /// Get the listener that opens the lid when the key drops
+ /// @return IKeyDropListener
+ IKeyDropListener* GetKeyDropListener() {return mModel.get();}
 
+ /// Flag for if the box is open
+ /// @param open
+ void Open(bool open) {mModel->Open(open);}
 
+ /// Set the lid angle
+ /// @param angle
+ void SetLidAngle(double angle) {mModel->SetLidAngle(angle);}
 };
 
 
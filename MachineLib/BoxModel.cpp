@@ -0,0 +1,105 @@
+/**
+ * @file BoxModel.cpp
+ * @author Thomas Conley
+ */
+
+#include "BoxModel.h"
+
+/// Time for the lid to fully open in seconds
+const double LidSpeed = 0.25;
+
+/// Lid angle when fully open (pi / 2)
+const double LidOpenAngle = 1.57079632679489661923;
+
+/**
+ * Set the box to a machine time. The lid opens again
+ * if the key drop is reported for this time.
+ * @param time Machine time in seconds
+ */
+void BoxModel::EvaluateAt(double time)
+{
+    *mTime = time;
+    mOpenTime = -1;
+}
+
+/// Reset the box to its original state
+void BoxModel::Reset()
+{
+    *mTime = 0;
+    mOpenTime = -1;
+}
+
+/**
+ * Connection to interface to see if the key has dropped
+ * @param time Machine time the key dropped
+ */
+void BoxModel::KeyDroppedTriggered(double time)
+{
+    // This triggers the opening of the box lid
+    if (mOpenTime < 0)
+    {
+        mOpenTime = time;
+    }
+}
+
+/**
+ * Flag for if the box is open
+ * @param open
+ */
+void BoxModel::Open(bool open)
+{
+    if (!open)
+    {
+        mOpenTime = -1;
+    }
+    else if (mOpenTime < 0)
+    {
+        mOpenTime = *mTime;
+    }
+}
+
+/**
+ * Set the lid angle. The lid keeps opening from this angle.
+ * @param angle Lid angle in radians
+ */
+void BoxModel::SetLidAngle(double angle)
+{
+    mOpenTime = *mTime - angle * LidSpeed / LidOpenAngle;
+}
+
+/**
+ * Get the lid angle
+ * @return Lid angle in radians, 0 is closed
+ */
+double BoxModel::GetLidAngle() const
+{
+    if (mOpenTime < 0 || *mTime <= mOpenTime)
+    {
+        return 0;
+    }
+
+    double angle = LidOpenAngle * (*mTime - mOpenTime) / LidSpeed;
+    return angle < LidOpenAngle ? angle : LidOpenAngle;
+}
+
+/**
+ * Save the lid state to a checkpoint
+ * @param state
+ */
+void BoxModel::SaveState(std::vector<double>& state)
+{
+    state.push_back(*mTime);
+    state.push_back(mOpenTime);
+}
+
+/**
+ * Restore the lid state from a checkpoint
+ * @param state
+ * @return Pointer past the values this box saved
+ */
+const double* BoxModel::RestoreState(const double* state)
+{
+    *mTime = *state++;
+    mOpenTime = *state++;
+    return state;
+}
@@ -0,0 +1,50 @@
+/**
+ * @file BoxModel.h
+ * @author Thomas Conley
+ *
+ *
+ */
+ 
+#ifndef BOXMODEL_H
+#define BOXMODEL_H
+#include "ComponentModel.h"
+#include "IKeyDropListener.h"
+#include "PooledState.h"
+
+/// Simulation of the box lid, which opens when the key drops
+class BoxModel final : public ComponentModel, public IKeyDropListener {
+private:
+ /// Machine time in seconds, stepped by Mechanism with the other clocks
+ PooledState<double> mTime;
+
+ /// Machine time the lid started to open, negative while closed
+ double mOpenTime = -1;
+
+public:
+ BoxModel() = default;
+ void Reset() override;
+
+ /// Advance the model clock
+ /// @param delta Time to advance in seconds
+ void Advance(double delta) override {*mTime += delta;}
+
+ /// Get the model clock, for Mechanism to pool
+ /// @return Machine time in seconds
+ PooledState<double>& GetClock() {return mTime;}
+
+ void EvaluateAt(double time) override;
+ void KeyDroppedTriggered(double time) override;
+ void SaveState(std::vector<double>& state) override;
+ const double* RestoreState(const double* state) override;
+ void Open(bool open);
+ void SetLidAngle(double angle);
+ double GetLidAngle() const;
+
+ /// The lid angle is a function of the time since it opened
+ /// @return true
+ bool CanEvaluate() const override {return true;}
+};
+
+
+
+#endif //BOXMODEL_H
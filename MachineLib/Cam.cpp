@@ -5,6 +5,7 @@
 
 #include "pch.h"
 #include "Cam.h"
+#include "MachineArena.h"
 
 /// Width of the cam on the screen in pixels
 const double CamWidth = 17;
@@ -21,32 +22,22 @@ const std::wstring KeyImage = L"/key.png";
 /// The key image size
 const int KeyImageSize = 20;
 
-/// The amount the key drops into the hole
-const int KeyDrop = 10;
-
 /// Key start Offset
-int KeyStartOffset = 35;
+const int KeyStartOffset = 35;
 
 /// hole x position offset
 const double HoleOffset = 3;
 /// get the key into the right spot
 const double KeyOffset = 89;
-/// Put the key into the correct y point
-double KeyY = 185;
-/// the key's starting point for reset
-double KeyYStart = 185;
 
 
 
 /// Constructor
 /// @param imagesDir
-Cam::Cam(const std::wstring& imagesDir) : mImagesDir(imagesDir)
+Cam::Cam(const std::wstring& imagesDir) : mImagesDir(imagesDir), mModel(MachineArena::Make<CamModel>())
 {
  mKey.SetImage(imagesDir + KeyImage);
  mKey.Rectangle(-KeyImageSize/2, 0, KeyImageSize, KeyImageSize);
-
- mHoleAngle = mRotation;
-
 }
 
 /**
@@ -55,60 +46,40 @@ Cam::Cam(const std::wstring& imagesDir) : mImagesDir(imagesDir)
  */
 void Cam::Draw(std::shared_ptr<wxGraphicsContext> graphics)
 {
+ double rotation = mModel->GetRotation();
+
  graphics->PushState();
 
  // Translate to the cam's position
  graphics->Translate(GetPosition().x - 5, GetPosition().y - 5);
 
- // Key bottom position
- double keyBottomY = -(KeyStartOffset - KeyDrop);
-
-
- mKey.DrawPolygon(graphics, GetPosition().x + KeyOffset, GetPosition().y - KeyStartOffset + KeyY);
+ mKey.DrawPolygon(graphics, GetPosition().x + KeyOffset, GetPosition().y - KeyStartOffset + mModel->GetKeyY());
 
  // Draw the cam
  mCam.SetSize(CamDiameter, CamWidth);
- mCam.Draw(graphics, 0, 0, mRotation / 5);
+ mCam.Draw(graphics, 0, 0, rotation / 5);
 
  // Calculate the position and size of the hole (dot)
  double dotX = 0;  // Centered horizontally
  double maxDisplacement = CamDiameter / 2; // Max vertical displacement
- double dotY = maxDisplacement * std::cos(mRotation); // Oscillates based on rotation
+ double dotY = maxDisplacement * std::cos(rotation); // Oscillates based on rotation
 
 
 
 
- // Check if the ellipse is below the key's bottom
- if (dotY < keyBottomY)
- {
-  mMaxNotReached = false;
-  if (KeyY == KeyYStart)
-  {
-   KeyY += 10;
-
-   // Notify all listeners
-   for (auto listener : mKeyDropListeners)
-   {
-    listener->KeyDroppedTriggered(KeyY);
-   }
-  }
-  graphics->PopState();
-  return; // Stop drawing the ellipse
- }
-
-
  // Calculate normalizedY to control the dynamic height of the ellipse
  double normalizedY = dotY / maxDisplacement; // Range: -1 (top) to 1 (bottom)
- mHoleAngle = 1.0 - std::abs(normalizedY);
+ double holeAngle = 1.0 - std::abs(normalizedY);
 
 
- // Adjust the hole size based on the mHoleAngle
- double ellipseHeight = HoleSize * mHoleAngle; // Dynamic height
+ // Adjust the hole size based on the hole angle
+ double ellipseHeight = HoleSize * holeAngle; // Dynamic height
  double ellipseWidth = HoleSize;
 
 
- // Draw the hole (ellipse)
- if (mMaxNotReached)
+ // Draw the hole (ellipse) until the key drops into it. The
+ // drop itself is found when the machine advances.
+ if (!mModel->IsKeyDropped() && !mModel->IsHoleUnderKey())
  {
   graphics->SetBrush(wxBrush(wxColour(0, 0, 0))); // Black color for the hole
   graphics->DrawEllipse(dotX - ellipseWidth / 2 + HoleOffset + 5,
@@ -123,47 +94,48 @@ void Cam::Draw(std::shared_ptr<wxGraphicsContext> graphics)
 }
 
 /**
- * Reset the cam back to its original position
+ * Set the hole angle of the cam
+ * @param angle
  */
-void Cam::Reset()
+void Cam::SetHoleAngle(double angle)
 {
- mRotation = mStartingAngle;
- mHoleAngle = mStartingAngle;
- KeyY = KeyYStart;
- mMaxNotReached = true;
+ mModel->SetHoleAngle(angle);
 }
 
 /**
- * Set the rotation
- * @param rotation
+ * Get the area the cam and its key draw in
+ * @return Bounding box
  */
-void Cam::SetRotation(double rotation)
+wxRect Cam::GetBoundingBox()
 {
- mRotation = rotation;
- mRotationSource.Rotate(mRotation);
+ // Everything is drawn relative to the cam position, and the
+ // key is then placed relative to the position a second time
+ auto position = GetPosition();
+ double x = position.x - 5;
+ double y = position.y - 5;
+ auto box = BoundingBox(x, y - CamDiameter / 2, x + CamWidth, y + CamDiameter / 2);
+
+ double keyX = x + position.x + KeyOffset;
+ double keyY = y + position.y - KeyStartOffset + mModel->GetKeyY();
+ box.Union(BoundingBox(keyX - KeyImageSize / 2, keyY - KeyImageSize,
+         keyX + KeyImageSize / 2, keyY));
+ return box;
 }
 
-
 /**
- * Update
- * @param time
+ * Get the values the cam's drawing depends on
+ * @param appearance Vector to append the values to
  */
-void Cam::Update(double time)
+void Cam::GetAppearance(std::vector<double>& appearance)
 {
- Component::Update(time);
+ appearance.push_back(mModel->GetRotation());
+ appearance.push_back(mModel->GetKeyY());
 }
 
 /**
- * Set the hole angle of the cam
- * @param angle
+ * Decode the key image
  */
-void Cam::SetHoleAngle(double angle)
+void Cam::LoadImages()
 {
- mStartingAngle = angle;
- mHoleAngle = angle;
- mRotation = angle;
-
+ mKey.PreloadImage();
 }
-
-
-
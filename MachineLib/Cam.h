@@ -9,55 +9,51 @@
 #define CAM_H
 #include "Component.h"
 #include "Cylinder.h"
-#include "IRotationSink.h"
-#include "RotationSource.h"
 #include "Polygon.h"
-#include "IKeyDropListener.h"
+#include "CamModel.h"
 
-/// Creates and Draws the Cam that is derived form Component and IRotation sink
-class Cam : public Component, public IRotationSink{
+/// Creates and Draws the Cam and the key that drops into it
+class Cam : public Component{
 private:
  /// the cylinder for cam
  cse335::Cylinder mCam;
  /// Image Directory
  std::wstring mImagesDir;
-
- ///starting hole angle
- double mHoleAngle;
-
- /// Rotation of the cam
- double mRotation;
  /// polygon of the key image
  cse335::Polygon mKey;
- /// sink up the rotation
- RotationSource mRotationSource;
- ///teh starting angle for the ellipse
- double mStartingAngle;
- /// flag to see if the top of the cam was reached for the ellipse
- bool mMaxNotReached = true;
- /// Pointer to the interface for the key drop
- std::vector<IKeyDropListener*> mKeyDropListeners;
+ /// Simulation of the cam and key
+ std::shared_ptr<CamModel> mModel;
 
 public:
  Cam(const std::wstring &imagesDir);
  void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
- void Reset() override;
- void SetRotation(double rotation) override;
- void Update(double time) override;
  void SetHoleAngle(double angle);
 
+ /// Get the simulation model
+ /// @return CamModel
+ std::shared_ptr<ComponentModel> GetModel() override {return mModel;}
+
+ /// Get the name of the kind of component
+ /// @return Name
+ std::wstring GetName() override {return L"Cam";}
+
+ wxRect GetBoundingBox() override;
+ void GetAppearance(std::vector<double>& appearance) override;
+ void LoadImages() override;
+
+ /// Get the rotation sink that turns this cam
+ /// @return IRotationSink
+ std::shared_ptr<IRotationSink> GetSink() {return mModel;}
+
  /**
   * Get the rotation source
   * @return RotationSource*
   */
- RotationSource* GetSource() {return &mRotationSource;}
+ RotationSource* GetSource() {return mModel->GetSource();}
 
  /// Add the components to the key lister list
  /// @param listener add the component that has to listen
- void AddKeyDrop(IKeyDropListener* listener)
- {
-  mKeyDropListeners.push_back(listener);
- }
+ void AddKeyDrop(IKeyDropListener* listener) {mModel->AddKeyDrop(listener);}
 
 };
 
@@ -0,0 +1,204 @@
+/**
+ * @file CamModel.cpp
+ * @author Thomas Conley
+ */
+
+#include "CamModel.h"
+#include <cmath>
+
+/// The key's starting point for reset
+const double KeyYStart = 185;
+
+/// The amount the key drops into the hole
+const double KeyDrop = 10;
+
+/// The hole is under the key once the cosine of the cam rotation
+/// is below this. The key bottom is 25 pixels above the center of
+/// a cam with a radius of 30 pixels.
+const double KeyDropCosine = -25.0 / 30.0;
+
+/// Two pi
+const double TwoPi = 6.28318530717958647692;
+
+/**
+ * Reset the cam back to its original position
+ */
+void CamModel::Reset()
+{
+ mRotation = mStartingAngle;
+ mStepRotation = mStartingAngle;
+ mTime = 0;
+ mKeyDropped = false;
+ mKeyDropTime = 0;
+}
+
+/**
+ * Advance the cam clock and drop the key if the hole reached it
+ * during the step. The cranks have already turned the cam to its
+ * rotation at the end of the step, and it turned at a constant
+ * rate across it, so the listeners are told the time within the
+ * step that the hole reached the key.
+ * @param delta Time to advance in seconds
+ */
+void CamModel::Advance(double delta)
+{
+ double end = mTime + delta;
+ if (!mKeyDropped)
+ {
+  // Time through the step as a fraction of it
+  double fraction = FindDrop(mStepRotation, mRotation - mStepRotation);
+  if (fraction >= 0 && fraction <= 1)
+  {
+   mTime += delta * fraction;
+   DropKey();
+  }
+ }
+
+ mTime = end;
+ mStepRotation = mRotation;
+}
+
+/**
+ * Find when the hole first reaches the key as the cam turns
+ * @param rotation Rotation to start from
+ * @param rate Change in rotation per unit of time
+ * @return Time until the hole is under the key, or -1 if it never is
+ */
+double CamModel::FindDrop(double rotation, double rate)
+{
+ if (std::cos(rotation) < KeyDropCosine)
+ {
+  return 0;
+ }
+
+ // The hole is under the key between these angles in every turn
+ double enter = std::acos(KeyDropCosine);
+ double leave = TwoPi - enter;
+ if (rate > 0)
+ {
+  double angle = enter + TwoPi * std::ceil((rotation - enter) / TwoPi);
+  return (angle - rotation) / rate;
+ }
+
+ if (rate < 0)
+ {
+  double angle = leave + TwoPi * std::floor((rotation - leave) / TwoPi);
+  return (angle - rotation) / rate;
+ }
+
+ return -1;
+}
+
+/**
+ * Set the cam clock for a machine time. The rotation comes from the source.
+ * @param time Machine time in seconds
+ */
+void CamModel::EvaluateAt(double time)
+{
+ mTime = time;
+}
+
+/**
+ * Determine whether the key has dropped by a machine time. The drop
+ * time comes from the schedule Mechanism solved for, and the listeners
+ * set themselves from how long ago it was.
+ * @param time Machine time in seconds
+ */
+void CamModel::EvaluateEvents(double time)
+{
+ mKeyDropped = false;
+ if (mDropTime >= 0 && time >= mDropTime)
+ {
+  mTime = mDropTime;
+  DropKey();
+ }
+
+ mTime = time;
+ mStepRotation = mRotation;
+}
+
+/**
+ * Set the rotation
+ * @param rotation
+ */
+void CamModel::SetRotation(double rotation)
+{
+ mRotation = rotation;
+ mRotationSource.Rotate(mRotation);
+}
+
+/**
+ * Set the hole angle of the cam
+ * @param angle
+ */
+void CamModel::SetHoleAngle(double angle)
+{
+ mStartingAngle = angle;
+ mRotation = angle;
+ mStepRotation = angle;
+}
+
+/**
+ * Is the hole in the cam under the key?
+ * @return true if the key can drop
+ */
+bool CamModel::IsHoleUnderKey() const
+{
+ return std::cos(mRotation) < KeyDropCosine;
+}
+
+/**
+ * Drop the key into the hole and tell the listeners.
+ * Only the first drop after a reset has any effect.
+ */
+void CamModel::DropKey()
+{
+ if (mKeyDropped)
+ {
+  return;
+ }
+
+ mKeyDropped = true;
+ mKeyDropTime = mTime;
+
+ for (auto listener : mKeyDropListeners)
+ {
+  listener->KeyDroppedTriggered(mKeyDropTime);
+ }
+}
+
+/**
+ * Get the key position
+ * @return Key Y position in pixels
+ */
+double CamModel::GetKeyY() const
+{
+ return mKeyDropped ? KeyYStart + KeyDrop : KeyYStart;
+}
+
+/**
+ * Save the cam rotation and key state to a checkpoint
+ * @param state
+ */
+void CamModel::SaveState(std::vector<double>& state)
+{
+ state.push_back(mRotation);
+ state.push_back(mTime);
+ state.push_back(mKeyDropped);
+ state.push_back(mKeyDropTime);
+}
+
+/**
+ * Restore the cam rotation and key state from a checkpoint
+ * @param state
+ * @return Pointer past the values this cam saved
+ */
+const double* CamModel::RestoreState(const double* state)
+{
+ mRotation = *state++;
+ mTime = *state++;
+ mKeyDropped = *state++ != 0;
+ mKeyDropTime = *state++;
+ mStepRotation = mRotation;
+ return state;
+}
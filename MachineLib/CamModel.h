@@ -0,0 +1,96 @@
+/**
+ * @file CamModel.h
+ * @author Thomas Conley
+ *
+ *
+ */
+ 
+#ifndef CAMMODEL_H
+#define CAMMODEL_H
+#include "ComponentModel.h"
+#include "IKeyDropListener.h"
+#include "IRotationSink.h"
+#include "RotationSource.h"
+#include "MachineArena.h"
+
+/// Simulation of the cam and the key that drops into its hole
+class CamModel final : public ComponentModel, public IRotationSink {
+private:
+ /// Rotation of the cam
+ double mRotation = 0;
+
+ /// Starting angle of the hole
+ double mStartingAngle = 0;
+
+ /// Machine time in seconds
+ double mTime = 0;
+
+ /// Rotation at the start of the step being advanced
+ double mStepRotation = 0;
+
+ /// Scheduled machine time of the key drop, negative if it never drops
+ double mDropTime = -1;
+
+ /// Has the key dropped into the hole?
+ bool mKeyDropped = false;
+
+ /// Machine time the key dropped
+ double mKeyDropTime = 0;
+
+ /// Rotation source for whatever this cam drives
+ RotationSource mRotationSource;
+
+ /// Listeners told when the key drops
+ MachineArena::Vector<IKeyDropListener*> mKeyDropListeners;
+
+public:
+ CamModel() = default;
+ void Reset() override;
+ void Advance(double delta) override;
+ static double FindDrop(double rotation, double rate);
+ void EvaluateAt(double time) override;
+ void EvaluateEvents(double time) override;
+ void SetRotation(double rotation) override;
+ void SaveState(std::vector<double>& state) override;
+ const double* RestoreState(const double* state) override;
+ void SetHoleAngle(double angle);
+ bool IsHoleUnderKey() const;
+ void DropKey();
+ double GetKeyY() const;
+
+ /// The cam follows its source and the key drop can be solved for directly
+ /// @return true
+ bool CanEvaluate() const override {return true;}
+
+ /// Add a listener for the key drop
+ /// @param listener Object told when the key drops
+ void AddKeyDrop(IKeyDropListener* listener) {mKeyDropListeners.push_back(listener);}
+
+ /// Get the rotation
+ /// @return Rotation of the cam
+ double GetRotation() const {return mRotation;}
+
+ /// Has the key dropped?
+ /// @return true once the key is in the hole
+ bool IsKeyDropped() const {return mKeyDropped;}
+
+ /// Get the starting angle of the hole
+ /// @return Rotation before the cam is first turned
+ double GetStartingAngle() const {return mStartingAngle;}
+
+ /// Set when the schedule says the key drops, for EvaluateEvents
+ /// @param time Machine time in seconds, negative if it never drops
+ void SetDropTime(double time) {mDropTime = time;}
+
+ /// Get the time the key dropped
+ /// @return Machine time in seconds, only valid if IsKeyDropped
+ double GetKeyDropTime() const {return mKeyDropTime;}
+
+ /// Get the rotation source
+ /// @return RotationSource
+ RotationSource* GetSource() override {return &mRotationSource;}
+};
+
+
+
+#endif //CAMMODEL_H
@@ -5,5 +5,68 @@
 
 #include "pch.h"
 #include "Component.h"
+#include <algorithm>
+#include <cmath>
 
 
+/**
+ * Has the component's appearance changed since it was last drawn?
+ * @return true if it has changed or has never been drawn
+ */
+bool Component::HasChanged()
+{
+ if (!mDrawn)
+ {
+  return true;
+ }
+
+ mAppearance.clear();
+ GetAppearance(mAppearance);
+ return mAppearance != mDrawnAppearance;
+}
+
+/**
+ * Get the area that has to be repainted to show the component
+ * as it is now: where it was last drawn and where it is now.
+ * @return Dirty rectangle, empty if the component has not changed
+ */
+wxRect Component::GetDirtyRect()
+{
+ if (!HasChanged())
+ {
+  return wxRect();
+ }
+
+ wxRect dirty = mDrawnBounds;
+ dirty.Union(GetBoundingBox());
+ return dirty;
+}
+
+/**
+ * Record the appearance and bounds of the component as just drawn
+ */
+void Component::MarkDrawn()
+{
+ mDrawnAppearance.clear();
+ GetAppearance(mDrawnAppearance);
+ mDrawnBounds = GetBoundingBox();
+ mDrawn = true;
+}
+
+/**
+ * Make a bounding box that covers an area, with a pixel to
+ * spare on each side for antialiasing and pen widths.
+ * @param left Left edge
+ * @param top Top edge
+ * @param right Right edge
+ * @param bottom Bottom edge
+ * @return Bounding box in whole pixels
+ */
+wxRect Component::BoundingBox(double left, double top, double right, double bottom)
+{
+ int x = (int)std::floor(std::min(left, right)) - 1;
+ int y = (int)std::floor(std::min(top, bottom)) - 1;
+ int x2 = (int)std::ceil(std::max(left, right)) + 1;
+ int y2 = (int)std::ceil(std::max(top, bottom)) + 1;
+ return wxRect(x, y, x2 - x, y2 - y);
+}
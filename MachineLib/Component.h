@@ -9,15 +9,39 @@
 #define COMPONENT_H
 #include <wx/dc.h>
 #include <wx/gdicmn.h>
+#include <memory>
+#include <string>
+#include <vector>
 
-class RotationSource;
+class ComponentModel;
 
-///Component class that holds all component functions
+/**
+ * Component class that holds all component functions.
+ *
+ * A component is the view of one part of the machine. Anything
+ * that changes as the machine runs lives in its ComponentModel,
+ * which the component draws from.
+ */
 class Component {
 private:
  /// Component position
  wxPoint mPosition;
 
+ /// Appearance when the component was last drawn
+ std::vector<double> mDrawnAppearance;
+
+ /// Appearance now, kept so checking for changes reuses its storage
+ std::vector<double> mAppearance;
+
+ /// Bounding box when the component was last drawn
+ wxRect mDrawnBounds;
+
+ /// Has the component been drawn yet?
+ bool mDrawn = false;
+
+protected:
+ static wxRect BoundingBox(double left, double top, double right, double bottom);
+
 public:
  Component() = default;
  virtual ~Component() = default;
@@ -40,42 +64,46 @@ public:
  virtual wxPoint GetPosition() {return mPosition;}
 
  /**
-  * Reset the component
+  * Draw the purple outline on the box
+  * @param graphics
   */
- virtual void Reset() = 0;
-
- /// Set the Frame
- virtual void SetFrame(){};
+ virtual void DrawForeground(std::shared_ptr<wxGraphicsContext> graphics) {};
 
  /**
-  * Set the time
-  * @param time
+  * Get the simulation model that animates this component
+  * @return Model or nullptr if the component never changes
   */
- virtual void SetTime(double time) {};
+ virtual std::shared_ptr<ComponentModel> GetModel() {return nullptr;}
 
  /**
-  * Advance the time
-  * @param delta
+  * Get the name of the kind of component, for reports
+  * @return Name
   */
- virtual void Advance(double delta) {}
+ virtual std::wstring GetName() {return L"Component";}
 
  /**
-  * Draw the purple outline on the box
-  * @param graphics
+  * Get the area the component draws in, in the same
+  * coordinates it draws in
+  * @return Bounding box, empty if the component draws nothing
   */
- virtual void DrawForeground(std::shared_ptr<wxGraphicsContext> graphics) {};
+ virtual wxRect GetBoundingBox() {return wxRect();}
 
  /**
-  * update the time
-  * @param time
+  * Get the values the component's drawing depends on. If
+  * they have not changed, the component draws the same.
+  * @param appearance Vector to append the values to
   */
- virtual void Update(double time) {};
-
- /// Set the Rotation
- ///@param rotation
- virtual void SetRotation(double rotation) {};
+ virtual void GetAppearance(std::vector<double>& appearance) {}
 
+ /**
+  * Decode the images the component draws with, so the first
+  * draw does not have to
+  */
+ virtual void LoadImages() {}
 
+ bool HasChanged();
+ wxRect GetDirtyRect();
+ void MarkDrawn();
 };
 
 
@@ -0,0 +1,6 @@
+/**
+ * @file ComponentModel.cpp
+ * @author Thomas Conley
+ */
+
+#include "ComponentModel.h"
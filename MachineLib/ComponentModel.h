@@ -0,0 +1,83 @@
+/**
+ * @file ComponentModel.h
+ * @author Thomas Conley
+ *
+ * Base class for the simulation state of a component.
+ */
+ 
+#ifndef COMPONENTMODEL_H
+#define COMPONENTMODEL_H
+
+#include <vector>
+
+/**
+ * Base class for the simulation state of a component.
+ *
+ * Models hold everything that changes as the machine runs and
+ * are stepped by Mechanism. They must not use wxWidgets so a
+ * machine can be simulated without a display.
+ */
+class ComponentModel {
+public:
+ ComponentModel() = default;
+ virtual ~ComponentModel() = default;
+
+ /// Copy constructor (disabled)
+ ComponentModel(const ComponentModel &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const ComponentModel &) = delete;
+
+ /**
+  * Prepare the model to run once the machine has been built
+  */
+ virtual void Compile() {}
+
+ /**
+  * Reset the model to its state at time zero
+  */
+ virtual void Reset() = 0;
+
+ /**
+  * Advance the model in time
+  * @param delta Time to advance in seconds
+  */
+ virtual void Advance(double delta) {}
+
+ /**
+  * Can this model compute its state directly from the machine time?
+  * @return true if EvaluateAt is supported
+  */
+ virtual bool CanEvaluate() const {return false;}
+
+ /**
+  * Set the state directly from the machine time instead of stepping
+  * to it. Rotation sinks get their rotation from their source.
+  * @param time Machine time in seconds
+  */
+ virtual void EvaluateAt(double time) {}
+
+ /**
+  * Determine which events have happened by the machine time. This is
+  * called after every model has been evaluated, so rotations are known.
+  * @param time Machine time in seconds
+  */
+ virtual void EvaluateEvents(double time) {}
+
+ /**
+  * Append the animation state of the model to a checkpoint
+  * @param state Checkpoint state to append to
+  */
+ virtual void SaveState(std::vector<double>& state) {}
+
+ /**
+  * Restore the animation state written by SaveState
+  * @param state Pointer to the first value this model saved
+  * @return Pointer just past the last value this model saved
+  */
+ virtual const double* RestoreState(const double* state) {return state;}
+};
+
+
+
+#endif //COMPONENTMODEL_H
@@ -4,7 +4,7 @@
  */
 #include "pch.h"
 #include "Crank.h"
-#include "RotationSource.h"
+#include "MachineArena.h"
 
 /// The width of the crank on the screen in pixels
 const int CrankWidth = 10;
@@ -32,7 +32,7 @@ const wxColour CrankHandleLineColor = wxColour(100, 100, 100);
 
 
 /// Constructor
-Crank::Crank()
+Crank::Crank() : mModel(MachineArena::Make<CrankModel>())
 {
  mHandle.SetSize(HandleDiameter, HandleLength);
  mHandle.SetColour(CrankColor);
@@ -47,9 +47,9 @@ void Crank::Draw(std::shared_ptr<wxGraphicsContext> graphics)
 {
 
  // Calculate the rotation angle in radians
- mAngle = mRotation * 2 * M_PI;
+ double angle = mModel->GetRotation() * 2 * M_PI;
 
- double handleY = GetPosition().y + cos(mAngle) * CrankLength; // Handle's Y position
+ double handleY = GetPosition().y + cos(angle) * CrankLength; // Handle's Y position
 
  // Draw the handle (cylinder) first
  graphics->PushState();
@@ -60,7 +60,7 @@ void Crank::Draw(std::shared_ptr<wxGraphicsContext> graphics)
 
  // Draw at the calculated position
  //mHandle.Draw(graphics, handleX - HandleDiameter / 2 - 5, handleY + 35, mAngle);
- mHandle.Draw(graphics, GetPosition().x - 15, handleY - 17, mAngle);
+ mHandle.Draw(graphics, GetPosition().x - 15, handleY - 17, angle);
 
  graphics->PopState(); // Restore state after drawing the handle
 
@@ -68,14 +68,14 @@ void Crank::Draw(std::shared_ptr<wxGraphicsContext> graphics)
  graphics->PushState();
 
  // Calculate the height of the crank arm
- double crankHeight = (CrankLength * cos(mAngle)) * 1.2;
+ double crankHeight = (CrankLength * cos(angle)) * 1.2;
 
  crankHeight = std::max(crankHeight, 20.0);
 
 
  // Draw the crank arm
  graphics->SetBrush(wxBrush(CrankColor));
- graphics->DrawRectangle(GetPosition().x + HandleStartX,  GetPosition().y - 16, CrankWidth,(CrankLength * cos(mAngle)) * 1.2);
+ graphics->DrawRectangle(GetPosition().x + HandleStartX,  GetPosition().y - 16, CrankWidth,(CrankLength * cos(angle)) * 1.2);
  graphics->DrawRectangle(GetPosition().x + HandleStartX,  GetPosition().y - 17, CrankWidth,crankHeight); //(CrankLength * cos(mAngle)) * 1.2);
 
 
@@ -84,52 +84,33 @@ void Crank::Draw(std::shared_ptr<wxGraphicsContext> graphics)
 }
 
 /**
- * Reset the crank into its original position
- */
-void Crank::Reset()
-{
- mRotation = 0.0;
- mTime = 0.0;
-}
-
-/**
- * Rotate the handle with the rotation source
- * @param rotation
+ * Set the speed
+ * @param speed Speed in turns per second
  */
-void Crank::Rotate(double rotation)
+void Crank::SetSpeed(double speed)
 {
- mRotationSource.Rotate(rotation);
+ mModel->SetSpeed(speed);
 }
 
 /**
- * Update the animation
- * @param delta
+ * Get the area the crank draws in, anywhere in its turn
+ * @return Bounding box
  */
-void Crank::Advance(double delta)
+wxRect Crank::GetBoundingBox()
 {
- double time = delta - mTime;
- mTime = delta;
-
- // Update the rotation in turns
- mRotation += delta * mSpeed;
-
- // Keep mRotation in [0, 1) to simplify calculations
- mRotationSource.Rotate(mRotation);
+ // The arm reaches 1.2 crank lengths up or down and the handle
+ // starts 15 pixels left of the crank
+ auto position = GetPosition();
+ return BoundingBox(position.x - 15, position.y - CrankLength * 1.2 - 16,
+         position.x - 15 + HandleLength, position.y + CrankLength * 1.2 - 16);
 }
 
 /**
- * Set the speed
- * @param speed
+ * Get the values the crank's drawing depends on
+ * @param appearance Vector to append the values to
  */
-void Crank::SetSpeed(double speed)
+void Crank::GetAppearance(std::vector<double>& appearance)
 {
- mSpeed = speed/2;
+ appearance.push_back(mModel->GetRotation());
 }
 
-
-
-
-
-
-
-
@@ -9,7 +9,7 @@
 #define CRANK_H
 #include "Component.h"
 #include "Cylinder.h"
-#include "RotationSource.h"
+#include "CrankModel.h"
 
 /// Crank Class that turns the crank and draws it
 class Crank : public Component{
@@ -17,35 +17,28 @@ private:
  /// Handle Cylinder
  cse335::Cylinder mHandle;
 
- /// Rotation source
- RotationSource mRotationSource;
-
- /// Angle of start
- double mAngle;
-
- /// Rotation
- double mRotation = 0;
-
- /// rotation speed
- double mSpeed;
-
- /// time of animation
- double mTime = 0;
-
-
+ /// Simulation of the crank
+ std::shared_ptr<CrankModel> mModel;
 
 public:
  Crank();
  void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
- void Reset() override;
- void Rotate(double rotation);
- void Advance(double delta) override;
  void SetSpeed(double speed);
 
+ /// Get the simulation model
+ /// @return CrankModel
+ std::shared_ptr<ComponentModel> GetModel() override {return mModel;}
+
+ /// Get the name of the kind of component
+ /// @return Name
+ std::wstring GetName() override {return L"Crank";}
+
+ wxRect GetBoundingBox() override;
+ void GetAppearance(std::vector<double>& appearance) override;
 
  /// Get the rotation source
  /// @return RotationSource
- RotationSource* GetSource() {return &mRotationSource;}
+ RotationSource* GetSource() {return mModel->GetSource();}
 
 };
 
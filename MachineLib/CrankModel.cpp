@@ -0,0 +1,78 @@
+/**
+ * @file CrankModel.cpp
+ * @author Thomas Conley
+ */
+
+#include "CrankModel.h"
+
+/**
+ * Flatten everything the crank drives into a rotation graph
+ */
+void CrankModel::Compile()
+{
+ mRotationGraph.Compile(&mRotationSource);
+}
+
+/**
+ * Pass the crank rotation to everything it drives
+ */
+void CrankModel::Turn()
+{
+ if (mRotationGraph.IsCompiled())
+ {
+  mRotationGraph.Rotate(mState->mRotation);
+ }
+ else
+ {
+  mRotationSource.Rotate(mState->mRotation);
+ }
+}
+
+/**
+ * Reset the crank into its original position
+ */
+void CrankModel::Reset()
+{
+ mState->mRotation = 0.0;
+}
+
+/**
+ * Turn the crank and everything it drives
+ * @param delta Time to advance in seconds
+ */
+void CrankModel::Advance(double delta)
+{
+ mState->mRotation += delta * mState->mSpeed;
+ Turn();
+}
+
+/**
+ * Set the crank rotation for a machine time and turn
+ * everything it drives
+ * @param time Machine time in seconds
+ */
+void CrankModel::EvaluateAt(double time)
+{
+ mState->mRotation = time * mState->mSpeed;
+ Turn();
+}
+
+/**
+ * Save the crank rotation to a checkpoint
+ * @param state
+ */
+void CrankModel::SaveState(std::vector<double>& state)
+{
+ state.push_back(mState->mRotation);
+}
+
+/**
+ * Restore the crank rotation from a checkpoint
+ * @param state
+ * @return Pointer past the values this crank saved
+ */
+const double* CrankModel::RestoreState(const double* state)
+{
+ mState->mRotation = *state++;
+ return state;
+}
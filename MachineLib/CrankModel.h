@@ -0,0 +1,78 @@
+/**
+ * @file CrankModel.h
+ * @author Thomas Conley
+ *
+ *
+ */
+ 
+#ifndef CRANKMODEL_H
+#define CRANKMODEL_H
+#include "ComponentModel.h"
+#include "RotationSource.h"
+#include "RotationGraph.h"
+#include "PooledState.h"
+
+/// Simulation of the crank, which drives the machine at a constant speed
+class CrankModel final : public ComponentModel {
+public:
+ /// What changes as the crank runs, which Mechanism keeps in a pool
+ struct State {
+  /// Rotation in turns
+  double mRotation = 0;
+
+  /// Rotation speed in turns per second
+  double mSpeed = 0;
+ };
+
+private:
+ /// Rotation source the crank drives
+ RotationSource mRotationSource;
+
+ /// Flattened network of everything the crank drives
+ RotationGraph mRotationGraph;
+
+ /// Rotation and speed
+ PooledState<State> mState;
+
+public:
+ CrankModel() = default;
+ void Turn();
+ void Compile() override;
+ void Reset() override;
+ void Advance(double delta) override;
+ void EvaluateAt(double time) override;
+ void SaveState(std::vector<double>& state) override;
+ const double* RestoreState(const double* state) override;
+
+ /// The crank turns at a constant speed, so it can be evaluated directly
+ /// @return true
+ bool CanEvaluate() const override {return true;}
+
+ /// Set the speed
+ /// @param speed Speed in turns per second
+ void SetSpeed(double speed) {mState->mSpeed = speed;}
+
+ /// Get the speed
+ /// @return Speed in turns per second
+ double GetSpeed() const {return mState->mSpeed;}
+
+ /// Get the rotation
+ /// @return Rotation in turns
+ double GetRotation() const {return mState->mRotation;}
+
+ /// Get the rotation source
+ /// @return RotationSource
+ RotationSource* GetSource() {return &mRotationSource;}
+
+ /// Get the flattened network the crank drives
+ /// @return RotationGraph, empty until Compile
+ const RotationGraph& GetRotationGraph() const {return mRotationGraph;}
+
+ /// Get the rotation and speed, for Mechanism to pool
+ /// @return State
+ PooledState<State>& GetState() {return mState;}
+};
+
+
+
+#endif //CRANKMODEL_H
@@ -23,47 +23,88 @@ namespace cse335
  */
 void Cylinder::Draw(const std::shared_ptr<wxGraphicsContext> &graphics, double x, double y, double rotation)
 {
-    wxBrush cylinderBrush(mColor);
-    graphics->SetBrush(cylinderBrush);
-    if(mBorderColor != wxTRANSPARENT)
+    if(!mStyleValid)
     {
-        wxPen cylinderPen(mBorderColor);
-        graphics->SetPen(cylinderPen);
+        UpdateStyle();
     }
-    else
+
+    // Setting a wxBrush or wxPen makes a graphics object every time
+    if(mGraphicsRenderer != graphics->GetRenderer())
     {
-        graphics->SetPen(*wxTRANSPARENT_PEN);
+        mGraphicsBrush = graphics->CreateBrush(mBrush);
+        mGraphicsBorderPen = graphics->CreatePen(mBorderPen);
+        mGraphicsLinePen = graphics->CreatePen(mLinePen);
+        mGraphicsRenderer = graphics->GetRenderer();
     }
 
+    graphics->SetBrush(mGraphicsBrush);
+    graphics->SetPen(mGraphicsBorderPen);
+
     // Draw the rod
     graphics->DrawRectangle(x, y - mDiameter / 2.0, mLength, mDiameter);
 
-    // The current cylinder rotation angle including the offset in radians
-    double angle = (rotation + mOffset) * M_PI * 2.0;    // In radians
-
     if(mNumLines > 0)
     {
-        // The lines we'll draw
-        wxPen linePen(mLineColor, mLineWidth);
-        linePen.SetCap(wxCAP_BUTT);
-        graphics->SetPen(linePen);
+        if(mLineSin.size() != (size_t)mNumLines)
+        {
+            // The lines are evenly spaced around the cylinder
+            mLineSin.resize(mNumLines);
+            mLineCos.resize(mNumLines);
+            for(int i = 0; i < mNumLines; i++)
+            {
+                mLineSin[i] = sin(M_PI * 2 * i / mNumLines);
+                mLineCos[i] = cos(M_PI * 2 * i / mNumLines);
+            }
+        }
+
+        // The current cylinder rotation angle including the offset in radians
+        double angle = (rotation + mOffset) * M_PI * 2.0;    // In radians
+        double s0 = sin(angle);
+        double c0 = cos(angle);
 
+        // All of the visible lines are stroked as one path
+        auto path = graphics->CreatePath();
         for(int i = 0; i < mNumLines; i++)
         {
-            double s = sin(angle);
-            double c = cos(angle);
+            // Angle of line i is the first line's angle plus its spacing
+            double s = s0 * mLineCos[i] + c0 * mLineSin[i];
+            double c = c0 * mLineCos[i] - s0 * mLineSin[i];
 
             if(c > 0)       // Test if on the visible side
             {
                 double y2 = y - s * (mDiameter - mLineWidth) / 2;
-                graphics->StrokeLine(x + 1, y2, x + mLength, y2);
+                path.MoveToPoint(x + 1, y2);
+                path.AddLineToPoint(x + mLength, y2);
             }
-
-            angle += M_PI * 2 / mNumLines;
         }
 
+        graphics->SetPen(mGraphicsLinePen);
+        graphics->StrokePath(path);
     }
 
 }
 
+/**
+ * Make the brush and pens for the current colors and line width
+ */
+void Cylinder::UpdateStyle()
+{
+    mBrush = wxBrush(mColor);
+
+    if(mBorderColor != wxTRANSPARENT)
+    {
+        mBorderPen = wxPen(mBorderColor);
+    }
+    else
+    {
+        mBorderPen = *wxTRANSPARENT_PEN;
+    }
+
+    mLinePen = wxPen(mLineColor, mLineWidth);
+    mLinePen.SetCap(wxCAP_BUTT);
+
+    mStyleValid = true;
+    mGraphicsRenderer = nullptr;
+}
+
 }
@@ -11,6 +11,8 @@
 #ifndef _CYLINDER_H
 #define _CYLINDER_H
 
+#include <vector>
+
 namespace cse335
 {
 
@@ -45,6 +47,38 @@ private:
     /// Offset to prevent the lines from all lining up
     double mOffset = 0;
 
+    /// Brush for the cylinder, made when the color changes
+    wxBrush mBrush;
+
+    /// Pen for the border, made when the border color changes
+    wxPen mBorderPen;
+
+    /// Pen for the moving lines, made when the line color or width changes
+    wxPen mLinePen;
+
+    /// Are mBrush, mBorderPen and mLinePen up to date?
+    bool mStyleValid = false;
+
+    /// Renderer the graphics brush and pens were made for
+    wxGraphicsRenderer *mGraphicsRenderer = nullptr;
+
+    /// mBrush made for mGraphicsRenderer
+    wxGraphicsBrush mGraphicsBrush;
+
+    /// mBorderPen made for mGraphicsRenderer
+    wxGraphicsPen mGraphicsBorderPen;
+
+    /// mLinePen made for mGraphicsRenderer
+    wxGraphicsPen mGraphicsLinePen;
+
+    /// Sine of the angle between the first line and each line
+    std::vector<double> mLineSin;
+
+    /// Cosine of the angle between the first line and each line
+    std::vector<double> mLineCos;
+
+    void UpdateStyle();
+
 public:
     /**
      * Constructor
@@ -72,13 +106,27 @@ public:
      * Set the cylinder color
      * @param color Color to draw the cylinder
      */
-    void SetColour(const wxColour &color) { mColor = color; }
+    void SetColour(const wxColour &color)
+    {
+        if(color != mColor)
+        {
+            mColor = color;
+            mStyleValid = false;
+        }
+    }
 
     /**
      * Set the border color drawn around the cylinder
      * @param color Color to set
      */
-    void SetBorderColor(const wxColour &color) {mBorderColor = color;}
+    void SetBorderColor(const wxColour &color)
+    {
+        if(color != mBorderColor)
+        {
+            mBorderColor = color;
+            mStyleValid = false;
+        }
+    }
 
     /**
      * Set lines that appear on the cylinder that show it is turning
@@ -88,8 +136,13 @@ public:
      */
     void SetLines(const wxColour &color, int width, int num)
     {
-        mLineColor = color;
-        mLineWidth = width;
+        if(color != mLineColor || width != mLineWidth)
+        {
+            mLineColor = color;
+            mLineWidth = width;
+            mStyleValid = false;
+        }
+
         mNumLines = num;
     }
 
@@ -104,6 +157,18 @@ public:
      */
     void SetOffset(double offset) {mOffset = offset;}
 
+    /**
+     * Get the cylinder diameter
+     * @return Diameter in pixels
+     */
+    int GetDiameter() const {return mDiameter;}
+
+    /**
+     * Get the cylinder length
+     * @return Length in pixels
+     */
+    int GetLength() const {return mLength;}
+
     void Draw(const std::shared_ptr<wxGraphicsContext> &graphics, double x, double y, double rotation);
 };
 
@@ -0,0 +1,1023 @@
+/**
+ * @file DrawList.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "DrawList.h"
+#include "WxRenderer.h"
+#include <algorithm>
+#include <cmath>
+
+/// Largest distance in pixels a flattened curve may stray from the curve
+const double FlattenTolerance = 0.1;
+
+/// Most line segments a curve is flattened into
+const int MaxCurveSegments = 256;
+
+/// Pixels antialiasing may reach past the edge of a fill
+const double AntialiasMargin = 1;
+
+/**
+ * Determine if a command only changes state that PopState restores
+ * @param type Command type
+ * @return true for transform and clip changes
+ */
+static bool IsRestored(DrawList::Type type)
+{
+ switch (type)
+ {
+ case DrawList::Type::Translate:
+ case DrawList::Type::Scale:
+ case DrawList::Type::Rotate:
+ case DrawList::Type::Concat:
+ case DrawList::Type::SetTransform:
+ case DrawList::Type::Clip:
+ case DrawList::Type::ClipRect:
+ case DrawList::Type::ResetClip:
+  return true;
+
+ default:
+  return false;
+ }
+}
+
+/**
+ * Apply another transform first, then this one
+ * @param matrix Transform to apply first
+ */
+void DrawList::Matrix::Concat(const Matrix& matrix)
+{
+ Matrix result;
+ result.mA = mA * matrix.mA + mC * matrix.mB;
+ result.mB = mB * matrix.mA + mD * matrix.mB;
+ result.mC = mA * matrix.mC + mC * matrix.mD;
+ result.mD = mB * matrix.mC + mD * matrix.mD;
+ result.mTx = mA * matrix.mTx + mC * matrix.mTy + mTx;
+ result.mTy = mB * matrix.mTx + mD * matrix.mTy + mTy;
+ *this = result;
+}
+
+/**
+ * Translate before this transform
+ * @param dx Translation in x
+ * @param dy Translation in y
+ */
+void DrawList::Matrix::Translate(double dx, double dy)
+{
+ Concat({1, 0, 0, 1, dx, dy});
+}
+
+/**
+ * Scale before this transform
+ * @param xScale Scale in x
+ * @param yScale Scale in y
+ */
+void DrawList::Matrix::Scale(double xScale, double yScale)
+{
+ Concat({xScale, 0, 0, yScale, 0, 0});
+}
+
+/**
+ * Rotate before this transform
+ * @param angle Angle in radians, clockwise on the screen
+ */
+void DrawList::Matrix::Rotate(double angle)
+{
+ double c = cos(angle);
+ double s = sin(angle);
+ Concat({c, s, -s, c, 0, 0});
+}
+
+/**
+ * Invert the transform
+ * @return false if the transform cannot be inverted and is unchanged
+ */
+bool DrawList::Matrix::Invert()
+{
+ double det = mA * mD - mB * mC;
+ if (det == 0)
+ {
+  return false;
+ }
+
+ Matrix result;
+ result.mA = mD / det;
+ result.mB = -mB / det;
+ result.mC = -mC / det;
+ result.mD = mA / det;
+ result.mTx = (mC * mTy - mD * mTx) / det;
+ result.mTy = (mB * mTx - mA * mTy) / det;
+ *this = result;
+ return true;
+}
+
+/**
+ * Transform a point
+ * @param x X, replaced by the transformed X
+ * @param y Y, replaced by the transformed Y
+ */
+void DrawList::Matrix::Apply(double& x, double& y) const
+{
+ double tx = mA * x + mC * y + mTx;
+ y = mB * x + mD * y + mTy;
+ x = tx;
+}
+
+/**
+ * Determine if the transform changes nothing
+ * @return true if identity
+ */
+bool DrawList::Matrix::IsIdentity() const
+{
+ return mA == 1 && mB == 0 && mC == 0 && mD == 1 && mTx == 0 && mTy == 0;
+}
+
+/**
+ * Begin a new subpath
+ * @param x X of the start
+ * @param y Y of the start
+ */
+void DrawList::Path::MoveTo(double x, double y)
+{
+ mOps.push_back(Op::Move);
+ mPoints.emplace_back(x, y);
+ mStart = mCurrent = wxPoint2DDouble(x, y);
+ Changed();
+}
+
+/**
+ * Add a line from the current point
+ * @param x X of the end
+ * @param y Y of the end
+ */
+void DrawList::Path::LineTo(double x, double y)
+{
+ if (mOps.empty())
+ {
+  MoveTo(x, y);
+  return;
+ }
+
+ mOps.push_back(Op::Line);
+ mPoints.emplace_back(x, y);
+ mCurrent = wxPoint2DDouble(x, y);
+ Changed();
+}
+
+/**
+ * Add a cubic Bezier curve from the current point
+ * @param cx1 X of the first control point
+ * @param cy1 Y of the first control point
+ * @param cx2 X of the second control point
+ * @param cy2 Y of the second control point
+ * @param x X of the end
+ * @param y Y of the end
+ */
+void DrawList::Path::CurveTo(double cx1, double cy1, double cx2, double cy2, double x, double y)
+{
+ if (mOps.empty())
+ {
+  MoveTo(cx1, cy1);
+ }
+
+ mOps.push_back(Op::Curve);
+ mPoints.emplace_back(cx1, cy1);
+ mPoints.emplace_back(cx2, cy2);
+ mPoints.emplace_back(x, y);
+ mCurrent = wxPoint2DDouble(x, y);
+ Changed();
+}
+
+/**
+ * Close the current subpath with a line back to its start
+ */
+void DrawList::Path::Close()
+{
+ if (mOps.empty() || mOps.back() == Op::Close)
+ {
+  return;
+ }
+
+ mOps.push_back(Op::Close);
+ mCurrent = mStart;
+ Changed();
+}
+
+/**
+ * Add a circular arc as Bezier curves, with a line to its
+ * start from the current point if there is one
+ *
+ * Clockwise is increasing angle, as y points down. A full turn
+ * or more is always drawn clockwise, as the graphics contexts do.
+ *
+ * @param x X of the center
+ * @param y Y of the center
+ * @param r Radius
+ * @param startAngle Start angle in radians
+ * @param endAngle End angle in radians
+ * @param clockwise Direction to go from the start to the end
+ */
+void DrawList::Path::Arc(double x, double y, double r, double startAngle, double endAngle, bool clockwise)
+{
+ double sweep = endAngle - startAngle;
+ if (clockwise || sweep >= 2 * M_PI)
+ {
+  while (sweep < 0)
+  {
+   sweep += 2 * M_PI;
+  }
+ }
+ else
+ {
+  while (sweep > 0)
+  {
+   sweep -= 2 * M_PI;
+  }
+ }
+
+ double startX = x + r * cos(startAngle);
+ double startY = y + r * sin(startAngle);
+ if (mOps.empty())
+ {
+  MoveTo(startX, startY);
+ }
+ else
+ {
+  LineTo(startX, startY);
+ }
+
+ // Each curve covers at most a quarter turn
+ int segments = std::max(1, (int)std::ceil(std::abs(sweep) / (M_PI / 2) - 1e-9));
+ double step = sweep / segments;
+ double k = 4.0 / 3.0 * tan(step / 4);
+ double angle = startAngle;
+ for (int i = 0; i < segments; i++)
+ {
+  double c0 = cos(angle), s0 = sin(angle);
+  angle += step;
+  double c1 = cos(angle), s1 = sin(angle);
+  CurveTo(x + r * (c0 - k * s0), y + r * (s0 + k * c0),
+          x + r * (c1 + k * s1), y + r * (s1 - k * c1),
+          x + r * c1, y + r * s1);
+ }
+}
+
+/**
+ * Add the subpaths of another path to this one
+ * @param path Path to add
+ */
+void DrawList::Path::Append(const Path& path)
+{
+ if (path.mOps.empty())
+ {
+  return;
+ }
+
+ mOps.insert(mOps.end(), path.mOps.begin(), path.mOps.end());
+ mPoints.insert(mPoints.end(), path.mPoints.begin(), path.mPoints.end());
+ mStart = path.mStart;
+ mCurrent = path.mCurrent;
+ Changed();
+}
+
+/**
+ * Transform every point of the path
+ * @param matrix Transform to apply
+ */
+void DrawList::Path::Transform(const Matrix& matrix)
+{
+ for (auto& point : mPoints)
+ {
+  matrix.Apply(point.m_x, point.m_y);
+ }
+
+ matrix.Apply(mStart.m_x, mStart.m_y);
+ matrix.Apply(mCurrent.m_x, mCurrent.m_y);
+ Changed();
+}
+
+/**
+ * Get the current point
+ * @param x Receives X of the current point
+ * @param y Receives Y of the current point
+ * @return false if the path is empty and there is no current point
+ */
+bool DrawList::Path::GetCurrentPoint(double* x, double* y) const
+{
+ *x = mCurrent.m_x;
+ *y = mCurrent.m_y;
+ return !mOps.empty();
+}
+
+/**
+ * Get a box that holds the whole path, control points included
+ * @param left Receives the left edge
+ * @param top Receives the top edge
+ * @param right Receives the right edge
+ * @param bottom Receives the bottom edge
+ * @return false if the path is empty
+ */
+bool DrawList::Path::GetBounds(double* left, double* top, double* right, double* bottom) const
+{
+ if (mPoints.empty())
+ {
+  *left = *top = *right = *bottom = 0;
+  return false;
+ }
+
+ *left = *right = mPoints[0].m_x;
+ *top = *bottom = mPoints[0].m_y;
+ for (auto& point : mPoints)
+ {
+  *left = std::min(*left, point.m_x);
+  *right = std::max(*right, point.m_x);
+  *top = std::min(*top, point.m_y);
+  *bottom = std::max(*bottom, point.m_y);
+ }
+
+ return true;
+}
+
+/**
+ * Transform the path and flatten its curves into lines
+ * @param matrix Transform to apply before flattening
+ * @param polygons Receives one polygon per subpath
+ * @param closedPolygons If not null, receives whether each subpath was closed
+ */
+void DrawList::Path::Flatten(const Matrix& matrix, std::vector<std::vector<wxPoint2DDouble>>& polygons,
+        std::vector<bool>* closedPolygons) const
+{
+ polygons.clear();
+ if (closedPolygons != nullptr)
+ {
+  closedPolygons->clear();
+ }
+
+ auto transform = [&matrix](wxPoint2DDouble point) {
+  matrix.Apply(point.m_x, point.m_y);
+  return point;
+ };
+
+ // A line or curve after a close starts a new subpath where
+ // the closed one started
+ wxPoint2DDouble start;
+ bool closed = true;
+ auto next = [&](wxPoint2DDouble point) {
+  if (closed)
+  {
+   polygons.emplace_back(1, start);
+   closed = false;
+   if (closedPolygons != nullptr)
+   {
+    closedPolygons->push_back(false);
+   }
+  }
+  polygons.back().push_back(point);
+ };
+
+ size_t p = 0;
+ for (auto op : mOps)
+ {
+  switch (op)
+  {
+  case Op::Move:
+   start = transform(mPoints[p++]);
+   polygons.emplace_back(1, start);
+   closed = false;
+   if (closedPolygons != nullptr)
+   {
+    closedPolygons->push_back(false);
+   }
+   break;
+
+  case Op::Line:
+   next(transform(mPoints[p++]));
+   break;
+
+  case Op::Curve:
+  {
+   auto p0 = closed ? start : polygons.back().back();
+   auto p1 = transform(mPoints[p]);
+   auto p2 = transform(mPoints[p + 1]);
+   auto p3 = transform(mPoints[p + 2]);
+   p += 3;
+
+   // The flattening error shrinks with the square of the
+   // segment count and grows with how sharply the curve bends
+   double bend = std::max(std::hypot(p0.m_x - 2 * p1.m_x + p2.m_x, p0.m_y - 2 * p1.m_y + p2.m_y),
+                          std::hypot(p1.m_x - 2 * p2.m_x + p3.m_x, p1.m_y - 2 * p2.m_y + p3.m_y));
+   int segments = std::clamp((int)std::ceil(std::sqrt(0.75 * bend / FlattenTolerance)), 1, MaxCurveSegments);
+   for (int i = 1; i <= segments; i++)
+   {
+    double t = (double)i / segments;
+    double u = 1 - t;
+    double a = u * u * u, b = 3 * u * u * t, c = 3 * u * t * t, d = t * t * t;
+    next(wxPoint2DDouble(a * p0.m_x + b * p1.m_x + c * p2.m_x + d * p3.m_x,
+                         a * p0.m_y + b * p1.m_y + c * p2.m_y + d * p3.m_y));
+   }
+   break;
+  }
+
+  case Op::Close:
+   if (closedPolygons != nullptr && !closed)
+   {
+    closedPolygons->back() = true;
+   }
+   closed = true;
+   break;
+  }
+ }
+}
+
+/**
+ * Determine if a point is inside the filled path
+ * @param x X of the point
+ * @param y Y of the point
+ * @param fillStyle Fill rule
+ * @return true if the point is inside
+ */
+bool DrawList::Path::Contains(double x, double y, wxPolygonFillMode fillStyle) const
+{
+ std::vector<std::vector<wxPoint2DDouble>> polygons;
+ Flatten(Matrix(), polygons);
+
+ int winding = 0;
+ for (auto& polygon : polygons)
+ {
+  for (size_t i = 0; i < polygon.size(); i++)
+  {
+   auto& a = polygon[i];
+   auto& b = polygon[(i + 1) % polygon.size()];
+   if ((a.m_y <= y) != (b.m_y <= y))
+   {
+    double crossX = a.m_x + (y - a.m_y) * (b.m_x - a.m_x) / (b.m_y - a.m_y);
+    if (crossX > x)
+    {
+     winding += b.m_y > a.m_y ? 1 : -1;
+    }
+   }
+  }
+ }
+
+ return fillStyle == wxWINDING_RULE ? winding != 0 : (winding & 1) != 0;
+}
+
+/**
+ * Get the path as made by the renderer of a graphics context,
+ * building it the first time it is asked for with that renderer
+ * @param graphics Graphics context the path will be drawn on
+ * @return Path for graphics
+ */
+wxGraphicsPath DrawList::Path::GetNative(std::shared_ptr<wxGraphicsContext> graphics) const
+{
+ if (mNativeRenderer == graphics->GetRenderer())
+ {
+  return mNative;
+ }
+
+ mNative = graphics->CreatePath();
+ size_t p = 0;
+ for (auto op : mOps)
+ {
+  switch (op)
+  {
+  case Op::Move:
+   mNative.MoveToPoint(mPoints[p].m_x, mPoints[p].m_y);
+   p++;
+   break;
+
+  case Op::Line:
+   mNative.AddLineToPoint(mPoints[p].m_x, mPoints[p].m_y);
+   p++;
+   break;
+
+  case Op::Curve:
+   mNative.AddCurveToPoint(mPoints[p].m_x, mPoints[p].m_y, mPoints[p + 1].m_x, mPoints[p + 1].m_y,
+           mPoints[p + 2].m_x, mPoints[p + 2].m_y);
+   p += 3;
+   break;
+
+  case Op::Close:
+   mNative.CloseSubpath();
+   break;
+  }
+ }
+
+ mNativeRenderer = graphics->GetRenderer();
+ return mNative;
+}
+
+/**
+ * Get the bitmap as made by the renderer of a graphics context,
+ * making it the first time it is asked for with that renderer
+ * @param graphics Graphics context the bitmap will be drawn on
+ * @return Bitmap for graphics
+ */
+wxGraphicsBitmap DrawList::Bitmap::GetNative(std::shared_ptr<wxGraphicsContext> graphics) const
+{
+ if (mNativeRenderer != graphics->GetRenderer())
+ {
+  mNative = graphics->CreateBitmapFromImage(*mImage);
+  mNativeRenderer = graphics->GetRenderer();
+ }
+
+ return mNative;
+}
+
+/**
+ * Remove all commands
+ */
+void DrawList::Clear()
+{
+ mCommands.clear();
+ mRecordedCount = 0;
+ mPaths.clear();
+ mBrushes.clear();
+ mPens.clear();
+ mRegions.clear();
+ mBitmaps.clear();
+ mTexts.clear();
+}
+
+/**
+ * Add a command that takes only numbers
+ * @param type Command type
+ * @param args Numbers in the order of the graphics context call
+ */
+void DrawList::Add(Type type, std::initializer_list<double> args)
+{
+ Command command;
+ command.mType = type;
+ std::copy_n(args.begin(), std::min(args.size(), (size_t)6), command.mArgs);
+ mCommands.push_back(command);
+ mRecordedCount++;
+}
+
+/**
+ * Add a Fill, Stroke or Draw command
+ * @param type Command type
+ * @param path Path to draw
+ * @param fillStyle Fill rule for Fill and Draw
+ */
+void DrawList::AddPath(Type type, const PathEntry& path, double fillStyle)
+{
+ Add(type, {fillStyle});
+ mCommands.back().mIndex = mPaths.size();
+ mPaths.push_back(path);
+}
+
+/**
+ * Add a Brush command
+ * @param brush Brush to set
+ */
+void DrawList::AddBrush(const BrushEntry& brush)
+{
+ Add(Type::Brush);
+ mCommands.back().mIndex = mBrushes.size();
+ mBrushes.push_back(brush);
+}
+
+/**
+ * Add a Pen command
+ * @param pen Pen to set
+ */
+void DrawList::AddPen(const PenEntry& pen)
+{
+ Add(Type::Pen);
+ mCommands.back().mIndex = mPens.size();
+ mPens.push_back(pen);
+}
+
+/**
+ * Add a Clip command for a region
+ * @param region Region to clip to
+ */
+void DrawList::AddClip(const wxRegion& region)
+{
+ Add(Type::Clip);
+ mCommands.back().mIndex = mRegions.size();
+ mRegions.push_back(region);
+}
+
+/**
+ * Add a DrawBitmap command
+ * @param bitmap Bitmap to draw
+ * @param x X of the left edge
+ * @param y Y of the top edge
+ * @param w Width to draw
+ * @param h Height to draw
+ */
+void DrawList::AddBitmap(const BitmapEntry& bitmap, double x, double y, double w, double h)
+{
+ Add(Type::DrawBitmap, {x, y, w, h});
+ mCommands.back().mIndex = mBitmaps.size();
+ mBitmaps.push_back(bitmap);
+}
+
+/**
+ * Add a DrawText command
+ * @param text Text and font
+ * @param x X of the left edge
+ * @param y Y of the top edge
+ */
+void DrawList::AddText(const TextEntry& text, double x, double y)
+{
+ Add(Type::DrawText, {x, y});
+ mCommands.back().mIndex = mTexts.size();
+ mTexts.push_back(text);
+}
+
+/**
+ * Determine if two Brush commands set the same brush
+ * @param a Index of one brush
+ * @param b Index of the other brush
+ * @return true if setting b after a changes nothing
+ */
+bool DrawList::SameBrush(size_t a, size_t b) const
+{
+ auto& first = mBrushes[a];
+ auto& second = mBrushes[b];
+ if (!first.mForeign.IsNull() || !second.mForeign.IsNull())
+ {
+  return first.mForeign.GetRefData() == second.mForeign.GetRefData();
+ }
+
+ return first.mBrush == second.mBrush;
+}
+
+/**
+ * Determine if two Pen commands set the same pen
+ * @param a Index of one pen
+ * @param b Index of the other pen
+ * @return true if setting b after a changes nothing
+ */
+bool DrawList::SamePen(size_t a, size_t b) const
+{
+ auto& first = mPens[a];
+ auto& second = mPens[b];
+ if (!first.mForeign.IsNull() || !second.mForeign.IsNull())
+ {
+  return first.mForeign.GetRefData() == second.mForeign.GetRefData();
+ }
+
+ if (first.mNull || second.mNull)
+ {
+  return first.mNull == second.mNull;
+ }
+
+ // Dashes, stipples and gradients are not compared, so pens
+ // that have them are never taken to be the same
+ auto& one = first.mInfo;
+ auto& two = second.mInfo;
+ return one.GetStyle() == two.GetStyle() && one.GetStyle() != wxPENSTYLE_USER_DASH &&
+         one.GetStyle() != wxPENSTYLE_STIPPLE && one.GetGradientType() == wxGRADIENT_NONE &&
+         two.GetGradientType() == wxGRADIENT_NONE && one.GetColour() == two.GetColour() &&
+         one.GetWidth() == two.GetWidth() && one.GetJoin() == two.GetJoin() && one.GetCap() == two.GetCap();
+}
+
+/**
+ * Merge a Fill or Draw command into the one before it if they
+ * have the same brush and pen and do not overlap, so filling the
+ * merged path draws the same as drawing each.
+ * @param commands Optimized commands so far
+ * @param command Fill or Draw command to merge
+ * @param margin How far the command may draw past its path, negative if unknown
+ * @param group Bounds of the paths merged into the last command
+ * @param groupPath Path of the last command if it has been merged into
+ * @return true if merged, false if command has to be added
+ */
+bool DrawList::Merge(std::vector<Command>& commands, const Command& command, double margin,
+        std::vector<wxRect2DDouble>& group, std::shared_ptr<Path>& groupPath)
+{
+ auto path = mPaths[command.mIndex].mPath;
+ double left, top, right, bottom;
+ if (margin < 0 || path == nullptr || !path->GetBounds(&left, &top, &right, &bottom))
+ {
+  group.clear();
+  groupPath.reset();
+  return false;
+ }
+
+ wxRect2DDouble bounds(left - margin, top - margin, right - left + margin * 2, bottom - top + margin * 2);
+ bool merge = !group.empty() && commands.back().mType == command.mType &&
+         commands.back().mArgs[0] == command.mArgs[0];
+ for (auto& other : group)
+ {
+  if (bounds.m_x < other.m_x + other.m_width && other.m_x < bounds.m_x + bounds.m_width &&
+      bounds.m_y < other.m_y + other.m_height && other.m_y < bounds.m_y + bounds.m_height)
+  {
+   merge = false;
+   break;
+  }
+ }
+
+ if (!merge)
+ {
+  group.assign(1, bounds);
+  groupPath.reset();
+  return false;
+ }
+
+ // The first merge copies the path, which may be shared
+ // with the component that made it
+ auto& last = commands.back();
+ if (groupPath == nullptr)
+ {
+  groupPath = std::make_shared<Path>(*mPaths[last.mIndex].mPath);
+  last.mIndex = mPaths.size();
+  mPaths.push_back({groupPath, wxGraphicsPath()});
+ }
+
+ groupPath->Append(*path);
+ group.push_back(bounds);
+ return true;
+}
+
+/**
+ * Remove commands that change nothing and merge fills.
+ *
+ * A Brush, Pen or mode command that sets what is already set is
+ * dropped, as are transforms that do nothing. Consecutive
+ * translations, scales and rotations are combined. A PushState
+ * whose PopState only undoes transform and clip changes is dropped
+ * along with them. Fills with the same brush, and draws with the
+ * same brush and pen, that follow one another and do not overlap
+ * become one path.
+ */
+void DrawList::Optimize()
+{
+ std::vector<Command> commands;
+ commands.reserve(mCommands.size());
+
+ // Where in commands each open PushState is
+ std::vector<size_t> pushes;
+
+ // Current brush and pen as indexes into mBrushes and mPens
+ const size_t None = (size_t)-1;
+ size_t brush = None;
+ size_t pen = None;
+
+ // Antialias, interpolation and composition modes, -1 if not known
+ double modes[3] = {-1, -1, -1};
+
+ // Bounds of the paths merged into the last command, and its
+ // path once it has been merged into
+ std::vector<wxRect2DDouble> group;
+ std::shared_ptr<Path> groupPath;
+
+ for (auto& command : mCommands)
+ {
+  auto last = commands.empty() ? nullptr : &commands.back();
+  switch (command.mType)
+  {
+  case Type::Brush:
+   if (brush != None && SameBrush(brush, command.mIndex))
+   {
+    continue;
+   }
+   brush = command.mIndex;
+   break;
+
+  case Type::Pen:
+   if (pen != None && SamePen(pen, command.mIndex))
+   {
+    continue;
+   }
+   pen = command.mIndex;
+   break;
+
+  case Type::Antialias:
+  case Type::Interpolation:
+  case Type::Composition:
+  {
+   auto& mode = modes[(int)command.mType - (int)Type::Antialias];
+   if (mode == command.mArgs[0])
+   {
+    continue;
+   }
+   mode = command.mArgs[0];
+   break;
+  }
+
+  case Type::Translate:
+   if (command.mArgs[0] == 0 && command.mArgs[1] == 0)
+   {
+    continue;
+   }
+   if (last != nullptr && last->mType == Type::Translate)
+   {
+    last->mArgs[0] += command.mArgs[0];
+    last->mArgs[1] += command.mArgs[1];
+    continue;
+   }
+   break;
+
+  case Type::Scale:
+   if (command.mArgs[0] == 1 && command.mArgs[1] == 1)
+   {
+    continue;
+   }
+   if (last != nullptr && last->mType == Type::Scale)
+   {
+    last->mArgs[0] *= command.mArgs[0];
+    last->mArgs[1] *= command.mArgs[1];
+    continue;
+   }
+   break;
+
+  case Type::Rotate:
+   if (command.mArgs[0] == 0)
+   {
+    continue;
+   }
+   if (last != nullptr && last->mType == Type::Rotate)
+   {
+    last->mArgs[0] += command.mArgs[0];
+    continue;
+   }
+   break;
+
+  case Type::Concat:
+  {
+   auto& args = command.mArgs;
+   if (Matrix{args[0], args[1], args[2], args[3], args[4], args[5]}.IsIdentity())
+   {
+    continue;
+   }
+   break;
+  }
+
+  case Type::PushState:
+   // Fills are not merged across it, but if it turns out to do
+   // nothing the fills before it can go on merging
+   pushes.push_back(commands.size());
+   commands.push_back(command);
+   continue;
+
+  case Type::PopState:
+   // The modes may be restored along with the transform
+   std::fill(std::begin(modes), std::end(modes), -1);
+   if (!pushes.empty())
+   {
+    size_t push = pushes.back();
+    pushes.pop_back();
+    if (std::all_of(commands.begin() + push + 1, commands.end(),
+            [](const Command& c) {return IsRestored(c.mType);}))
+    {
+     commands.resize(push);
+     continue;
+    }
+   }
+   break;
+
+  case Type::Fill:
+  case Type::Draw:
+  {
+   // A draw also strokes, which reaches past the path by the pen
+   // width at most, once miter joins are allowed for
+   double margin = AntialiasMargin;
+   if (command.mType == Type::Draw)
+   {
+    if (pen == None || !mPens[pen].mForeign.IsNull())
+    {
+     margin = -1;
+    }
+    else if (!mPens[pen].mNull)
+    {
+     margin += mPens[pen].mInfo.GetWidth();
+    }
+   }
+
+   if (Merge(commands, command, margin, group, groupPath))
+   {
+    continue;
+   }
+
+   commands.push_back(command);
+   continue;
+  }
+
+  default:
+   break;
+  }
+
+  commands.push_back(command);
+  group.clear();
+  groupPath.reset();
+ }
+
+ mCommands = std::move(commands);
+}
+
+/**
+ * Issue the commands to a graphics context
+ * @param graphics Graphics context to draw on
+ */
+void DrawList::Replay(std::shared_ptr<wxGraphicsContext> graphics) const
+{
+ WxRenderer renderer(graphics);
+ Replay(renderer);
+}
+
+/**
+ * Issue the commands to a renderer
+ * @param renderer Renderer to draw with
+ */
+void DrawList::Replay(IRenderer& renderer) const
+{
+ for (auto& command : mCommands)
+ {
+  auto& args = command.mArgs;
+  switch (command.mType)
+  {
+  case Type::PushState:
+   renderer.PushState();
+   break;
+
+  case Type::PopState:
+   renderer.PopState();
+   break;
+
+  case Type::Translate:
+   renderer.Translate(args[0], args[1]);
+   break;
+
+  case Type::Scale:
+   renderer.Scale(args[0], args[1]);
+   break;
+
+  case Type::Rotate:
+   renderer.Rotate(args[0]);
+   break;
+
+  case Type::Concat:
+   renderer.ConcatTransform({args[0], args[1], args[2], args[3], args[4], args[5]});
+   break;
+
+  case Type::SetTransform:
+   renderer.SetTransform({args[0], args[1], args[2], args[3], args[4], args[5]});
+   break;
+
+  case Type::Clip:
+   renderer.Clip(mRegions[command.mIndex]);
+   break;
+
+  case Type::ClipRect:
+   renderer.Clip(args[0], args[1], args[2], args[3]);
+   break;
+
+  case Type::ResetClip:
+   renderer.ResetClip();
+   break;
+
+  case Type::Brush:
+   renderer.SetBrush(mBrushes[command.mIndex]);
+   break;
+
+  case Type::Pen:
+   renderer.SetPen(mPens[command.mIndex]);
+   break;
+
+  case Type::Antialias:
+   renderer.SetAntialiasMode((wxAntialiasMode)(int)args[0]);
+   break;
+
+  case Type::Interpolation:
+   renderer.SetInterpolationQuality((wxInterpolationQuality)(int)args[0]);
+   break;
+
+  case Type::Composition:
+   renderer.SetCompositionMode((wxCompositionMode)(int)args[0]);
+   break;
+
+  case Type::Fill:
+   renderer.FillPath(mPaths[command.mIndex], (wxPolygonFillMode)(int)args[0]);
+   break;
+
+  case Type::Stroke:
+   renderer.StrokePath(mPaths[command.mIndex]);
+   break;
+
+  case Type::Draw:
+   renderer.DrawPath(mPaths[command.mIndex], (wxPolygonFillMode)(int)args[0]);
+   break;
+
+  case Type::DrawBitmap:
+   renderer.DrawBitmap(mBitmaps[command.mIndex], args[0], args[1], args[2], args[3]);
+   break;
+
+  case Type::DrawText:
+   renderer.DrawText(mTexts[command.mIndex], args[0], args[1]);
+   break;
+
+  case Type::BeginLayer:
+   renderer.BeginLayer(args[0]);
+   break;
+
+  case Type::EndLayer:
+   renderer.EndLayer();
+   break;
+  }
+ }
+}
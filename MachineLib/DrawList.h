@@ -0,0 +1,265 @@
+/**
+ * @file DrawList.h
+ * @author Thomas Conley
+ *
+ * A recorded list of drawing commands.
+ */
+
+#ifndef DRAWLIST_H
+#define DRAWLIST_H
+
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+class IRenderer;
+
+/**
+ * A recorded list of drawing commands.
+ *
+ * A DrawRecorder fills the list in place of a graphics context.
+ * Optimize then removes the state changes that change nothing and
+ * merges fills with the same brush that do not overlap into one
+ * path, and Replay issues what is left to a renderer, or to a real
+ * graphics context through a WxRenderer.
+ *
+ * Paths, brushes, pens and bitmaps made by the recorder are kept
+ * in a form that can be taken apart. Objects made by some other
+ * renderer are kept as they are and replayed unchanged.
+ */
+class DrawList {
+public:
+ /// An affine transform, x' = a x + c y + tx, y' = b x + d y + ty
+ struct Matrix {
+  double mA = 1;    ///< Scale of x into x
+  double mB = 0;    ///< Shear of x into y
+  double mC = 0;    ///< Shear of y into x
+  double mD = 1;    ///< Scale of y into y
+  double mTx = 0;   ///< Translation in x
+  double mTy = 0;   ///< Translation in y
+
+  void Concat(const Matrix& matrix);
+  void Translate(double dx, double dy);
+  void Scale(double xScale, double yScale);
+  void Rotate(double angle);
+  bool Invert();
+  void Apply(double& x, double& y) const;
+  bool IsIdentity() const;
+ };
+
+ /// A recorded path
+ class Path {
+ public:
+  /// Path element
+  enum class Op : unsigned char {Move, Line, Curve, Close};
+
+ private:
+  /// Elements of the path
+  std::vector<Op> mOps;
+
+  /// Points of the elements, one for a move or line and three for a curve
+  std::vector<wxPoint2DDouble> mPoints;
+
+  /// Start of the current subpath
+  wxPoint2DDouble mStart;
+
+  /// Current point
+  wxPoint2DDouble mCurrent;
+
+  /// Path built for mNativeRenderer, made when first replayed
+  mutable wxGraphicsPath mNative;
+
+  /// Renderer mNative was built for
+  mutable wxGraphicsRenderer* mNativeRenderer = nullptr;
+
+  void Changed() {mNativeRenderer = nullptr;}
+
+ public:
+  void MoveTo(double x, double y);
+  void LineTo(double x, double y);
+  void CurveTo(double cx1, double cy1, double cx2, double cy2, double x, double y);
+  void Close();
+  void Arc(double x, double y, double r, double startAngle, double endAngle, bool clockwise);
+  void Append(const Path& path);
+  void Transform(const Matrix& matrix);
+
+  bool GetCurrentPoint(double* x, double* y) const;
+  bool GetBounds(double* left, double* top, double* right, double* bottom) const;
+  void Flatten(const Matrix& matrix, std::vector<std::vector<wxPoint2DDouble>>& polygons,
+          std::vector<bool>* closedPolygons = nullptr) const;
+  bool Contains(double x, double y, wxPolygonFillMode fillStyle) const;
+  wxGraphicsPath GetNative(std::shared_ptr<wxGraphicsContext> graphics) const;
+
+  /// Get the elements of the path
+  /// @return Elements in order
+  const std::vector<Op>& GetOps() const {return mOps;}
+
+  /// Get the points of the elements
+  /// @return Points in order
+  const std::vector<wxPoint2DDouble>& GetPoints() const {return mPoints;}
+ };
+
+ /// A recorded bitmap
+ class Bitmap {
+ private:
+  /// Pixels of the bitmap, never shared by wxImage reference counting
+  std::shared_ptr<const wxImage> mImage;
+
+  /// Bitmap made for mNativeRenderer, made when first replayed
+  mutable wxGraphicsBitmap mNative;
+
+  /// Renderer mNative was made for
+  mutable wxGraphicsRenderer* mNativeRenderer = nullptr;
+
+ public:
+  /// Constructor
+  /// @param image Pixels of the bitmap, from ImageCache::Share
+  explicit Bitmap(std::shared_ptr<const wxImage> image) : mImage(std::move(image)) {}
+
+  /// Get the pixels of the bitmap
+  /// @return Image
+  const wxImage& GetImage() const {return *mImage;}
+
+  wxGraphicsBitmap GetNative(std::shared_ptr<wxGraphicsContext> graphics) const;
+ };
+
+ /// What a command does
+ enum class Type {
+  PushState, PopState,
+  Translate, Scale, Rotate, Concat, SetTransform,
+  Clip, ClipRect, ResetClip,
+  Brush, Pen, Antialias, Interpolation, Composition,
+  Fill, Stroke, Draw, DrawBitmap, DrawText,
+  BeginLayer, EndLayer
+ };
+
+ /// One recorded command
+ struct Command {
+  /// What the command does
+  Type mType;
+
+  /// Entry in the table for the type, for commands that use one
+  size_t mIndex = 0;
+
+  /// Numbers the command takes, in the order of the graphics context call
+  double mArgs[6] = {0, 0, 0, 0, 0, 0};
+ };
+
+ /// A path to fill or stroke
+ struct PathEntry {
+  std::shared_ptr<const Path> mPath;    ///< Recorded path, or null if foreign
+  wxGraphicsPath mForeign;              ///< Path from some other renderer
+ };
+
+ /// A brush to set
+ struct BrushEntry {
+  wxBrush mBrush;                       ///< Recorded brush, not ok for no brush
+  wxGraphicsBrush mForeign;             ///< Brush from some other renderer
+ };
+
+ /// A pen to set
+ struct PenEntry {
+  wxGraphicsPenInfo mInfo;              ///< Recorded pen
+  bool mNull = true;                    ///< True for no pen
+  wxGraphicsPen mForeign;               ///< Pen from some other renderer
+ };
+
+ /// A bitmap to draw
+ struct BitmapEntry {
+  std::shared_ptr<const Bitmap> mBitmap;        ///< Recorded bitmap, or null if foreign
+  wxGraphicsBitmap mForeign;                    ///< Bitmap from some other renderer
+ };
+
+ /// Text to draw
+ struct TextEntry {
+  wxString mText;               ///< The text
+  wxGraphicsFont mFont;         ///< Font to draw it in
+ };
+
+private:
+ /// The commands in order
+ std::vector<Command> mCommands;
+
+ /// Number of commands recorded, before Optimize
+ size_t mRecordedCount = 0;
+
+ std::vector<PathEntry> mPaths;         ///< Paths of the Fill, Stroke and Draw commands
+ std::vector<BrushEntry> mBrushes;      ///< Brushes of the Brush commands
+ std::vector<PenEntry> mPens;           ///< Pens of the Pen commands
+ std::vector<wxRegion> mRegions;        ///< Regions of the Clip commands
+ std::vector<BitmapEntry> mBitmaps;     ///< Bitmaps of the DrawBitmap commands
+ std::vector<TextEntry> mTexts;         ///< Text of the DrawText commands
+
+ bool SameBrush(size_t a, size_t b) const;
+ bool SamePen(size_t a, size_t b) const;
+ bool Merge(std::vector<Command>& commands, const Command& command, double margin,
+         std::vector<wxRect2DDouble>& group, std::shared_ptr<Path>& groupPath);
+
+public:
+ DrawList() = default;
+
+ /// Copy constructor (disabled)
+ DrawList(const DrawList &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const DrawList &) = delete;
+
+ void Clear();
+ void Add(Type type, std::initializer_list<double> args = {});
+ void AddPath(Type type, const PathEntry& path, double fillStyle = 0);
+ void AddBrush(const BrushEntry& brush);
+ void AddPen(const PenEntry& pen);
+ void AddClip(const wxRegion& region);
+ void AddBitmap(const BitmapEntry& bitmap, double x, double y, double w, double h);
+ void AddText(const TextEntry& text, double x, double y);
+
+ void Optimize();
+ void Replay(std::shared_ptr<wxGraphicsContext> graphics) const;
+ void Replay(IRenderer& renderer) const;
+
+ /// Get the commands
+ /// @return Commands in order
+ const std::vector<Command>& GetCommands() const {return mCommands;}
+
+ /// Get the number of commands that were recorded
+ /// @return Context calls before Optimize
+ size_t GetRecordedCount() const {return mRecordedCount;}
+
+ /// Get the number of commands that are replayed
+ /// @return Context calls after Optimize
+ size_t GetCount() const {return mCommands.size();}
+
+ /// Get a path entry
+ /// @param index mIndex of the command
+ /// @return Path entry
+ const PathEntry& GetPath(size_t index) const {return mPaths[index];}
+
+ /// Get a brush entry
+ /// @param index mIndex of the command
+ /// @return Brush entry
+ const BrushEntry& GetBrush(size_t index) const {return mBrushes[index];}
+
+ /// Get a pen entry
+ /// @param index mIndex of the command
+ /// @return Pen entry
+ const PenEntry& GetPen(size_t index) const {return mPens[index];}
+
+ /// Get a clip region
+ /// @param index mIndex of the command
+ /// @return Region
+ const wxRegion& GetRegion(size_t index) const {return mRegions[index];}
+
+ /// Get a bitmap entry
+ /// @param index mIndex of the command
+ /// @return Bitmap entry
+ const BitmapEntry& GetBitmap(size_t index) const {return mBitmaps[index];}
+
+ /// Get a text entry
+ /// @param index mIndex of the command
+ /// @return Text entry
+ const TextEntry& GetText(size_t index) const {return mTexts[index];}
+};
+
+
+
+#endif //DRAWLIST_H
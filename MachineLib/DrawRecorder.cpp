@@ -0,0 +1,824 @@
+/**
+ * @file DrawRecorder.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "DrawRecorder.h"
+#include "IRenderer.h"
+#include "ImageCache.h"
+#include <algorithm>
+
+/**
+ * Read any graphics matrix
+ * @param matrix Matrix from any renderer
+ * @return The transform
+ */
+static DrawList::Matrix ToMatrix(const wxGraphicsMatrixData* matrix)
+{
+ DrawList::Matrix result;
+ matrix->Get(&result.mA, &result.mB, &result.mC, &result.mD, &result.mTx, &result.mTy);
+ return result;
+}
+
+/**
+ * A transform made by the recording renderer
+ */
+class RecordedMatrixData : public wxGraphicsMatrixData {
+public:
+ /// The transform
+ DrawList::Matrix mMatrix;
+
+ /// Constructor
+ /// @param renderer Recording renderer
+ /// @param matrix The transform
+ RecordedMatrixData(wxGraphicsRenderer* renderer, const DrawList::Matrix& matrix) :
+     wxGraphicsMatrixData(renderer), mMatrix(matrix) {}
+
+ wxGraphicsObjectRefData* Clone() const override {return new RecordedMatrixData(GetRenderer(), mMatrix);}
+ void Concat(const wxGraphicsMatrixData* t) override {mMatrix.Concat(ToMatrix(t));}
+ void Set(wxDouble a, wxDouble b, wxDouble c, wxDouble d, wxDouble tx, wxDouble ty) override
+ {
+  mMatrix = {a, b, c, d, tx, ty};
+ }
+
+ void Get(wxDouble* a, wxDouble* b, wxDouble* c, wxDouble* d, wxDouble* tx, wxDouble* ty) const override
+ {
+  if (a) *a = mMatrix.mA;
+  if (b) *b = mMatrix.mB;
+  if (c) *c = mMatrix.mC;
+  if (d) *d = mMatrix.mD;
+  if (tx) *tx = mMatrix.mTx;
+  if (ty) *ty = mMatrix.mTy;
+ }
+
+ void Invert() override {mMatrix.Invert();}
+ bool IsEqual(const wxGraphicsMatrixData* t) const override
+ {
+  auto other = ToMatrix(t);
+  return mMatrix.mA == other.mA && mMatrix.mB == other.mB && mMatrix.mC == other.mC &&
+          mMatrix.mD == other.mD && mMatrix.mTx == other.mTx && mMatrix.mTy == other.mTy;
+ }
+
+ bool IsIdentity() const override {return mMatrix.IsIdentity();}
+ void Translate(wxDouble dx, wxDouble dy) override {mMatrix.Translate(dx, dy);}
+ void Scale(wxDouble xScale, wxDouble yScale) override {mMatrix.Scale(xScale, yScale);}
+ void Rotate(wxDouble angle) override {mMatrix.Rotate(angle);}
+ void TransformPoint(wxDouble* x, wxDouble* y) const override {mMatrix.Apply(*x, *y);}
+ void TransformDistance(wxDouble* dx, wxDouble* dy) const override
+ {
+  auto matrix = mMatrix;
+  matrix.mTx = matrix.mTy = 0;
+  matrix.Apply(*dx, *dy);
+ }
+
+ void* GetNativeMatrix() const override {return const_cast<DrawList::Matrix*>(&mMatrix);}
+};
+
+/**
+ * A path made by the recording renderer.
+ *
+ * Recorded commands share the path, so it is copied before it is
+ * changed if any command still refers to it.
+ */
+class RecordedPathData : public wxGraphicsPathData {
+private:
+ /// The path
+ std::shared_ptr<DrawList::Path> mPath;
+
+ /// Get the path to change, copying it if it is shared
+ /// @return Path to change
+ DrawList::Path* Edit()
+ {
+  if (mPath.use_count() > 1)
+  {
+   mPath = std::make_shared<DrawList::Path>(*mPath);
+  }
+  return mPath.get();
+ }
+
+public:
+ /// Constructor
+ /// @param renderer Recording renderer
+ /// @param path The path
+ RecordedPathData(wxGraphicsRenderer* renderer, std::shared_ptr<DrawList::Path> path) :
+     wxGraphicsPathData(renderer), mPath(path) {}
+
+ /// Get the path to record
+ /// @return Path, unchanged from here on
+ std::shared_ptr<const DrawList::Path> Share() const {return mPath;}
+
+ wxGraphicsObjectRefData* Clone() const override {return new RecordedPathData(GetRenderer(), mPath);}
+ void MoveToPoint(wxDouble x, wxDouble y) override {Edit()->MoveTo(x, y);}
+ void AddLineToPoint(wxDouble x, wxDouble y) override {Edit()->LineTo(x, y);}
+ void AddCurveToPoint(wxDouble cx1, wxDouble cy1, wxDouble cx2, wxDouble cy2, wxDouble x, wxDouble y) override
+ {
+  Edit()->CurveTo(cx1, cy1, cx2, cy2, x, y);
+ }
+
+ void AddPath(const wxGraphicsPathData* path) override
+ {
+  // A path from another renderer cannot be read
+  auto recorded = dynamic_cast<const RecordedPathData*>(path);
+  if (recorded != nullptr)
+  {
+   Edit()->Append(*recorded->mPath);
+  }
+ }
+
+ void CloseSubpath() override {Edit()->Close();}
+ void GetCurrentPoint(wxDouble* x, wxDouble* y) const override {mPath->GetCurrentPoint(x, y);}
+ void AddArc(wxDouble x, wxDouble y, wxDouble r, wxDouble startAngle, wxDouble endAngle, bool clockwise) override
+ {
+  Edit()->Arc(x, y, r, startAngle, endAngle, clockwise);
+ }
+
+ void* GetNativePath() const override {return mPath.get();}
+ void UnGetNativePath(void*) const override {}
+ void Transform(const wxGraphicsMatrixData* matrix) override {Edit()->Transform(ToMatrix(matrix));}
+ void GetBox(wxDouble* x, wxDouble* y, wxDouble* w, wxDouble* h) const override
+ {
+  double left, top, right, bottom;
+  mPath->GetBounds(&left, &top, &right, &bottom);
+  *x = left;
+  *y = top;
+  *w = right - left;
+  *h = bottom - top;
+ }
+
+ bool Contains(wxDouble x, wxDouble y, wxPolygonFillMode fillStyle) const override
+ {
+  return mPath->Contains(x, y, fillStyle);
+ }
+};
+
+/**
+ * A brush made by the recording renderer
+ */
+class RecordedBrushData : public wxGraphicsObjectRefData {
+public:
+ /// The brush
+ wxBrush mBrush;
+
+ /// Constructor
+ /// @param renderer Recording renderer
+ /// @param brush The brush
+ RecordedBrushData(wxGraphicsRenderer* renderer, const wxBrush& brush) :
+     wxGraphicsObjectRefData(renderer), mBrush(brush) {}
+};
+
+/**
+ * A pen made by the recording renderer
+ */
+class RecordedPenData : public wxGraphicsObjectRefData {
+public:
+ /// The pen
+ wxGraphicsPenInfo mInfo;
+
+ /// Constructor
+ /// @param renderer Recording renderer
+ /// @param info The pen
+ RecordedPenData(wxGraphicsRenderer* renderer, const wxGraphicsPenInfo& info) :
+     wxGraphicsObjectRefData(renderer), mInfo(info) {}
+};
+
+/**
+ * A bitmap made by the recording renderer
+ */
+class RecordedBitmapData : public wxGraphicsBitmapData {
+public:
+ /// The bitmap
+ std::shared_ptr<const DrawList::Bitmap> mBitmap;
+
+ /// Constructor
+ /// @param renderer Recording renderer
+ /// @param image Pixels of the bitmap
+ RecordedBitmapData(wxGraphicsRenderer* renderer, const wxImage& image) :
+     wxGraphicsBitmapData(renderer),
+     mBitmap(std::make_shared<DrawList::Bitmap>(cse335::ImageCache::Get().Share(image))) {}
+
+ void* GetNativeBitmap() const override {return nullptr;}
+};
+
+/**
+ * Makes the objects a DrawRecorder records. It makes no contexts
+ * of its own; a DrawRecorder is made for a real graphics context.
+ */
+class RecordingRenderer : public wxGraphicsRenderer {
+private:
+ /// Copy a matrix made by this renderer into one made by the default renderer
+ /// @param matrix Matrix to copy
+ /// @return Matrix for the default renderer
+ static wxGraphicsMatrix ToDefault(const wxGraphicsMatrix& matrix)
+ {
+  if (matrix.IsNull())
+  {
+   return wxNullGraphicsMatrix;
+  }
+
+  double a, b, c, d, tx, ty;
+  matrix.Get(&a, &b, &c, &d, &tx, &ty);
+  return GetDefaultRenderer()->CreateMatrix(a, b, c, d, tx, ty);
+ }
+
+public:
+ wxGraphicsContext* CreateContext(const wxWindowDC&) override {return nullptr;}
+ wxGraphicsContext* CreateContext(const wxMemoryDC&) override {return nullptr;}
+#if wxUSE_PRINTING_ARCHITECTURE
+ wxGraphicsContext* CreateContext(const wxPrinterDC&) override {return nullptr;}
+#endif
+#if defined(__WXMSW__) && wxUSE_ENH_METAFILE
+ wxGraphicsContext* CreateContext(const wxEnhMetaFileDC&) override {return nullptr;}
+#endif
+ wxGraphicsContext* CreateContextFromNativeContext(void*) override {return nullptr;}
+ wxGraphicsContext* CreateContextFromNativeWindow(void*) override {return nullptr;}
+#ifdef __WXMSW__
+ wxGraphicsContext* CreateContextFromNativeHDC(WXHDC) override {return nullptr;}
+#endif
+ wxGraphicsContext* CreateContext(wxWindow*) override {return nullptr;}
+#if wxUSE_IMAGE
+ wxGraphicsContext* CreateContextFromImage(wxImage&) override {return nullptr;}
+#endif
+ wxGraphicsContext* CreateMeasuringContext() override {return nullptr;}
+
+ wxGraphicsPath CreatePath() override
+ {
+  wxGraphicsPath path;
+  path.SetRefData(new RecordedPathData(this, std::make_shared<DrawList::Path>()));
+  return path;
+ }
+
+ wxGraphicsMatrix CreateMatrix(wxDouble a, wxDouble b, wxDouble c, wxDouble d, wxDouble tx, wxDouble ty) override
+ {
+  wxGraphicsMatrix matrix;
+  matrix.SetRefData(new RecordedMatrixData(this, {a, b, c, d, tx, ty}));
+  return matrix;
+ }
+
+ wxGraphicsPen CreatePen(const wxGraphicsPenInfo& info) override
+ {
+  wxGraphicsPen pen;
+  pen.SetRefData(new RecordedPenData(this, info));
+  return pen;
+ }
+
+ wxGraphicsBrush CreateBrush(const wxBrush& brush) override
+ {
+  wxGraphicsBrush result;
+  result.SetRefData(new RecordedBrushData(this, brush));
+  return result;
+ }
+
+ wxGraphicsBrush CreateLinearGradientBrush(wxDouble x1, wxDouble y1, wxDouble x2, wxDouble y2,
+         const wxGraphicsGradientStops& stops, const wxGraphicsMatrix& matrix) override
+ {
+  return GetDefaultRenderer()->CreateLinearGradientBrush(x1, y1, x2, y2, stops, ToDefault(matrix));
+ }
+
+ wxGraphicsBrush CreateRadialGradientBrush(wxDouble startX, wxDouble startY, wxDouble endX, wxDouble endY,
+         wxDouble radius, const wxGraphicsGradientStops& stops, const wxGraphicsMatrix& matrix) override
+ {
+  return GetDefaultRenderer()->CreateRadialGradientBrush(startX, startY, endX, endY, radius, stops,
+          ToDefault(matrix));
+ }
+
+ wxGraphicsFont CreateFont(const wxFont& font, const wxColour& col) override
+ {
+  return GetDefaultRenderer()->CreateFont(font, col);
+ }
+
+ wxGraphicsFont CreateFont(double sizeInPixels, const wxString& facename, int flags, const wxColour& col) override
+ {
+  return GetDefaultRenderer()->CreateFont(sizeInPixels, facename, flags, col);
+ }
+
+ wxGraphicsFont CreateFontAtDPI(const wxFont& font, const wxRealPoint& dpi, const wxColour& col) override
+ {
+  return GetDefaultRenderer()->CreateFontAtDPI(font, dpi, col);
+ }
+
+ wxGraphicsBitmap CreateBitmap(const wxBitmap& bitmap) override
+ {
+  return CreateBitmapFromImage(bitmap.ConvertToImage());
+ }
+
+#if wxUSE_IMAGE
+ wxGraphicsBitmap CreateBitmapFromImage(const wxImage& image) override
+ {
+  wxGraphicsBitmap bitmap;
+  bitmap.SetRefData(new RecordedBitmapData(this, image));
+  return bitmap;
+ }
+
+ wxImage CreateImageFromBitmap(const wxGraphicsBitmap& bmp) override
+ {
+  if (bmp.GetRenderer() == this)
+  {
+   return static_cast<RecordedBitmapData*>(bmp.GetGraphicsData())->mBitmap->GetImage().Copy();
+  }
+
+  return bmp.IsNull() ? wxImage() : bmp.GetRenderer()->CreateImageFromBitmap(bmp);
+ }
+#endif
+
+ wxGraphicsBitmap CreateBitmapFromNativeBitmap(void* bitmap) override
+ {
+  return GetDefaultRenderer()->CreateBitmapFromNativeBitmap(bitmap);
+ }
+
+ wxGraphicsBitmap CreateSubBitmap(const wxGraphicsBitmap& bitmap,
+         wxDouble x, wxDouble y, wxDouble w, wxDouble h) override
+ {
+  if (bitmap.GetRenderer() != this)
+  {
+   return bitmap.IsNull() ? wxNullGraphicsBitmap : bitmap.GetRenderer()->CreateSubBitmap(bitmap, x, y, w, h);
+  }
+
+  auto& image = static_cast<RecordedBitmapData*>(bitmap.GetGraphicsData())->mBitmap->GetImage();
+  return CreateBitmapFromImage(image.GetSubImage(wxRect((int)x, (int)y, (int)w, (int)h)));
+ }
+
+ wxString GetName() const override {return L"DrawRecorder";}
+ void GetVersion(int* major, int* minor, int* micro) const override
+ {
+  if (major) *major = 1;
+  if (minor) *minor = 0;
+  if (micro) *micro = 0;
+ }
+};
+
+/**
+ * Constructor
+ * @param graphics Graphics context the commands will be replayed on
+ * @param list List to record into
+ */
+DrawRecorder::DrawRecorder(std::shared_ptr<wxGraphicsContext> graphics, DrawList& list) :
+    wxGraphicsContext(GetRecordingRenderer()), mList(list)
+{
+ mMatrix = ToMatrix(graphics->GetTransform().GetMatrixData());
+ m_antialias = graphics->GetAntialiasMode();
+ m_interpolation = graphics->GetInterpolationQuality();
+ m_composition = graphics->GetCompositionMode();
+ graphics->GetSize(&mSize[0], &mSize[1]);
+ graphics->GetClipBox(&mClipBox[0], &mClipBox[1], &mClipBox[2], &mClipBox[3]);
+}
+
+/**
+ * Constructor
+ * @param renderer Renderer the commands will be replayed on
+ * @param list List to record into
+ */
+DrawRecorder::DrawRecorder(IRenderer& renderer, DrawList& list) :
+    wxGraphicsContext(GetRecordingRenderer()), mList(list)
+{
+ mMatrix = renderer.GetTransform();
+ m_antialias = renderer.GetAntialiasMode();
+ m_interpolation = renderer.GetInterpolationQuality();
+ m_composition = wxCOMPOSITION_OVER;
+ renderer.GetSize(&mSize[0], &mSize[1]);
+
+ // A renderer has no clip to start with, so the clip box is
+ // the drawing area in user coordinates
+ DrawList::Matrix inverse = mMatrix;
+ if (inverse.Invert())
+ {
+  double corners[4][2] = {{0, 0}, {mSize[0], 0}, {mSize[0], mSize[1]}, {0, mSize[1]}};
+  double left = 0, top = 0, right = 0, bottom = 0;
+  for (int i = 0; i < 4; i++)
+  {
+   inverse.Apply(corners[i][0], corners[i][1]);
+   left = i == 0 ? corners[i][0] : std::min(left, corners[i][0]);
+   top = i == 0 ? corners[i][1] : std::min(top, corners[i][1]);
+   right = i == 0 ? corners[i][0] : std::max(right, corners[i][0]);
+   bottom = i == 0 ? corners[i][1] : std::max(bottom, corners[i][1]);
+  }
+  mClipBox[0] = left;
+  mClipBox[1] = top;
+  mClipBox[2] = right - left;
+  mClipBox[3] = bottom - top;
+ }
+}
+
+/**
+ * Get the renderer that makes the objects a DrawRecorder records
+ * @return Recording renderer
+ */
+wxGraphicsRenderer* DrawRecorder::GetRecordingRenderer()
+{
+ static RecordingRenderer renderer;
+ return &renderer;
+}
+
+/**
+ * Get the entry to record for a path
+ * @param path Path from any renderer
+ * @return Entry for the path
+ */
+DrawList::PathEntry DrawRecorder::GetPathEntry(const wxGraphicsPath& path) const
+{
+ if (path.GetRenderer() == GetRecordingRenderer())
+ {
+  return {static_cast<const RecordedPathData*>(path.GetGraphicsData())->Share(), wxGraphicsPath()};
+ }
+
+ return {nullptr, path};
+}
+
+/**
+ * Save the transform and clip
+ */
+void DrawRecorder::PushState()
+{
+ mStates.push_back(mMatrix);
+ mList.Add(DrawList::Type::PushState);
+}
+
+/**
+ * Restore the transform and clip
+ */
+void DrawRecorder::PopState()
+{
+ if (!mStates.empty())
+ {
+  mMatrix = mStates.back();
+  mStates.pop_back();
+ }
+
+ mList.Add(DrawList::Type::PopState);
+}
+
+/**
+ * Clip to a region
+ * @param region Region in the current coordinates
+ */
+void DrawRecorder::Clip(const wxRegion& region)
+{
+ mList.AddClip(region);
+}
+
+/**
+ * Clip to a rectangle
+ * @param x Left edge
+ * @param y Top edge
+ * @param w Width
+ * @param h Height
+ */
+void DrawRecorder::Clip(wxDouble x, wxDouble y, wxDouble w, wxDouble h)
+{
+ mList.Add(DrawList::Type::ClipRect, {x, y, w, h});
+}
+
+/**
+ * Remove the clip
+ */
+void DrawRecorder::ResetClip()
+{
+ mList.Add(DrawList::Type::ResetClip);
+}
+
+/**
+ * Get the clip box of the graphics context recorded for. Clips
+ * made while recording are not applied until replay.
+ * @param x Receives the left edge
+ * @param y Receives the top edge
+ * @param w Receives the width
+ * @param h Receives the height
+ */
+void DrawRecorder::GetClipBox(wxDouble* x, wxDouble* y, wxDouble* w, wxDouble* h)
+{
+ if (x) *x = mClipBox[0];
+ if (y) *y = mClipBox[1];
+ if (w) *w = mClipBox[2];
+ if (h) *h = mClipBox[3];
+}
+
+/**
+ * Get the native context, which for a recorder is the list
+ * @return Pointer to the DrawList
+ */
+void* DrawRecorder::GetNativeContext()
+{
+ return &mList;
+}
+
+/**
+ * Set the antialiasing mode
+ * @param antialias Mode
+ * @return true
+ */
+bool DrawRecorder::SetAntialiasMode(wxAntialiasMode antialias)
+{
+ m_antialias = antialias;
+ mList.Add(DrawList::Type::Antialias, {(double)antialias});
+ return true;
+}
+
+/**
+ * Set the interpolation quality for bitmaps
+ * @param interpolation Quality
+ * @return true
+ */
+bool DrawRecorder::SetInterpolationQuality(wxInterpolationQuality interpolation)
+{
+ m_interpolation = interpolation;
+ mList.Add(DrawList::Type::Interpolation, {(double)interpolation});
+ return true;
+}
+
+/**
+ * Set the composition mode
+ * @param op Mode
+ * @return true
+ */
+bool DrawRecorder::SetCompositionMode(wxCompositionMode op)
+{
+ m_composition = op;
+ mList.Add(DrawList::Type::Composition, {(double)op});
+ return true;
+}
+
+/**
+ * Begin a layer that is drawn with an opacity when it ends
+ * @param opacity Opacity from 0 to 1
+ */
+void DrawRecorder::BeginLayer(wxDouble opacity)
+{
+ mList.Add(DrawList::Type::BeginLayer, {opacity});
+}
+
+/**
+ * End the layer begun by BeginLayer
+ */
+void DrawRecorder::EndLayer()
+{
+ mList.Add(DrawList::Type::EndLayer);
+}
+
+/**
+ * Translate the coordinates
+ * @param dx Translation in x
+ * @param dy Translation in y
+ */
+void DrawRecorder::Translate(wxDouble dx, wxDouble dy)
+{
+ mMatrix.Translate(dx, dy);
+ mList.Add(DrawList::Type::Translate, {dx, dy});
+}
+
+/**
+ * Scale the coordinates
+ * @param xScale Scale in x
+ * @param yScale Scale in y
+ */
+void DrawRecorder::Scale(wxDouble xScale, wxDouble yScale)
+{
+ mMatrix.Scale(xScale, yScale);
+ mList.Add(DrawList::Type::Scale, {xScale, yScale});
+}
+
+/**
+ * Rotate the coordinates
+ * @param angle Angle in radians
+ */
+void DrawRecorder::Rotate(wxDouble angle)
+{
+ mMatrix.Rotate(angle);
+ mList.Add(DrawList::Type::Rotate, {angle});
+}
+
+/**
+ * Apply a transform to the coordinates
+ * @param matrix Transform from any renderer
+ */
+void DrawRecorder::ConcatTransform(const wxGraphicsMatrix& matrix)
+{
+ auto m = ToMatrix(matrix.GetMatrixData());
+ mMatrix.Concat(m);
+ mList.Add(DrawList::Type::Concat, {m.mA, m.mB, m.mC, m.mD, m.mTx, m.mTy});
+}
+
+/**
+ * Replace the transform
+ * @param matrix Transform from any renderer
+ */
+void DrawRecorder::SetTransform(const wxGraphicsMatrix& matrix)
+{
+ mMatrix = ToMatrix(matrix.GetMatrixData());
+ mList.Add(DrawList::Type::SetTransform, {mMatrix.mA, mMatrix.mB, mMatrix.mC, mMatrix.mD, mMatrix.mTx, mMatrix.mTy});
+}
+
+/**
+ * Get the current transform
+ * @return Transform
+ */
+wxGraphicsMatrix DrawRecorder::GetTransform() const
+{
+ return GetRecordingRenderer()->CreateMatrix(mMatrix.mA, mMatrix.mB, mMatrix.mC, mMatrix.mD, mMatrix.mTx, mMatrix.mTy);
+}
+
+/**
+ * Set the pen for strokes
+ * @param pen Pen from any renderer, or null for none
+ */
+void DrawRecorder::SetPen(const wxGraphicsPen& pen)
+{
+ wxGraphicsContext::SetPen(pen);
+
+ DrawList::PenEntry entry;
+ if (pen.GetRenderer() == GetRecordingRenderer())
+ {
+  entry.mInfo = static_cast<const RecordedPenData*>(pen.GetGraphicsData())->mInfo;
+  entry.mNull = false;
+ }
+ else if (!pen.IsNull())
+ {
+  entry.mForeign = pen;
+ }
+
+ mList.AddPen(entry);
+}
+
+/**
+ * Set the brush for fills
+ * @param brush Brush from any renderer, or null for none
+ */
+void DrawRecorder::SetBrush(const wxGraphicsBrush& brush)
+{
+ wxGraphicsContext::SetBrush(brush);
+
+ DrawList::BrushEntry entry;
+ if (brush.GetRenderer() == GetRecordingRenderer())
+ {
+  entry.mBrush = static_cast<const RecordedBrushData*>(brush.GetGraphicsData())->mBrush;
+ }
+ else if (!brush.IsNull())
+ {
+  entry.mForeign = brush;
+ }
+
+ mList.AddBrush(entry);
+}
+
+/**
+ * Stroke a path with the current pen
+ * @param path Path from any renderer
+ */
+void DrawRecorder::StrokePath(const wxGraphicsPath& path)
+{
+ if (!path.IsNull())
+ {
+  mList.AddPath(DrawList::Type::Stroke, GetPathEntry(path));
+ }
+}
+
+/**
+ * Fill a path with the current brush
+ * @param path Path from any renderer
+ * @param fillStyle Fill rule
+ */
+void DrawRecorder::FillPath(const wxGraphicsPath& path, wxPolygonFillMode fillStyle)
+{
+ if (!path.IsNull())
+ {
+  mList.AddPath(DrawList::Type::Fill, GetPathEntry(path), fillStyle);
+ }
+}
+
+/**
+ * Fill a path with the current brush and stroke it with the current pen
+ * @param path Path from any renderer
+ * @param fillStyle Fill rule
+ */
+void DrawRecorder::DrawPath(const wxGraphicsPath& path, wxPolygonFillMode fillStyle)
+{
+ if (!path.IsNull())
+ {
+  mList.AddPath(DrawList::Type::Draw, GetPathEntry(path), fillStyle);
+ }
+}
+
+/**
+ * Draw a bitmap
+ * @param bmp Bitmap from any renderer
+ * @param x Left edge
+ * @param y Top edge
+ * @param w Width
+ * @param h Height
+ */
+void DrawRecorder::DrawBitmap(const wxGraphicsBitmap& bmp, wxDouble x, wxDouble y, wxDouble w, wxDouble h)
+{
+ if (bmp.IsNull())
+ {
+  return;
+ }
+
+ DrawList::BitmapEntry entry;
+ if (bmp.GetRenderer() == GetRecordingRenderer())
+ {
+  entry.mBitmap = static_cast<const RecordedBitmapData*>(bmp.GetGraphicsData())->mBitmap;
+ }
+ else
+ {
+  entry.mForeign = bmp;
+ }
+
+ mList.AddBitmap(entry, x, y, w, h);
+}
+
+/**
+ * Draw a bitmap
+ * @param bmp Bitmap
+ * @param x Left edge
+ * @param y Top edge
+ * @param w Width
+ * @param h Height
+ */
+void DrawRecorder::DrawBitmap(const wxBitmap& bmp, wxDouble x, wxDouble y, wxDouble w, wxDouble h)
+{
+ DrawBitmap(GetRecordingRenderer()->CreateBitmap(bmp), x, y, w, h);
+}
+
+/**
+ * Draw an icon
+ * @param icon Icon
+ * @param x Left edge
+ * @param y Top edge
+ * @param w Width
+ * @param h Height
+ */
+void DrawRecorder::DrawIcon(const wxIcon& icon, wxDouble x, wxDouble y, wxDouble w, wxDouble h)
+{
+ wxBitmap bitmap;
+ bitmap.CopyFromIcon(icon);
+ DrawBitmap(bitmap, x, y, w, h);
+}
+
+/**
+ * Record drawing text in the current font
+ * @param str Text
+ * @param x Left edge
+ * @param y Top edge
+ */
+void DrawRecorder::DoDrawText(const wxString& str, wxDouble x, wxDouble y)
+{
+ mList.AddText({str, m_font}, x, y);
+}
+
+/**
+ * Measure text in the current font
+ * @param text Text to measure
+ * @param width Receives the width
+ * @param height Receives the height
+ * @param descent Receives the descent
+ * @param externalLeading Receives the external leading
+ */
+void DrawRecorder::GetTextExtent(const wxString& text, wxDouble* width, wxDouble* height,
+        wxDouble* descent, wxDouble* externalLeading) const
+{
+ // Fonts are made by the default renderer, so it measures them
+ std::unique_ptr<wxGraphicsContext> measure(wxGraphicsRenderer::GetDefaultRenderer()->CreateMeasuringContext());
+ measure->SetFont(m_font);
+ measure->GetTextExtent(text, width, height, descent, externalLeading);
+}
+
+/**
+ * Measure the width of each prefix of some text in the current font
+ * @param text Text to measure
+ * @param widths Receives the widths
+ */
+void DrawRecorder::GetPartialTextExtents(const wxString& text, wxArrayDouble& widths) const
+{
+ std::unique_ptr<wxGraphicsContext> measure(wxGraphicsRenderer::GetDefaultRenderer()->CreateMeasuringContext());
+ measure->SetFont(m_font);
+ measure->GetPartialTextExtents(text, widths);
+}
+
+/**
+ * Get the size of the graphics context recorded for
+ * @param width Receives the width
+ * @param height Receives the height
+ */
+void DrawRecorder::GetSize(wxDouble* width, wxDouble* height) const
+{
+ if (width) *width = mSize[0];
+ if (height) *height = mSize[1];
+}
+
+#ifdef __WXMSW__
+/**
+ * A recorder has no device context
+ * @return nullptr
+ */
+WXHDC DrawRecorder::GetNativeHDC()
+{
+ return nullptr;
+}
+
+/**
+ * A recorder has no device context
+ * @param hdc Ignored
+ */
+void DrawRecorder::ReleaseNativeHDC(WXHDC hdc)
+{
+}
+#endif
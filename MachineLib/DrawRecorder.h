@@ -0,0 +1,104 @@
+/**
+ * @file DrawRecorder.h
+ * @author Thomas Conley
+ *
+ * Graphics context that records into a DrawList.
+ */
+
+#ifndef DRAWRECORDER_H
+#define DRAWRECORDER_H
+
+#include "DrawList.h"
+
+class IRenderer;
+
+/**
+ * Graphics context that records into a DrawList.
+ *
+ * Components draw on it as on any graphics context. Nothing is
+ * drawn; each call becomes a command in the list, to be optimized
+ * and replayed on the graphics context or renderer the recorder was
+ * made for. The recorder starts with the transform, modes and size
+ * of that target, so components that ask for them get the right answers.
+ *
+ * Paths, pens, brushes and bitmaps made on the recorder can only be
+ * drawn through a DrawList. Fonts and gradient brushes are made by
+ * the default renderer and are replayed as they are.
+ */
+class DrawRecorder : public wxGraphicsContext {
+private:
+ /// List the commands are recorded into
+ DrawList& mList;
+
+ /// Current transform
+ DrawList::Matrix mMatrix;
+
+ /// Transforms saved by PushState
+ std::vector<DrawList::Matrix> mStates;
+
+ /// Size of the graphics context recorded for
+ double mSize[2] = {0, 0};
+
+ /// Clip box of the graphics context recorded for
+ double mClipBox[4] = {0, 0, 0, 0};
+
+ DrawList::PathEntry GetPathEntry(const wxGraphicsPath& path) const;
+
+protected:
+ void DoDrawText(const wxString& str, wxDouble x, wxDouble y) override;
+
+public:
+ DrawRecorder(std::shared_ptr<wxGraphicsContext> graphics, DrawList& list);
+ DrawRecorder(IRenderer& renderer, DrawList& list);
+
+ /// Copy constructor (disabled)
+ DrawRecorder(const DrawRecorder &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const DrawRecorder &) = delete;
+
+ static wxGraphicsRenderer* GetRecordingRenderer();
+
+ using wxGraphicsContext::SetPen;
+ using wxGraphicsContext::SetBrush;
+
+ void PushState() override;
+ void PopState() override;
+ void Clip(const wxRegion& region) override;
+ void Clip(wxDouble x, wxDouble y, wxDouble w, wxDouble h) override;
+ void ResetClip() override;
+ void GetClipBox(wxDouble* x, wxDouble* y, wxDouble* w, wxDouble* h) override;
+ void* GetNativeContext() override;
+ bool SetAntialiasMode(wxAntialiasMode antialias) override;
+ bool SetInterpolationQuality(wxInterpolationQuality interpolation) override;
+ bool SetCompositionMode(wxCompositionMode op) override;
+ void BeginLayer(wxDouble opacity) override;
+ void EndLayer() override;
+ void Translate(wxDouble dx, wxDouble dy) override;
+ void Scale(wxDouble xScale, wxDouble yScale) override;
+ void Rotate(wxDouble angle) override;
+ void ConcatTransform(const wxGraphicsMatrix& matrix) override;
+ void SetTransform(const wxGraphicsMatrix& matrix) override;
+ wxGraphicsMatrix GetTransform() const override;
+ void SetPen(const wxGraphicsPen& pen) override;
+ void SetBrush(const wxGraphicsBrush& brush) override;
+ void StrokePath(const wxGraphicsPath& path) override;
+ void FillPath(const wxGraphicsPath& path, wxPolygonFillMode fillStyle = wxODDEVEN_RULE) override;
+ void DrawPath(const wxGraphicsPath& path, wxPolygonFillMode fillStyle = wxODDEVEN_RULE) override;
+ void DrawBitmap(const wxGraphicsBitmap& bmp, wxDouble x, wxDouble y, wxDouble w, wxDouble h) override;
+ void DrawBitmap(const wxBitmap& bmp, wxDouble x, wxDouble y, wxDouble w, wxDouble h) override;
+ void DrawIcon(const wxIcon& icon, wxDouble x, wxDouble y, wxDouble w, wxDouble h) override;
+ void GetTextExtent(const wxString& text, wxDouble* width, wxDouble* height,
+         wxDouble* descent = nullptr, wxDouble* externalLeading = nullptr) const override;
+ void GetPartialTextExtents(const wxString& text, wxArrayDouble& widths) const override;
+ void GetSize(wxDouble* width, wxDouble* height) const override;
+
+#ifdef __WXMSW__
+ WXHDC GetNativeHDC() override;
+ void ReleaseNativeHDC(WXHDC hdc) override;
+#endif
+};
+
+
+
+#endif //DRAWRECORDER_H
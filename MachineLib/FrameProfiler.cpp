@@ -0,0 +1,212 @@
+/**
+ * @file FrameProfiler.cpp
+ * @author Thomas Conley
+ */
+
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Record a duration, overwriting the oldest once the ring is full
+ * @param seconds Duration in seconds
+ */
+void FrameProfiler::Ring::Record(double seconds)
+{
+ size_t count = mCount.load(std::memory_order_relaxed);
+ mSamples[count % Capacity].store(seconds, std::memory_order_relaxed);
+ mCount.store(count + 1, std::memory_order_release);
+}
+
+/**
+ * Copy the recorded durations
+ * @return Up to Capacity of the most recent durations
+ */
+std::vector<double> FrameProfiler::Ring::Snapshot() const
+{
+ size_t count = std::min(mCount.load(std::memory_order_acquire), Capacity);
+ std::vector<double> samples(count);
+ for (size_t i = 0; i < count; i++)
+ {
+  samples[i] = mSamples[i].load(std::memory_order_relaxed);
+ }
+ return samples;
+}
+
+/**
+ * Forget every duration
+ */
+void FrameProfiler::Ring::Clear()
+{
+ mCount.store(0, std::memory_order_release);
+}
+
+/**
+ * Start timing a component
+ * @param name Name of the component
+ * @return Index to record the component's timings with
+ */
+int FrameProfiler::AddComponent(const std::wstring& name)
+{
+ mEntries.push_back(std::make_unique<Entry>());
+ mEntries.back()->mName = name;
+ return (int)mEntries.size() - 1;
+}
+
+/**
+ * Record how long a component took
+ * @param component Index from AddComponent
+ * @param phase What was timed
+ * @param seconds Duration in seconds
+ */
+void FrameProfiler::Record(int component, Phase phase, double seconds)
+{
+ GetRing(component, phase).Record(seconds);
+}
+
+/**
+ * Record how long part of drawing the whole frame took
+ * @param phase What was timed
+ * @param seconds Duration in seconds
+ */
+void FrameProfiler::RecordFrame(FramePhase phase, double seconds)
+{
+ GetRing(phase).Record(seconds);
+}
+
+/**
+ * Get the durations of one phase of a component
+ * @param component Index from AddComponent
+ * @param phase Which durations
+ * @return Ring of durations
+ */
+FrameProfiler::Ring& FrameProfiler::GetRing(int component, Phase phase)
+{
+ auto& entry = *mEntries[component];
+ return phase == Phase::Advance ? entry.mAdvance : entry.mDraw;
+}
+
+/**
+ * Get the durations of one phase of the whole frame
+ * @param phase Which durations
+ * @return Ring of durations
+ */
+FrameProfiler::Ring& FrameProfiler::GetRing(FramePhase phase)
+{
+ return phase == FramePhase::Optimize ? mOptimize : mReplay;
+}
+
+/**
+ * Summarize the recent timings of a component
+ * @param component Index from AddComponent
+ * @param phase Which timings to summarize
+ * @return Statistics, all zero if nothing was recorded
+ */
+FrameProfiler::Stats FrameProfiler::GetStats(int component, Phase phase) const
+{
+ const auto& entry = *mEntries[component];
+ return Summarize(entry.mName, (phase == Phase::Advance ? entry.mAdvance : entry.mDraw).Snapshot());
+}
+
+/**
+ * Summarize the recent timings of part of drawing the whole frame
+ * @param phase Which timings to summarize
+ * @return Statistics, all zero if nothing was recorded
+ */
+FrameProfiler::Stats FrameProfiler::GetFrameStats(FramePhase phase) const
+{
+ return phase == FramePhase::Optimize ? Summarize(L"optimize", mOptimize.Snapshot()) :
+                                        Summarize(L"replay", mReplay.Snapshot());
+}
+
+/**
+ * Compute the statistics of a set of durations
+ * @param name Name to give the statistics
+ * @param samples Durations in seconds
+ * @return Statistics, all zero if there are no durations
+ */
+FrameProfiler::Stats FrameProfiler::Summarize(const std::wstring& name, std::vector<double> samples)
+{
+ Stats stats;
+ stats.mName = name;
+ stats.mCount = samples.size();
+ if (samples.empty())
+ {
+  return stats;
+ }
+
+ std::sort(samples.begin(), samples.end());
+
+ double total = 0;
+ for (auto sample : samples)
+ {
+  total += sample;
+ }
+
+ // Nearest rank percentiles
+ auto percentile = [&samples](double p) {
+  size_t rank = (size_t)std::ceil(p * samples.size());
+  return samples[rank > 0 ? rank - 1 : 0];
+ };
+
+ stats.mMean = total / samples.size();
+ stats.mP95 = percentile(0.95);
+ stats.mP99 = percentile(0.99);
+ stats.mMax = samples.back();
+ return stats;
+}
+
+/**
+ * Summarize the recent timings of every component
+ * @param phase Which timings to summarize
+ * @return Statistics in the order the components were added
+ */
+std::vector<FrameProfiler::Stats> FrameProfiler::GetStats(Phase phase) const
+{
+ std::vector<Stats> stats;
+ for (size_t i = 0; i < mEntries.size(); i++)
+ {
+  stats.push_back(GetStats((int)i, phase));
+ }
+
+ return stats;
+}
+
+/**
+ * Record how many graphics context calls the last frame took
+ * @param recorded Calls the components made
+ * @param replayed Calls made to the graphics context after optimizing
+ */
+void FrameProfiler::RecordDrawCalls(size_t recorded, size_t replayed)
+{
+ mRecordedCalls.store(recorded, std::memory_order_relaxed);
+ mReplayedCalls.store(replayed, std::memory_order_relaxed);
+}
+
+/**
+ * Get how many graphics context calls the last frame took
+ * @return Calls before and after optimizing
+ */
+FrameProfiler::DrawCalls FrameProfiler::GetDrawCalls() const
+{
+ DrawCalls calls;
+ calls.mRecorded = mRecordedCalls.load(std::memory_order_relaxed);
+ calls.mReplayed = mReplayedCalls.load(std::memory_order_relaxed);
+ return calls;
+}
+
+/**
+ * Forget every recorded timing. The components stay registered.
+ */
+void FrameProfiler::Clear()
+{
+ for (auto& entry : mEntries)
+ {
+  entry->mAdvance.Clear();
+  entry->mDraw.Clear();
+ }
+
+ mOptimize.Clear();
+ mReplay.Clear();
+ RecordDrawCalls(0, 0);
+}
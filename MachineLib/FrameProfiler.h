@@ -0,0 +1,190 @@
+/**
+ * @file FrameProfiler.h
+ * @author Thomas Conley
+ *
+ * Per-component advance and draw timings, and whole-frame
+ * draw list timings.
+ */
+ 
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Per-component advance and draw timings, and whole-frame
+ * draw list timings.
+ *
+ * Each component has a ring buffer of its most recent advance
+ * durations and another of its draw durations. Components draw
+ * into a draw list, so their draw durations measure recording
+ * only; optimizing the list and replaying it on the renderer are
+ * timed for the frame as a whole. One thread records
+ * while any thread reads statistics. Recording never locks: each
+ * sample is an atomic stored with relaxed ordering, then the count
+ * is published. A reader racing the writer may see a newer sample
+ * in place of an older one, which only blurs the statistics.
+ */
+class FrameProfiler {
+public:
+ /// What a timing of a component measures
+ enum class Phase {Advance, Draw};
+
+ /// What a timing of the whole frame measures
+ enum class FramePhase {Optimize, Replay};
+
+ /// Summary of the recent timings of one phase of one component
+ struct Stats {
+  /// Name of the component
+  std::wstring mName;
+
+  /// Number of samples summarized
+  size_t mCount = 0;
+
+  /// Mean duration in seconds
+  double mMean = 0;
+
+  /// 95th percentile duration in seconds
+  double mP95 = 0;
+
+  /// 99th percentile duration in seconds
+  double mP99 = 0;
+
+  /// Longest duration in seconds
+  double mMax = 0;
+ };
+
+ /// Graphics context calls made to draw the last frame
+ struct DrawCalls {
+  /// Calls the components made
+  size_t mRecorded = 0;
+
+  /// Calls left after redundant ones were removed and fills merged
+  size_t mReplayed = 0;
+ };
+
+ /// Number of samples kept for each phase of each component
+ static constexpr size_t Capacity = 512;
+
+private:
+ /// Ring buffer of durations
+ class Ring {
+ private:
+  /// Durations in seconds, atomic since they are read while recorded
+  std::atomic<double> mSamples[Capacity] = {};
+
+  /// Total samples ever recorded
+  std::atomic<size_t> mCount{0};
+
+ public:
+  void Record(double seconds);
+  std::vector<double> Snapshot() const;
+  void Clear();
+ };
+
+ /// Timings for one component
+ struct Entry {
+  /// Name of the component
+  std::wstring mName;
+
+  /// Advance durations
+  Ring mAdvance;
+
+  /// Draw durations
+  Ring mDraw;
+ };
+
+ /// Timings for each component, in the order they were added
+ std::vector<std::unique_ptr<Entry>> mEntries;
+
+ /// Durations of optimizing each frame's draw list
+ Ring mOptimize;
+
+ /// Durations of replaying each frame's draw list
+ Ring mReplay;
+
+ /// Context calls the components made for the last frame
+ std::atomic<size_t> mRecordedCalls{0};
+
+ /// Context calls replayed for the last frame
+ std::atomic<size_t> mReplayedCalls{0};
+
+ Ring& GetRing(int component, Phase phase);
+ Ring& GetRing(FramePhase phase);
+ static Stats Summarize(const std::wstring& name, std::vector<double> samples);
+
+public:
+ FrameProfiler() = default;
+
+ /// Copy constructor (disabled)
+ FrameProfiler(const FrameProfiler &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const FrameProfiler &) = delete;
+
+ int AddComponent(const std::wstring& name);
+ void Record(int component, Phase phase, double seconds);
+ Stats GetStats(int component, Phase phase) const;
+ std::vector<Stats> GetStats(Phase phase) const;
+ void RecordFrame(FramePhase phase, double seconds);
+ Stats GetFrameStats(FramePhase phase) const;
+ void RecordDrawCalls(size_t recorded, size_t replayed);
+ DrawCalls GetDrawCalls() const;
+ void Clear();
+
+ /// Get the number of components being timed
+ /// @return Component count
+ size_t GetComponentCount() const {return mEntries.size();}
+
+ /// Times the rest of the enclosing scope and records it
+ class Scope {
+ private:
+  /// Ring to record to
+  Ring& mRing;
+
+  /// When the scope was entered
+  std::chrono::steady_clock::time_point mStart;
+
+ public:
+  /// Constructor
+  /// @param profiler Profiler to record to
+  /// @param component Index from AddComponent
+  /// @param phase What is being timed
+  Scope(FrameProfiler& profiler, int component, Phase phase) :
+      mRing(profiler.GetRing(component, phase)), mStart(std::chrono::steady_clock::now()) {}
+
+  /// Constructor
+  /// @param profiler Profiler to record to
+  /// @param phase What part of the frame is being timed
+  Scope(FrameProfiler& profiler, FramePhase phase) :
+      mRing(profiler.GetRing(phase)), mStart(std::chrono::steady_clock::now()) {}
+
+  /// Destructor, records the time since the constructor
+  ~Scope()
+  {
+   std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mStart;
+   mRing.Record(elapsed.count());
+  }
+ };
+};
+
+/// Time the rest of the scope when profiling is compiled in
+/// with MACHINE_PROFILING, otherwise nothing.
+#ifdef MACHINE_PROFILING
+#define PROFILE_SCOPE(profiler, component, phase) \
+    FrameProfiler::Scope profileScope(profiler, component, FrameProfiler::Phase::phase)
+#define PROFILE_FRAME_SCOPE(profiler, phase) \
+    FrameProfiler::Scope profileScope(profiler, FrameProfiler::FramePhase::phase)
+#else
+#define PROFILE_SCOPE(profiler, component, phase)
+#define PROFILE_FRAME_SCOPE(profiler, phase)
+#endif
+
+
+
+#endif //FRAMEPROFILER_H
@@ -0,0 +1,107 @@
+/**
+ * @file FrameRenderer.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "FrameRenderer.h"
+#include "IMachineSystem.h"
+#include "MachineSystem.h"
+#include "SoftwareRenderer.h"
+#include <cstring>
+#include <vector>
+
+/// Space below the machine in machine pixels
+const int MachineBottomMargin = 50;
+
+/**
+ * Constructor
+ * @param width Width of a frame in pixels
+ * @param height Height of a frame in pixels
+ */
+FrameRenderer::FrameRenderer(int width, int height) : mWidth(width), mHeight(height)
+{
+}
+
+/**
+ * Render the current frame of a machine
+ * @param machine Machine already set to the frame to render
+ * @return Image of the frame with an alpha channel
+ */
+wxImage FrameRenderer::Render(IMachineSystem* machine)
+{
+ machine->SetLocation(wxPoint(int(mWidth / 2 / mScale),
+                              int(mHeight / mScale) - MachineBottomMargin));
+
+ // Only a MachineSystem can draw on something other than a graphics context
+ auto system = mSoftware ? dynamic_cast<MachineSystem*>(machine) : nullptr;
+ if (system != nullptr)
+ {
+  SoftwareRenderer renderer(mWidth, mHeight);
+  renderer.Clear(wxColour(mBackground.Red(), mBackground.Green(), mBackground.Blue()));
+  renderer.Scale(mScale, mScale);
+  system->DrawMachine(renderer);
+  return renderer.ToImage();
+ }
+
+ wxImage image(mWidth, mHeight, false);
+ image.SetRGB(wxRect(0, 0, mWidth, mHeight),
+              mBackground.Red(), mBackground.Green(), mBackground.Blue());
+ image.InitAlpha();
+ memset(image.GetAlpha(), wxALPHA_OPAQUE, (size_t)mWidth * mHeight);
+
+ {
+  // The image is only updated when the context is destroyed
+  std::shared_ptr<wxGraphicsContext> graphics(wxGraphicsContext::Create(image));
+  graphics->Scale(mScale, mScale);
+  machine->DrawMachine(graphics);
+ }
+
+ return image;
+}
+
+/**
+ * Write a frame to a PNG file
+ * @param image Frame to write
+ * @param filename File to write to
+ * @return true if successful
+ */
+bool FrameRenderer::WritePng(const wxImage& image, const wxString& filename)
+{
+ return image.SaveFile(filename, wxBITMAP_TYPE_PNG);
+}
+
+/**
+ * Write a frame as raw 8 bit RGBA pixels, row by row from the top.
+ * This is the rawvideo rgba format video encoders read.
+ * @param image Frame to write
+ * @param file File to write to
+ * @return true if successful
+ */
+bool FrameRenderer::WriteRgba(const wxImage& image, FILE* file)
+{
+ int width = image.GetWidth();
+ int height = image.GetHeight();
+ const unsigned char* rgb = image.GetData();
+ const unsigned char* alpha = image.GetAlpha();
+
+ std::vector<unsigned char> row((size_t)width * 4);
+ for (int y = 0; y < height; y++)
+ {
+  for (int x = 0; x < width; x++)
+  {
+   auto pixel = &row[(size_t)x * 4];
+   pixel[0] = *rgb++;
+   pixel[1] = *rgb++;
+   pixel[2] = *rgb++;
+   pixel[3] = alpha != nullptr ? *alpha++ : wxALPHA_OPAQUE;
+  }
+
+  if (fwrite(row.data(), 1, row.size(), file) != row.size())
+  {
+   return false;
+  }
+ }
+
+ return true;
+}
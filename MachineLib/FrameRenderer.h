@@ -0,0 +1,71 @@
+/**
+ * @file FrameRenderer.h
+ * @author Thomas Conley
+ *
+ * Renders machine frames to offscreen images.
+ */
+ 
+#ifndef FRAMERENDERER_H
+#define FRAMERENDERER_H
+
+#include <cstdio>
+
+class IMachineSystem;
+
+/**
+ * Renders machine frames to offscreen images.
+ *
+ * Each frame is drawn into a wxImage through a graphics context,
+ * so no window is needed, or by a SoftwareRenderer, which needs no
+ * wxWidgets drawing at all. The machine is centered horizontally
+ * and sits on the bottom of the frame.
+ */
+class FrameRenderer {
+private:
+ /// Width of a frame in pixels
+ int mWidth;
+
+ /// Height of a frame in pixels
+ int mHeight;
+
+ /// Scale from machine pixels to frame pixels
+ double mScale = 1;
+
+ /// Colour behind the machine
+ wxColour mBackground = wxColour(0, 220, 255);
+
+ /// Draw with the software renderer instead of a graphics context
+ bool mSoftware = false;
+
+public:
+ FrameRenderer(int width, int height);
+
+ wxImage Render(IMachineSystem* machine);
+
+ static bool WritePng(const wxImage& image, const wxString& filename);
+ static bool WriteRgba(const wxImage& image, FILE* file);
+
+ /// Set the scale from machine pixels to frame pixels
+ /// @param scale Scale, 1 draws the machine at its natural size
+ void SetScale(double scale) {mScale = scale;}
+
+ /// Set the colour behind the machine
+ /// @param colour Background colour
+ void SetBackground(const wxColour& colour) {mBackground = colour;}
+
+ /// Choose whether to draw with the software renderer
+ /// @param software true for the software renderer, false for a graphics context
+ void SetSoftware(bool software) {mSoftware = software;}
+
+ /// Get the width of a frame
+ /// @return Width in pixels
+ int GetWidth() const {return mWidth;}
+
+ /// Get the height of a frame
+ /// @return Height in pixels
+ int GetHeight() const {return mHeight;}
+};
+
+
+
+#endif //FRAMERENDERER_H
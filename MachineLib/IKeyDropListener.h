@@ -18,9 +18,9 @@ public:
 
  /**
   * This method will be called when the key drops
-  * @param keyY
+  * @param time Machine time the key dropped in seconds
   */
- virtual void KeyDroppedTriggered(double keyY) = 0;
+ virtual void KeyDroppedTriggered(double time) = 0;
 
 };
 
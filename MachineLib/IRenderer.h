@@ -0,0 +1,150 @@
+/**
+ * @file IRenderer.h
+ * @author Thomas Conley
+ *
+ * Interface for backends that draw a DrawList.
+ */
+
+#ifndef IRENDERER_H
+#define IRENDERER_H
+
+#include "DrawList.h"
+
+/**
+ * Interface for backends that draw a DrawList.
+ *
+ * Components draw on a DrawRecorder, and the optimized list is
+ * replayed on a renderer one command at a time. WxRenderer passes
+ * the commands on to a wxGraphicsContext, SoftwareRenderer draws
+ * them into its own pixel buffer.
+ */
+class IRenderer {
+public:
+ virtual ~IRenderer() = default;
+
+ /// Get the current transform
+ /// @return Transform from user to device coordinates
+ virtual DrawList::Matrix GetTransform() const = 0;
+
+ /// Get the size of the drawing area
+ /// @param width Receives the width in pixels
+ /// @param height Receives the height in pixels
+ virtual void GetSize(double* width, double* height) const = 0;
+
+ /// Get the current antialiasing mode
+ /// @return Antialiasing mode
+ virtual wxAntialiasMode GetAntialiasMode() const = 0;
+
+ /// Get the current interpolation quality
+ /// @return Interpolation quality
+ virtual wxInterpolationQuality GetInterpolationQuality() const = 0;
+
+ /**
+  * Make a renderer of the same kind that draws into an image.
+  * The image holds the drawing once that renderer is destroyed.
+  * @param image Image to draw into, the size of the drawing area
+  * @return New renderer
+  */
+ virtual std::unique_ptr<IRenderer> CreateImageRenderer(wxImage& image) = 0;
+
+ /// Save the transform, clip and modes
+ virtual void PushState() = 0;
+
+ /// Restore what the last PushState saved
+ virtual void PopState() = 0;
+
+ /// Translate the transform
+ /// @param dx X offset
+ /// @param dy Y offset
+ virtual void Translate(double dx, double dy) = 0;
+
+ /// Scale the transform
+ /// @param xScale X scale
+ /// @param yScale Y scale
+ virtual void Scale(double xScale, double yScale) = 0;
+
+ /// Rotate the transform
+ /// @param angle Angle in radians
+ virtual void Rotate(double angle) = 0;
+
+ /// Apply a matrix before the current transform
+ /// @param matrix Matrix to apply
+ virtual void ConcatTransform(const DrawList::Matrix& matrix) = 0;
+
+ /// Replace the current transform
+ /// @param matrix New transform
+ virtual void SetTransform(const DrawList::Matrix& matrix) = 0;
+
+ /// Limit drawing to a region as well as the current clip
+ /// @param region Region in user coordinates
+ virtual void Clip(const wxRegion& region) = 0;
+
+ /// Limit drawing to a rectangle as well as the current clip
+ /// @param x Left of the rectangle
+ /// @param y Top of the rectangle
+ /// @param w Width of the rectangle
+ /// @param h Height of the rectangle
+ virtual void Clip(double x, double y, double w, double h) = 0;
+
+ /// Remove the clip
+ virtual void ResetClip() = 0;
+
+ /// Set the brush fills use
+ /// @param brush Brush entry of the list
+ virtual void SetBrush(const DrawList::BrushEntry& brush) = 0;
+
+ /// Set the pen strokes use
+ /// @param pen Pen entry of the list
+ virtual void SetPen(const DrawList::PenEntry& pen) = 0;
+
+ /// Set the antialiasing mode
+ /// @param antialias New mode
+ virtual void SetAntialiasMode(wxAntialiasMode antialias) = 0;
+
+ /// Set the interpolation quality of bitmaps
+ /// @param interpolation New quality
+ virtual void SetInterpolationQuality(wxInterpolationQuality interpolation) = 0;
+
+ /// Set how drawing is combined with what is already there
+ /// @param op New composition mode
+ virtual void SetCompositionMode(wxCompositionMode op) = 0;
+
+ /// Fill a path with the brush
+ /// @param path Path entry of the list
+ /// @param fillStyle Fill rule
+ virtual void FillPath(const DrawList::PathEntry& path, wxPolygonFillMode fillStyle) = 0;
+
+ /// Stroke a path with the pen
+ /// @param path Path entry of the list
+ virtual void StrokePath(const DrawList::PathEntry& path) = 0;
+
+ /// Fill a path with the brush, then stroke it with the pen
+ /// @param path Path entry of the list
+ /// @param fillStyle Fill rule
+ virtual void DrawPath(const DrawList::PathEntry& path, wxPolygonFillMode fillStyle) = 0;
+
+ /// Draw a bitmap stretched to a rectangle
+ /// @param bitmap Bitmap entry of the list
+ /// @param x Left of the rectangle
+ /// @param y Top of the rectangle
+ /// @param w Width of the rectangle
+ /// @param h Height of the rectangle
+ virtual void DrawBitmap(const DrawList::BitmapEntry& bitmap, double x, double y, double w, double h) = 0;
+
+ /// Draw text
+ /// @param text Text entry of the list
+ /// @param x Left of the text
+ /// @param y Top of the text
+ virtual void DrawText(const DrawList::TextEntry& text, double x, double y) = 0;
+
+ /// Start drawing into a layer that is blended in by EndLayer
+ /// @param opacity Opacity of the layer, 0 to 1
+ virtual void BeginLayer(double opacity) = 0;
+
+ /// Blend the layer BeginLayer started onto what is below it
+ virtual void EndLayer() = 0;
+};
+
+
+
+#endif //IRENDERER_H
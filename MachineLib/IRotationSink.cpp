@@ -3,5 +3,4 @@
  * @author Thomas Conley
  */
 
-#include "pch.h"
 #include "IRotationSink.h"
@@ -8,6 +8,7 @@
 #ifndef IROTATIONSINK_H
 #define IROTATIONSINK_H
 
+class RotationSource;
 
 ///Interface for objects that need to respond to an rotation event.
 class IRotationSink {
@@ -20,6 +21,10 @@ public:
  /// @param rotation
  virtual void SetRotation(double rotation){}
 
+ /// Get the rotation source this sink turns in turn, if any
+ /// @return RotationSource or nullptr
+ virtual RotationSource* GetSource() {return nullptr;}
+
 
 };
 
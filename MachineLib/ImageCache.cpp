@@ -0,0 +1,294 @@
+/**
+ * @file ImageCache.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include <wx/filename.h>
+#include "ImageCache.h"
+
+namespace cse335
+{
+
+/**
+ * Get the process-wide image cache
+ * @return The image cache
+ */
+ImageCache &ImageCache::Get()
+{
+    static ImageCache cache;
+    return cache;
+}
+
+/**
+ * Convert a filename into the key used by the cache
+ * @param filename Image filename, possibly relative
+ * @return Absolute path with . and .. removed
+ */
+std::wstring ImageCache::CanonicalPath(const std::wstring &filename)
+{
+    wxFileName name(filename);
+    name.MakeAbsolute();
+    return name.GetFullPath().ToStdWstring();
+}
+
+/**
+ * Load an image through the cache.
+ *
+ * The file is decoded only the first time it is loaded. Decoding
+ * happens outside the lock so loads of different images on
+ * different threads do not wait on each other.
+ *
+ * @param filename Image filename
+ * @return Shared decoded image or nullptr if the file could not be loaded
+ */
+std::shared_ptr<const wxImage> ImageCache::Load(const std::wstring &filename)
+{
+    auto path = CanonicalPath(filename);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto found = mImages.find(path);
+        if(found != mImages.end())
+        {
+            mHits++;
+            return found->second;
+        }
+    }
+
+    // Prevent error popup from wxWidgets
+    wxLogNull logNo;
+
+    auto image = std::make_shared<wxImage>();
+    if(!image->LoadFile(path, wxBITMAP_TYPE_ANY))
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mMisses++;
+
+    // Another thread may have loaded it while we were decoding
+    auto inserted = mImages.emplace(path, image);
+    return inserted.first->second;
+}
+
+/**
+ * Get an image that can be kept and used on any thread.
+ *
+ * wxImage copies share their data through a reference count that is
+ * not thread safe, so an image from the cache is shared through the
+ * cache's own pointer and any other image is copied in full.
+ *
+ * @param image Image to keep
+ * @return The cached image if it is one, otherwise a deep copy
+ */
+std::shared_ptr<const wxImage> ImageCache::Share(const wxImage &image)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for(const auto &cached : mImages)
+    {
+        if(cached.second.get() == &image)
+        {
+            return cached.second;
+        }
+    }
+
+    return std::make_shared<const wxImage>(image.Copy());
+}
+
+/**
+ * Get a graphics bitmap for an image, creating it only if
+ * it has not already been created for this renderer on this thread.
+ * @param graphics Graphics context we are drawing on
+ * @param filename Filename the image was loaded from
+ * @param image Decoded image from Load
+ * @return Graphics bitmap for the image
+ */
+wxGraphicsBitmap ImageCache::GetBitmap(const std::shared_ptr<wxGraphicsContext> &graphics,
+                                       const std::wstring &filename, const wxImage &image)
+{
+    auto key = std::make_tuple(graphics->GetRenderer(), std::this_thread::get_id(), CanonicalPath(filename));
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto found = mBitmaps.find(key);
+        if(found != mBitmaps.end())
+        {
+            mBitmapHits++;
+            return found->second;
+        }
+    }
+
+    // Created outside the lock, since a recording context shares the
+    // image through this cache. Only this thread creates this key.
+    auto bitmap = graphics->CreateBitmapFromImage(image);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mBitmapMisses++;
+    mBitmaps[key] = bitmap;
+    return bitmap;
+}
+
+/**
+ * Remove an image and its graphics bitmaps from the cache.
+ *
+ * Polygons that already hold the image keep their copy.
+ *
+ * @param filename Image filename
+ */
+void ImageCache::Evict(const std::wstring &filename)
+{
+    auto path = CanonicalPath(filename);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mImages.erase(path);
+    EraseBitmaps(path);
+}
+
+/**
+ * Remove all images no polygon is currently using
+ */
+void ImageCache::EvictUnused()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for(auto i = mImages.begin(); i != mImages.end(); )
+    {
+        if(i->second.use_count() == 1)
+        {
+            EraseBitmaps(i->first);
+            i = mImages.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+/**
+ * Remove everything from the cache
+ */
+void ImageCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mImages.clear();
+    mBitmaps.clear();
+}
+
+/**
+ * Remove the graphics bitmaps created on the calling thread.
+ *
+ * A thread that draws calls this before it ends. Its bitmaps are of
+ * no use once it is gone, and a later thread could be given its id.
+ */
+void ImageCache::EvictThreadBitmaps()
+{
+    auto thread = std::this_thread::get_id();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    for(auto i = mBitmaps.begin(); i != mBitmaps.end(); )
+    {
+        if(std::get<1>(i->first) == thread)
+        {
+            i = mBitmaps.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+/**
+ * Remove the graphics bitmaps, keeping the decoded images
+ */
+void ImageCache::ClearBitmaps()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mBitmaps.clear();
+}
+
+/**
+ * Reset the hit and miss counters to zero
+ */
+void ImageCache::ResetCounters()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mHits = 0;
+    mMisses = 0;
+    mBitmapHits = 0;
+    mBitmapMisses = 0;
+}
+
+/**
+ * Get the number of image loads satisfied from the cache
+ * @return Hit count
+ */
+size_t ImageCache::GetHits()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mHits;
+}
+
+/**
+ * Get the number of image loads that decoded the file
+ * @return Miss count
+ */
+size_t ImageCache::GetMisses()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mMisses;
+}
+
+/**
+ * Get the number of bitmap requests satisfied from the cache
+ * @return Hit count
+ */
+size_t ImageCache::GetBitmapHits()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mBitmapHits;
+}
+
+/**
+ * Get the number of bitmap requests that created a bitmap
+ * @return Miss count
+ */
+size_t ImageCache::GetBitmapMisses()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mBitmapMisses;
+}
+
+/**
+ * Get the number of graphics bitmaps in the cache
+ * @return Number of bitmaps for every renderer and thread
+ */
+size_t ImageCache::GetBitmapCount()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mBitmaps.size();
+}
+
+/**
+ * Remove the graphics bitmaps for an image on every renderer.
+ * The caller must hold the lock.
+ * @param path Canonical image path
+ */
+void ImageCache::EraseBitmaps(const std::wstring &path)
+{
+    for(auto i = mBitmaps.begin(); i != mBitmaps.end(); )
+    {
+        if(std::get<2>(i->first) == path)
+        {
+            i = mBitmaps.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+}
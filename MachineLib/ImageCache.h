@@ -0,0 +1,105 @@
+/**
+ * @file ImageCache.h
+ * @author Thomas Conley
+ *
+ * Process-wide cache of decoded images shared by Polygon objects.
+ */
+
+#ifndef _IMAGECACHE_H
+#define _IMAGECACHE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+
+namespace cse335
+{
+
+/**
+ * Process-wide cache of decoded images shared by Polygon objects.
+ *
+ * Images are keyed by their canonical path so every polygon that
+ * uses the same file shares one decoded wxImage. Graphics bitmaps
+ * created from those images are cached per graphics renderer and
+ * thread, since graphics objects may not be shared between threads.
+ *
+ * The cache outlives main, but graphics bitmaps must not outlive
+ * wxWidgets. The last MachineSystem to be destroyed releases them,
+ * and code that draws polygons outside of any machine system must
+ * call ClearBitmaps or Clear before wxWidgets is cleaned up.
+ */
+class ImageCache
+{
+private:
+    /// Decoded images keyed by canonical path
+    std::map<std::wstring, std::shared_ptr<const wxImage>> mImages;
+
+    /// Graphics bitmaps keyed by renderer, thread and canonical path
+    std::map<std::tuple<wxGraphicsRenderer *, std::thread::id, std::wstring>, wxGraphicsBitmap> mBitmaps;
+
+    /// Protects the maps and counters
+    std::mutex mMutex;
+
+    /// Number of image loads satisfied from the cache
+    size_t mHits = 0;
+
+    /// Number of image loads that had to decode the file
+    size_t mMisses = 0;
+
+    /// Number of bitmap requests satisfied from the cache
+    size_t mBitmapHits = 0;
+
+    /// Number of bitmap requests that created a new bitmap
+    size_t mBitmapMisses = 0;
+
+    ImageCache() = default;
+
+    void EraseBitmaps(const std::wstring &path);
+
+public:
+    /// Copy constructor (disabled)
+    ImageCache(const ImageCache &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const ImageCache &) = delete;
+
+    static ImageCache &Get();
+
+    static std::wstring CanonicalPath(const std::wstring &filename);
+
+    std::shared_ptr<const wxImage> Load(const std::wstring &filename);
+
+    std::shared_ptr<const wxImage> Share(const wxImage &image);
+
+    wxGraphicsBitmap GetBitmap(const std::shared_ptr<wxGraphicsContext> &graphics,
+                               const std::wstring &filename, const wxImage &image);
+
+    void Evict(const std::wstring &filename);
+
+    void EvictUnused();
+
+    void Clear();
+
+    void ClearBitmaps();
+
+    void EvictThreadBitmaps();
+
+    void ResetCounters();
+
+    size_t GetHits();
+
+    size_t GetMisses();
+
+    size_t GetBitmapHits();
+
+    size_t GetBitmapMisses();
+
+    size_t GetBitmapCount();
+};
+
+}
+
+#endif //_IMAGECACHE_H
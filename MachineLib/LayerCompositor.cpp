@@ -0,0 +1,177 @@
+/**
+ * @file LayerCompositor.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "LayerCompositor.h"
+#include "Component.h"
+#include "DrawRecorder.h"
+#include "IRenderer.h"
+#include <cmath>
+#include <cstring>
+
+/// Extra pixels around a layer so antialiased edges are not cut off
+const int LayerMargin = 2;
+
+/**
+ * Draw the components, using cached layers for runs that have not changed
+ * @param graphics Graphics context to draw on
+ * @param target Renderer graphics is replayed on, which also renders the layers
+ * @param components Components in drawing order
+ * @param drawComponent Draws the component at an index directly on graphics
+ */
+void LayerCompositor::Draw(std::shared_ptr<wxGraphicsContext> graphics, IRenderer& target,
+        const std::vector<std::shared_ptr<Component>>& components,
+        const std::function<void(size_t)>& drawComponent)
+{
+ // Layers are only kept for transforms without rotation or shear,
+ // so a bitmap pixel lands on a screen pixel
+ double transform[6];
+ graphics->GetTransform().Get(&transform[0], &transform[1], &transform[2],
+         &transform[3], &transform[4], &transform[5]);
+ if (transform[1] != 0 || transform[2] != 0 || transform[0] <= 0 || transform[3] != transform[0])
+ {
+  Invalidate();
+  for (size_t i = 0; i < components.size(); i++)
+  {
+   drawComponent(i);
+  }
+  return;
+ }
+
+ std::vector<bool> unchanged(components.size());
+ for (size_t i = 0; i < components.size(); i++)
+ {
+  unchanged[i] = !components[i]->HasChanged();
+ }
+
+ if (unchanged != mStatic || memcmp(transform, mTransform, sizeof(mTransform)) != 0)
+ {
+  mStatic = unchanged;
+  memcpy(mTransform, transform, sizeof(mTransform));
+  Build(graphics, target, components);
+ }
+
+ size_t i = 0;
+ for (auto& layer : mLayers)
+ {
+  for ( ; i < layer.mFirst; i++)
+  {
+   drawComponent(i);
+  }
+
+  double scale = mTransform[0];
+  graphics->DrawBitmap(layer.mBitmap, layer.mX, layer.mY,
+          layer.mWidth / scale, layer.mHeight / scale);
+  i = layer.mLast + 1;
+ }
+
+ for ( ; i < components.size(); i++)
+ {
+  drawComponent(i);
+ }
+}
+
+/**
+ * Discard the cached layers, so they are rebuilt on the next draw
+ */
+void LayerCompositor::Invalidate()
+{
+ mStatic.clear();
+ mLayers.clear();
+}
+
+/**
+ * Render a layer for every run of unchanging components
+ * @param graphics Graphics context the layers will be drawn on
+ * @param target Renderer that renders the layers
+ * @param components Components in drawing order
+ */
+void LayerCompositor::Build(std::shared_ptr<wxGraphicsContext> graphics, IRenderer& target,
+        const std::vector<std::shared_ptr<Component>>& components)
+{
+ mLayers.clear();
+ for (size_t i = 0; i < components.size(); i++)
+ {
+  if (!mStatic[i])
+  {
+   continue;
+  }
+
+  Layer layer;
+  layer.mFirst = i;
+  while (i + 1 < components.size() && mStatic[i + 1])
+  {
+   i++;
+  }
+  layer.mLast = i;
+
+  for (size_t j = layer.mFirst; j <= layer.mLast; j++)
+  {
+   layer.mBounds.Union(components[j]->GetBoundingBox());
+  }
+
+  // A run that draws nothing needs no layer
+  if (layer.mBounds.IsEmpty())
+  {
+   continue;
+  }
+
+  layer.mBounds.Inflate(LayerMargin, LayerMargin);
+  Render(graphics, target, components, layer);
+  mLayers.push_back(layer);
+ }
+}
+
+/**
+ * Render the components of one layer into its bitmap
+ * @param graphics Graphics context the layer will be drawn on
+ * @param target Renderer that renders the layer
+ * @param components Components in drawing order
+ * @param layer Layer to render
+ */
+void LayerCompositor::Render(std::shared_ptr<wxGraphicsContext> graphics, IRenderer& target,
+        const std::vector<std::shared_ptr<Component>>& components, Layer& layer)
+{
+ // Line the bitmap up with the screen pixels so drawing it
+ // does not resample it
+ double scale = mTransform[0];
+ double screenX = mTransform[4] + layer.mBounds.x * scale;
+ double screenY = mTransform[5] + layer.mBounds.y * scale;
+ double offsetX = screenX - std::floor(screenX);
+ double offsetY = screenY - std::floor(screenY);
+ layer.mX = (std::floor(screenX) - mTransform[4]) / scale;
+ layer.mY = (std::floor(screenY) - mTransform[5]) / scale;
+ layer.mWidth = (int)std::ceil(layer.mBounds.width * scale + offsetX);
+ layer.mHeight = (int)std::ceil(layer.mBounds.height * scale + offsetY);
+
+ // Start fully transparent so the layer only covers what it draws
+ wxImage image(layer.mWidth, layer.mHeight);
+ image.InitAlpha();
+ memset(image.GetAlpha(), 0, (size_t)layer.mWidth * layer.mHeight);
+
+ {
+  // The layer is rendered by the same kind of renderer as the frame
+  std::unique_ptr<IRenderer> layerRenderer = target.CreateImageRenderer(image);
+  layerRenderer->SetInterpolationQuality(graphics->GetInterpolationQuality());
+  layerRenderer->SetAntialiasMode(graphics->GetAntialiasMode());
+  layerRenderer->Translate(offsetX, offsetY);
+  layerRenderer->Scale(scale, scale);
+  layerRenderer->Translate(-layer.mBounds.x, -layer.mBounds.y);
+
+  // Components may keep paths and bitmaps made by the recorder,
+  // so they only ever draw on one
+  DrawList commands;
+  std::shared_ptr<wxGraphicsContext> recorder = std::make_shared<DrawRecorder>(*layerRenderer, commands);
+  for (size_t i = layer.mFirst; i <= layer.mLast; i++)
+  {
+   components[i]->Draw(recorder);
+  }
+  commands.Optimize();
+  commands.Replay(*layerRenderer);
+ }
+
+ // The renderer writes the image when it is destroyed
+ layer.mBitmap = graphics->CreateBitmapFromImage(image);
+}
@@ -0,0 +1,73 @@
+/**
+ * @file LayerCompositor.h
+ * @author Thomas Conley
+ *
+ * Draws runs of unchanging components from cached bitmaps.
+ */
+ 
+#ifndef LAYERCOMPOSITOR_H
+#define LAYERCOMPOSITOR_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+class Component;
+class IRenderer;
+
+/**
+ * Draws runs of unchanging components from cached bitmaps.
+ *
+ * Each frame the components that have not changed since they
+ * were last drawn are found. Every run of them in drawing order
+ * is rendered once into an offscreen bitmap at the resolution of
+ * the graphics context, and that bitmap is drawn in their place
+ * until the set of unchanging components or the transform of the
+ * graphics context changes. Components that are animating are
+ * drawn between the layers as usual, so drawing order is kept.
+ */
+class LayerCompositor {
+private:
+ /// A run of unchanging components drawn from one bitmap
+ struct Layer
+ {
+  size_t mFirst;        ///< Index of the first component in the run
+  size_t mLast;         ///< Index of the last component in the run
+  wxRect mBounds;       ///< Area the run draws in
+  double mX;            ///< Where the bitmap is drawn, on a whole screen pixel
+  double mY;            ///< Where the bitmap is drawn, on a whole screen pixel
+  int mWidth;           ///< Bitmap width in screen pixels
+  int mHeight;          ///< Bitmap height in screen pixels
+  wxGraphicsBitmap mBitmap;     ///< The rendered run
+ };
+
+ /// Which components the current layers were built from
+ std::vector<bool> mStatic;
+
+ /// The layers, in drawing order
+ std::vector<Layer> mLayers;
+
+ /// Transform of the graphics context the layers were rendered for
+ double mTransform[6] = {0, 0, 0, 0, 0, 0};
+
+ void Build(std::shared_ptr<wxGraphicsContext> graphics, IRenderer& target,
+         const std::vector<std::shared_ptr<Component>>& components);
+ void Render(std::shared_ptr<wxGraphicsContext> graphics, IRenderer& target,
+         const std::vector<std::shared_ptr<Component>>& components, Layer& layer);
+
+public:
+ LayerCompositor() = default;
+
+ void Draw(std::shared_ptr<wxGraphicsContext> graphics, IRenderer& target,
+         const std::vector<std::shared_ptr<Component>>& components,
+         const std::function<void(size_t)>& drawComponent);
+ void Invalidate();
+
+ /// Get the number of cached layers
+ /// @return Layer count
+ size_t GetLayerCount() const {return mLayers.size();}
+};
+
+
+
+#endif //LAYERCOMPOSITOR_H
@@ -6,39 +6,195 @@
 #include "pch.h"
 #include "Machine.h"
 #include "MachineSystem.h"
+#include "DrawRecorder.h"
+#include "WxRenderer.h"
+#include <algorithm>
 
-Machine::Machine() {
- // Initialize the Machine if needed
+Machine::Machine() : mArena(std::make_shared<MachineArena>()) {
 }
 
+/**
+ * Draw the machine on a graphics context
+ * @param graphics Graphics context to draw on
+ */
 void Machine::Draw(std::shared_ptr<wxGraphicsContext> graphics) {
- for (const auto& component : mComponents) {
-  component->Draw(graphics); // Assuming no rotation for simplicity
+ WxRenderer renderer(graphics);
+ Draw(renderer);
+}
+
+/**
+ * Draw the machine. The components draw into a list of commands,
+ * which is optimized and then replayed on the renderer. The draw
+ * timings of the components therefore measure recording only, and
+ * optimizing and replaying are timed for the frame as a whole.
+ * @param renderer Renderer to draw with
+ */
+void Machine::Draw(IRenderer& renderer) {
+ mDrawList.Clear();
+ std::shared_ptr<wxGraphicsContext> recorder = std::make_shared<DrawRecorder>(renderer, mDrawList);
+
+ auto drawComponent = [this, &recorder](size_t i) {
+  PROFILE_SCOPE(mProfiler, mComponentProfiles[i], Draw);
+  mComponents[i]->Draw(recorder);
+ };
+
+ if (mLayerCaching)
+ {
+  mLayers.Draw(recorder, renderer, mComponents, drawComponent);
+ }
+ else
+ {
+  for (size_t i = 0; i < mComponents.size(); i++) {
+   drawComponent(i);
+  }
  }
 
  for (auto& component : mComponents)
  {
-  component->DrawForeground(graphics);
+  component->DrawForeground(recorder);
  }
+
+ {
+  PROFILE_FRAME_SCOPE(mProfiler, Optimize);
+  mDrawList.Optimize();
+ }
+
+ {
+  PROFILE_FRAME_SCOPE(mProfiler, Replay);
+  mDrawList.Replay(renderer);
+ }
+
+#ifdef MACHINE_PROFILING
+ mProfiler.RecordDrawCalls(mDrawList.GetRecordedCount(), mDrawList.GetCount());
+#endif
+
+ for (auto& component : mComponents)
+ {
+  component->MarkDrawn();
+ }
+}
+
+/**
+ * Choose whether to draw unchanging components from cached layers
+ * @param cache true to cache layers
+ */
+void Machine::SetLayerCaching(bool cache)
+{
+ mLayerCaching = cache;
+ mLayers.Invalidate();
+}
+
+/**
+ * Get the area that has to be repainted to show the machine as
+ * it is now, the union of the dirty rectangles of the components
+ * @return Dirty rectangle in machine coordinates, empty if nothing changed
+ */
+wxRect Machine::GetDirtyRect()
+{
+ wxRect dirty;
+ for (auto& component : mComponents)
+ {
+  dirty.Union(component->GetDirtyRect());
+ }
+
+ return dirty;
+}
+
+/**
+ * Get the area the whole machine draws in
+ * @return Bounding box in machine coordinates
+ */
+wxRect Machine::GetBoundingBox()
+{
+ wxRect box;
+ for (auto& component : mComponents)
+ {
+  box.Union(component->GetBoundingBox());
+ }
+
+ return box;
 }
 
 void Machine::AddComponent(std::shared_ptr<Component> component)
 {
+#ifdef MACHINE_PROFILING
+ // A component added again for drawing order keeps its timings
+ auto found = std::find(mComponents.begin(), mComponents.end(), component);
+ int profile = found != mComponents.end() ? mComponentProfiles[found - mComponents.begin()]
+                                          : mProfiler.AddComponent(component->GetName());
+ mComponentProfiles.push_back(profile);
+#endif
+
  mComponents.push_back(component);
+
+ auto model = component->GetModel();
+ if (model != nullptr)
+ {
+  mMechanism.AddModel(model);
+
+#ifdef MACHINE_PROFILING
+  if (mModelProfiles.size() < mMechanism.GetModelCount())
+  {
+   mModelProfiles.push_back(profile);
+  }
+#endif
+ }
 }
 
 
 void Machine::Advance(double delta) {
- for (const auto& component : mComponents) {
-  component->Advance(delta); // Advance each component
+#ifdef MACHINE_PROFILING
+ for (auto i : mMechanism.GetAdvanceOrder())
+ {
+  PROFILE_SCOPE(mProfiler, mModelProfiles[i], Advance);
+  mMechanism.AdvanceModel(i, delta);
  }
+#else
+ mMechanism.Advance(delta);
+#endif
 }
 
 void Machine::Reset() {
- for (const auto& component : mComponents) {
-  component->Reset(); // Reset each component
+ mMechanism.Reset();
+}
+
+/**
+ * Prepare the machine to run once it has been built
+ */
+void Machine::Compile()
+{
+ mMechanism.Compile();
+}
+
+/**
+ * Decode every image the machine draws with, so drawing the
+ * first frame does not have to
+ */
+void Machine::LoadImages()
+{
+ for (auto& component : mComponents)
+ {
+  component->LoadImages();
  }
 }
 
+/**
+ * Save the animation state of every component
+ * @param state Vector to append the component states to
+ */
+void Machine::SaveState(std::vector<double>& state)
+{
+ mMechanism.SaveState(state);
+}
+
+/**
+ * Restore the animation state of every component
+ * @param state State previously filled in by SaveState
+ */
+void Machine::RestoreState(const std::vector<double>& state)
+{
+ mMechanism.RestoreState(state);
+}
+
 
 
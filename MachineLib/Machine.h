@@ -8,6 +8,13 @@
 #ifndef MACHINE_H
 #define MACHINE_H
 #include "Component.h"
+#include "Mechanism.h"
+#include "FrameProfiler.h"
+#include "LayerCompositor.h"
+#include "DrawList.h"
+#include "MachineArena.h"
+
+class IRenderer;
 
 /// Represents a machine consisting of multiple components
 class Machine {
@@ -15,9 +22,35 @@ private:
  /// Location of the machine on the screen
  wxPoint mLocation;
 
- /// Collection of components in the machine
+ /// Collection of components in the machine, in drawing order
  std::vector<std::shared_ptr<Component>> mComponents;
 
+ /// Simulation of the component models
+ Mechanism mMechanism;
+
+ /// Memory the components are built in
+ std::shared_ptr<MachineArena> mArena;
+
+ /// Cached layers of the components that are not changing
+ LayerCompositor mLayers;
+
+ /// Draw unchanging components from cached layers
+ bool mLayerCaching = true;
+
+ /// Commands recorded for the last frame drawn
+ DrawList mDrawList;
+
+#ifdef MACHINE_PROFILING
+ /// Advance and draw timings of the components
+ FrameProfiler mProfiler;
+
+ /// Profiler index for each entry in mComponents
+ std::vector<int> mComponentProfiles;
+
+ /// Profiler index for each model in mMechanism
+ std::vector<int> mModelProfiles;
+#endif
+
 public:
  Machine();
 
@@ -27,6 +60,12 @@ public:
   */
  void Draw(std::shared_ptr<wxGraphicsContext> graphics);
 
+ /**
+  * Draw the machine with a renderer
+  * @param renderer
+  */
+ void Draw(IRenderer& renderer);
+
  /**
   * Add the component to the machine
   * @param component
@@ -34,12 +73,6 @@ public:
 
  void AddComponent(std::shared_ptr<Component> component);
 
- /**
-  * Set the Time
-  * @param time
-  */
- void SetTime(double time);
-
  /**
   * Advance the machine animation
   * @param delta
@@ -51,6 +84,44 @@ public:
   */
  void Reset();
 
+ void Compile();
+ void LoadImages();
+
+ wxRect GetDirtyRect();
+ wxRect GetBoundingBox();
+
+ void SetLayerCaching(bool cache);
+
+ /// Get the cached layers
+ /// @return LayerCompositor
+ const LayerCompositor& GetLayers() const {return mLayers;}
+
+ /// Get the commands the last frame was drawn with
+ /// @return Optimized DrawList
+ const DrawList& GetDrawList() const {return mDrawList;}
+
+ void SaveState(std::vector<double>& state);
+ void RestoreState(const std::vector<double>& state);
+
+ /// Get the component timings
+ /// @return Profiler or nullptr if profiling is not compiled in
+ const FrameProfiler* GetProfiler()
+ {
+#ifdef MACHINE_PROFILING
+  return &mProfiler;
+#else
+  return nullptr;
+#endif
+ }
+
+ /// Get the simulation of this machine
+ /// @return Mechanism
+ Mechanism* GetMechanism() {return &mMechanism;}
+
+ /// Get the memory to build this machine's components in.
+ /// Make it current with a MachineArena::Scope while building.
+ /// @return Arena
+ std::shared_ptr<MachineArena> GetArena() {return mArena;}
 };
 
 
@@ -0,0 +1,61 @@
+/**
+ * @file MachineArena.cpp
+ * @author Thomas Conley
+ */
+
+#include "MachineArena.h"
+#include <algorithm>
+
+/// Size of the first block in bytes. Each block after it is twice as large.
+const std::size_t FirstBlockSize = 16384;
+
+/// Arena of the active scope on this thread
+static thread_local std::shared_ptr<MachineArena> CurrentArena;
+
+/**
+ * Get the arena of the active scope on this thread
+ * @return Arena, or null if no scope is active
+ */
+std::shared_ptr<MachineArena> MachineArena::Current()
+{
+ return CurrentArena;
+}
+
+/**
+ * Take memory from the arena
+ * @param size Size in bytes
+ * @param alignment Alignment in bytes, no more than alignof(std::max_align_t)
+ * @return Uninitialized memory
+ */
+void* MachineArena::Allocate(std::size_t size, std::size_t alignment)
+{
+ std::size_t start = (mUsed + alignment - 1) / alignment * alignment;
+ if (mBlocks.empty() || start + size > mBlockSize)
+ {
+  mBlockSize = std::max(mBlocks.empty() ? FirstBlockSize : mBlockSize * 2, size);
+  mBlocks.push_back(std::unique_ptr<char[]>(new char[mBlockSize]));
+  start = 0;
+ }
+
+ mUsed = start + size;
+ mBytes += size;
+ mAllocations++;
+ return mBlocks.back().get() + start;
+}
+
+/**
+ * Constructor
+ * @param arena Arena to make current on this thread
+ */
+MachineArena::Scope::Scope(std::shared_ptr<MachineArena> arena) : mPrevious(CurrentArena)
+{
+ CurrentArena = std::move(arena);
+}
+
+/**
+ * Destructor, makes the previous arena current again
+ */
+MachineArena::Scope::~Scope()
+{
+ CurrentArena = std::move(mPrevious);
+}
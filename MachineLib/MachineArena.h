@@ -0,0 +1,177 @@
+/**
+ * @file MachineArena.h
+ * @author Thomas Conley
+ *
+ * Memory that everything in one machine is allocated from.
+ */
+
+#ifndef MACHINEARENA_H
+#define MACHINEARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * Memory that everything in one machine is allocated from.
+ *
+ * Allocation bumps a pointer through a few large blocks, and freeing
+ * does nothing until the arena itself goes away, so building a machine
+ * takes a handful of allocations and tearing it down releases them all
+ * at once. Components and models made with Make while a Scope is active,
+ * and the rotation and key drop lists inside them, come from the arena,
+ * and each of them keeps the arena alive.
+ *
+ * An arena is filled by one thread at a time.
+ */
+class MachineArena {
+public:
+ /**
+  * Allocator that takes memory from the current arena.
+  *
+  * A default constructed allocator uses the arena of the active
+  * Scope on this thread, or the heap if there is none.
+  */
+ template <class T>
+ class Allocator {
+ private:
+  template <class U> friend class Allocator;
+
+  /// Arena to allocate from, null for the heap
+  std::shared_ptr<MachineArena> mArena;
+
+ public:
+  /// Type allocated
+  using value_type = T;
+
+  /// Constructor, for the arena of the active scope
+  Allocator() : mArena(MachineArena::Current()) {}
+
+  /// Constructor
+  /// @param arena Arena to allocate from, null for the heap
+  explicit Allocator(std::shared_ptr<MachineArena> arena) : mArena(std::move(arena)) {}
+
+  /// Constructor from an allocator of another type
+  /// @param other Allocator whose arena to use
+  template <class U>
+  Allocator(const Allocator<U>& other) : mArena(other.mArena) {}
+
+  /// Allocate memory
+  /// @param count Number of objects
+  /// @return Uninitialized memory for the objects
+  T* allocate(std::size_t count)
+  {
+   if (mArena == nullptr)
+   {
+    return static_cast<T*>(::operator new(count * sizeof(T)));
+   }
+
+   return static_cast<T*>(mArena->Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  /// Free memory, which the arena keeps until it goes away
+  /// @param pointer Memory from allocate
+  /// @param count Number of objects
+  void deallocate(T* pointer, [[maybe_unused]] std::size_t count)
+  {
+   if (mArena == nullptr)
+   {
+    ::operator delete(pointer);
+   }
+  }
+
+  /// Do two allocators share memory?
+  /// @param other Other allocator
+  /// @return true if they use the same arena
+  template <class U>
+  bool operator==(const Allocator<U>& other) const {return mArena == other.mArena;}
+
+  /// Do two allocators use different memory?
+  /// @param other Other allocator
+  /// @return true if they use different arenas
+  template <class U>
+  bool operator!=(const Allocator<U>& other) const {return mArena != other.mArena;}
+ };
+
+ /**
+  * Makes an arena current on this thread for as long as it exists
+  */
+ class Scope {
+ private:
+  /// Arena that was current before
+  std::shared_ptr<MachineArena> mPrevious;
+
+ public:
+  explicit Scope(std::shared_ptr<MachineArena> arena);
+  ~Scope();
+
+  /// Copy constructor (disabled)
+  Scope(const Scope &) = delete;
+
+  /// Assignment operator (disabled)
+  void operator=(const Scope &) = delete;
+ };
+
+ /// A vector that allocates from the current arena
+ template <class T>
+ using Vector = std::vector<T, Allocator<T>>;
+
+private:
+ /// Blocks of memory allocated so far
+ std::vector<std::unique_ptr<char[]>> mBlocks;
+
+ /// Size of the last block in bytes
+ std::size_t mBlockSize = 0;
+
+ /// Bytes of the last block already handed out
+ std::size_t mUsed = 0;
+
+ /// Total bytes handed out
+ std::size_t mBytes = 0;
+
+ /// Number of allocations handed out
+ std::size_t mAllocations = 0;
+
+public:
+ MachineArena() = default;
+
+ /// Copy constructor (disabled)
+ MachineArena(const MachineArena &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const MachineArena &) = delete;
+
+ void* Allocate(std::size_t size, std::size_t alignment);
+
+ static std::shared_ptr<MachineArena> Current();
+
+ /**
+  * Make an object in the current arena, or on the heap if there is none
+  * @tparam T Type of object
+  * @param args Constructor arguments
+  * @return Shared pointer to the object
+  */
+ template <class T, class... Args>
+ static std::shared_ptr<T> Make(Args&&... args)
+ {
+  return std::allocate_shared<T>(Allocator<T>(), std::forward<Args>(args)...);
+ }
+
+ /// Get the number of blocks the arena has taken from the heap
+ /// @return Block count
+ std::size_t GetBlockCount() const {return mBlocks.size();}
+
+ /// Get the number of bytes handed out
+ /// @return Bytes allocated from the arena
+ std::size_t GetBytes() const {return mBytes;}
+
+ /// Get the number of allocations handed out, each of which
+ /// would otherwise have been a separate heap allocation
+ /// @return Allocation count
+ std::size_t GetAllocations() const {return mAllocations;}
+};
+
+
+
+#endif //MACHINEARENA_H
@@ -0,0 +1,108 @@
+/**
+ * @file MachineCheckpoints.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "MachineCheckpoints.h"
+
+/**
+ * Set how many frames apart checkpoints are taken.
+ * Changing the interval discards the stored checkpoints.
+ * @param frames Frames between checkpoints, 0 disables checkpointing
+ */
+void MachineCheckpoints::SetInterval(int frames)
+{
+ mInterval = std::max(frames, 0);
+ Clear();
+}
+
+/**
+ * Set the memory budget for stored checkpoints
+ * @param bytes Maximum bytes the checkpoints may use
+ */
+void MachineCheckpoints::SetBudget(size_t bytes)
+{
+ mBudget = bytes;
+ while (mBytes > mBudget && !mStates.empty())
+ {
+  Evict(mStates.begin()->first);
+ }
+}
+
+/**
+ * Is a checkpoint wanted for this frame?
+ * @param frame Frame number just reached
+ * @return true if the frame is on the interval and not yet stored
+ */
+bool MachineCheckpoints::IsDue(int frame) const
+{
+ return mInterval > 0 && frame > 0 && frame % mInterval == 0 && mStates.count(frame) == 0;
+}
+
+/**
+ * Store a checkpoint. When over budget, the checkpoints
+ * farthest from this one are discarded first.
+ * @param frame Frame number of the state
+ * @param state Machine state from Machine::SaveState
+ */
+void MachineCheckpoints::Store(int frame, const std::vector<double>& state)
+{
+ size_t bytes = state.size() * sizeof(double);
+ if (bytes > mBudget)
+ {
+  return;
+ }
+
+ while (mBytes + bytes > mBudget && !mStates.empty())
+ {
+  int first = mStates.begin()->first;
+  int last = mStates.rbegin()->first;
+  Evict(frame - first > last - frame ? first : last);
+ }
+
+ mStates[frame] = state;
+ mBytes += bytes;
+}
+
+/**
+ * Find the closest checkpoint at or before a frame
+ * @param frame Frame we are seeking to
+ * @param checkpointFrame Receives the frame number of the checkpoint
+ * @return Saved state or nullptr if there is no usable checkpoint
+ */
+const std::vector<double>* MachineCheckpoints::Nearest(int frame, int* checkpointFrame) const
+{
+ auto found = mStates.upper_bound(frame);
+ if (found == mStates.begin())
+ {
+  return nullptr;
+ }
+
+ --found;
+ *checkpointFrame = found->first;
+ return &found->second;
+}
+
+/**
+ * Discard all checkpoints
+ */
+void MachineCheckpoints::Clear()
+{
+ mStates.clear();
+ mBytes = 0;
+}
+
+/**
+ * Discard a single checkpoint
+ * @param frame Frame number of the checkpoint to discard
+ */
+void MachineCheckpoints::Evict(int frame)
+{
+ auto found = mStates.find(frame);
+ if (found != mStates.end())
+ {
+  mBytes -= found->second.size() * sizeof(double);
+  mStates.erase(found);
+ }
+}
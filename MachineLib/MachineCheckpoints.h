@@ -0,0 +1,61 @@
+/**
+ * @file MachineCheckpoints.h
+ * @author Thomas Conley
+ *
+ * Stores snapshots of the machine state every few frames
+ * so seeking does not have to replay from frame 0.
+ */
+ 
+#ifndef MACHINECHECKPOINTS_H
+#define MACHINECHECKPOINTS_H
+
+#include <map>
+#include <vector>
+
+/// Keyframe store of machine states for fast seeking
+class MachineCheckpoints {
+private:
+ /// Number of frames between checkpoints
+ int mInterval = 30;
+
+ /// Maximum number of bytes the stored states may use
+ size_t mBudget = 1024 * 1024;
+
+ /// Bytes used by the stored states
+ size_t mBytes = 0;
+
+ /// Saved machine states keyed by frame number
+ std::map<int, std::vector<double>> mStates;
+
+ void Evict(int frame);
+
+public:
+ MachineCheckpoints() = default;
+
+ void SetInterval(int frames);
+ void SetBudget(size_t bytes);
+ bool IsDue(int frame) const;
+ void Store(int frame, const std::vector<double>& state);
+ const std::vector<double>* Nearest(int frame, int* checkpointFrame) const;
+ void Clear();
+
+ /// Get the number of frames between checkpoints
+ /// @return Checkpoint interval in frames
+ int GetInterval() const {return mInterval;}
+
+ /// Get the memory budget for checkpoints
+ /// @return Budget in bytes
+ size_t GetBudget() const {return mBudget;}
+
+ /// Get the memory currently used by checkpoints
+ /// @return Bytes used
+ size_t GetBytes() const {return mBytes;}
+
+ /// Get the number of stored checkpoints
+ /// @return Checkpoint count
+ size_t GetCount() const {return mStates.size();}
+};
+
+
+
+#endif //MACHINECHECKPOINTS_H
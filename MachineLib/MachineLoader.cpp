@@ -0,0 +1,581 @@
+/**
+ * @file MachineLoader.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include <wx/file.h>
+#include "MachineLoader.h"
+#include "Machine.h"
+#include "Box.h"
+#include "Sparty.h"
+#include "Crank.h"
+#include "Shaft.h"
+#include "Pulley.h"
+#include "Cam.h"
+#include "Banner.h"
+#include "MachineSnapshot.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/// Directory containing images
+const std::wstring ImagesDirectory = L"/images";
+
+/// Most tokens a statement can have
+const int MaxTokens = 16;
+
+/// Longest number a statement can have
+const size_t MaxNumberLength = 31;
+
+/// Extension of a machine snapshot file
+const std::wstring SnapshotExtension = L".snapshot";
+
+using ComponentType = MachineSnapshot::ComponentType;
+using LinkType = MachineSnapshot::LinkType;
+
+/// Description file name and parameter count of each component type
+static const struct
+{
+ const char* mName;     ///< Name used in description files
+ int mParameters;       ///< Parameters after the x and y
+} ComponentTypes[] = {
+    {"box", 2}, {"sparty", 5}, {"crank", 1}, {"shaft", 3},
+    {"pulley", 2}, {"cam", 1}, {"banner", 0}};
+
+/**
+ * Constructor
+ * @param resourcesDir Path to the resources directory
+ */
+MachineLoader::MachineLoader(const std::wstring& resourcesDir) :
+    mImagesDir(resourcesDir + ImagesDirectory)
+{
+}
+
+/**
+ * Load a machine from a description or snapshot file
+ * @param filename File to load, a snapshot if it ends in .snapshot
+ * @return Machine or nullptr if the file could not be read or parsed
+ */
+std::shared_ptr<Machine> MachineLoader::Load(const std::wstring& filename)
+{
+ MachineSnapshot snapshot;
+ if (!Read(filename, snapshot))
+ {
+  return nullptr;
+ }
+
+ return Build(snapshot);
+}
+
+/**
+ * Read a description or snapshot file into a snapshot
+ * @param filename File to read, a snapshot if it ends in .snapshot
+ * @param snapshot Snapshot to fill in
+ * @return false if the file could not be read or parsed
+ */
+bool MachineLoader::Read(const std::wstring& filename, MachineSnapshot& snapshot)
+{
+ if (filename.size() >= SnapshotExtension.size() &&
+     filename.compare(filename.size() - SnapshotExtension.size(),
+             SnapshotExtension.size(), SnapshotExtension) == 0)
+ {
+  return ReadSnapshot(filename, snapshot);
+ }
+
+ wxFile file;
+ if (!wxFile::Exists(filename) || !file.Open(filename))
+ {
+  mError = L"Unable to open " + filename;
+  return false;
+ }
+
+ std::vector<char> text(file.Length());
+ if (file.Read(text.data(), text.size()) != (ssize_t)text.size())
+ {
+  mError = L"Unable to read " + filename;
+  return false;
+ }
+
+ return Compile(text.data(), text.size(), snapshot);
+}
+
+/**
+ * Build a machine from a description
+ * @param text Description text, need not be null terminated
+ * @param length Length of the text in bytes
+ * @return Machine or nullptr if the description has an error
+ */
+std::shared_ptr<Machine> MachineLoader::Parse(const char* text, size_t length)
+{
+ MachineSnapshot snapshot;
+ if (!Compile(text, length, snapshot))
+ {
+  return nullptr;
+ }
+
+ return Build(snapshot);
+}
+
+/**
+ * Compile a description into a snapshot
+ * @param text Description text, need not be null terminated
+ * @param length Length of the text in bytes
+ * @param snapshot Snapshot to fill in
+ * @return false if the description has an error
+ */
+bool MachineLoader::Compile(const char* text, size_t length, MachineSnapshot& snapshot)
+{
+ mIds.clear();
+ mComponents.clear();
+ mLinks.clear();
+ mDrawOrder.clear();
+ mStrings.clear();
+ mError.clear();
+
+ bool ok = true;
+ const char* end = text + length;
+ int line = 1;
+ for (const char* begin = text; ok && begin < end; line++)
+ {
+  const char* lineEnd = begin;
+  while (lineEnd < end && *lineEnd != '\n' && *lineEnd != '#')
+  {
+   lineEnd++;
+  }
+
+  ok = Statement(begin, lineEnd, line);
+
+  // Skip any comment and the newline
+  while (lineEnd < end && *lineEnd != '\n')
+  {
+   lineEnd++;
+  }
+  begin = lineEnd + 1;
+ }
+
+ if (ok)
+ {
+  snapshot.Create(mComponents, mLinks, mDrawOrder, mStrings);
+ }
+
+ mIds.clear();
+ return ok;
+}
+
+/**
+ * Compile one statement
+ * @param begin Start of the statement
+ * @param end End of the statement, not including any comment
+ * @param line Line number for error messages
+ * @return false if the statement has an error
+ */
+bool MachineLoader::Statement(const char* begin, const char* end, int line)
+{
+ // Split into tokens without copying
+ std::pair<const char*, const char*> tokens[MaxTokens];
+ int count = 0;
+ for (const char* p = begin; p < end; )
+ {
+  while (p < end && isspace((unsigned char)*p))
+  {
+   p++;
+  }
+
+  const char* start = p;
+  while (p < end && !isspace((unsigned char)*p))
+  {
+   p++;
+  }
+
+  if (p > start)
+  {
+   if (count == MaxTokens)
+   {
+    return Fail(line, L"too many values");
+   }
+
+   tokens[count++] = {start, p};
+  }
+ }
+
+ if (count == 0)
+ {
+  return true;
+ }
+
+ std::string command(tokens[0].first, tokens[0].second);
+ auto token = [&tokens](int i) {return std::string(tokens[i].first, tokens[i].second);};
+
+ // Read the numeric tokens from first up to, but not including, last
+ double values[MaxTokens];
+ auto numbers = [&](int first, int last) {
+  for (int i = first; i < last; i++)
+  {
+   // The text need not be terminated, so copy the token before converting it
+   char number[MaxNumberLength + 1];
+   size_t size = tokens[i].second - tokens[i].first;
+   if (size > MaxNumberLength)
+   {
+    return false;
+   }
+
+   memcpy(number, tokens[i].first, size);
+   number[size] = 0;
+
+   char* parsed;
+   values[i] = strtod(number, &parsed);
+   if (parsed != number + size)
+   {
+    return false;
+   }
+  }
+  return true;
+ };
+
+ if (command == "drive" || command == "belt" || command == "keydrop")
+ {
+  MachineSnapshot::LinkRecord link = {};
+  if (count < 3)
+  {
+   return Fail(line, L"expected two ids");
+  }
+
+  if (!Find(token(1), line, &link.mFrom) || !Find(token(2), line, &link.mTo))
+  {
+   return false;
+  }
+
+  if (command == "drive")
+  {
+   if (count != 3)
+   {
+    return Fail(line, L"drive needs a rotation source and sink");
+   }
+
+   link.mType = LinkType::Drive;
+  }
+  else if (command == "belt")
+  {
+   if (count > 4 || !numbers(3, count))
+   {
+    return Fail(line, L"belt needs two pulleys and an optional slip");
+   }
+
+   link.mType = LinkType::Belt;
+   link.mValue = count > 3 ? values[3] : 0;
+  }
+  else
+  {
+   if (count != 3)
+   {
+    return Fail(line, L"keydrop needs a cam and a listener");
+   }
+
+   link.mType = LinkType::KeyDrop;
+  }
+
+  // Snapshots read from files are checked the same way
+  auto error = MachineSnapshot::CheckLink(link, mComponents[link.mFrom].mType,
+          mComponents[link.mTo].mType);
+  if (error != nullptr)
+  {
+   return Fail(line, error);
+  }
+
+  mLinks.push_back(link);
+  return true;
+ }
+
+ if (command == "draw")
+ {
+  for (int i = 1; i < count; i++)
+  {
+   uint32_t index;
+   if (!Find(token(i), line, &index))
+   {
+    return false;
+   }
+
+   mDrawOrder.push_back(index);
+  }
+
+  return true;
+ }
+
+ // Everything else declares a component: type id x y parameters...
+ MachineSnapshot::ComponentRecord component = {};
+ int type = 0;
+ int numTypes = sizeof(ComponentTypes) / sizeof(ComponentTypes[0]);
+ while (type < numTypes && command != ComponentTypes[type].mName)
+ {
+  type++;
+ }
+
+ if (type == numTypes)
+ {
+  return Fail(line, L"unknown statement " + wxString::FromUTF8(command.c_str()).ToStdWstring());
+ }
+
+ component.mType = (ComponentType)type;
+ if (count != 4 + ComponentTypes[type].mParameters)
+ {
+  return Fail(line, L"expected " + std::to_wstring(ComponentTypes[type].mParameters) +
+      L" parameters for " + wxString::FromUTF8(command.c_str()).ToStdWstring());
+ }
+
+ auto id = token(1);
+ if (mIds.count(id) > 0)
+ {
+  return Fail(line, L"duplicate id " + wxString::FromUTF8(id.c_str()).ToStdWstring());
+ }
+
+ // Sparty's image is the one parameter that is not a number
+ component.mImage = MachineSnapshot::NoString;
+ int first = 4;
+ if (component.mType == ComponentType::Sparty)
+ {
+  component.mImage = (uint32_t)mStrings.size();
+  mStrings.append(tokens[4].first, tokens[4].second);
+  mStrings.push_back(0);
+  first = 5;
+ }
+
+ if (!numbers(2, 4) || !numbers(first, count))
+ {
+  return Fail(line, L"expected a number");
+ }
+
+ component.mX = values[2];
+ component.mY = values[3];
+ for (int i = first; i < count; i++)
+ {
+  component.mParameters[i - first] = values[i];
+ }
+
+ auto error = MachineSnapshot::CheckComponent(component);
+ if (error != nullptr)
+ {
+  return Fail(line, error);
+ }
+
+ mIds.emplace(id, (uint32_t)mComponents.size());
+ mComponents.push_back(component);
+ return true;
+}
+
+/**
+ * Build a machine from a snapshot
+ * @param snapshot A valid snapshot
+ * @return Machine
+ */
+std::shared_ptr<Machine> MachineLoader::Build(const MachineSnapshot& snapshot)
+{
+ /// What each component offers to the links
+ struct Built
+ {
+  std::shared_ptr<Component> mComponent;
+  RotationSource* mSource = nullptr;
+  std::shared_ptr<IRotationSink> mSink;
+  IKeyDropListener* mListener = nullptr;
+  std::shared_ptr<Pulley> mPulley;
+  std::shared_ptr<Cam> mCam;
+ };
+
+ auto machine = std::make_shared<Machine>();
+ MachineArena::Scope scope(machine->GetArena());
+
+ auto components = snapshot.GetComponents();
+ std::vector<Built> built(snapshot.GetComponentCount());
+ for (size_t i = 0; i < built.size(); i++)
+ {
+  auto& record = components[i];
+  auto parameters = record.mParameters;
+  switch (record.mType)
+  {
+  case ComponentType::Box:
+  {
+   auto box = MachineArena::Make<Box>(mImagesDir, (int)parameters[0], (int)parameters[1]);
+   built[i].mComponent = box;
+   built[i].mListener = box->GetKeyDropListener();
+   break;
+  }
+
+  case ComponentType::Sparty:
+  {
+   auto image = mImagesDir + L"/" +
+       wxString::FromUTF8(snapshot.GetString(record.mImage)).ToStdWstring();
+   auto sparty = MachineArena::Make<Sparty>(image, (int)parameters[0], (int)parameters[1],
+           (int)parameters[2], (int)parameters[3]);
+   built[i].mComponent = sparty;
+   built[i].mListener = sparty->GetKeyDropListener();
+   break;
+  }
+
+  case ComponentType::Crank:
+  {
+   auto crank = MachineArena::Make<Crank>();
+   crank->SetSpeed(parameters[0]);
+   built[i].mComponent = crank;
+   built[i].mSource = crank->GetSource();
+   break;
+  }
+
+  case ComponentType::Shaft:
+  {
+   auto shaft = MachineArena::Make<Shaft>();
+   shaft->SetSize(parameters[0], parameters[1]);
+   shaft->SetOffset(parameters[2]);
+   built[i].mComponent = shaft;
+   built[i].mSource = shaft->GetSource();
+   built[i].mSink = shaft->GetSink();
+   break;
+  }
+
+  case ComponentType::Pulley:
+  {
+   auto pulley = MachineArena::Make<Pulley>(parameters[0], parameters[1]);
+   built[i].mComponent = pulley;
+   built[i].mSource = pulley->GetSource();
+   built[i].mSink = pulley->GetSink();
+   built[i].mPulley = pulley;
+   break;
+  }
+
+  case ComponentType::Cam:
+  {
+   auto cam = MachineArena::Make<Cam>(mImagesDir);
+   cam->SetHoleAngle(parameters[0]);
+   built[i].mComponent = cam;
+   built[i].mSource = cam->GetSource();
+   built[i].mSink = cam->GetSink();
+   built[i].mCam = cam;
+   break;
+  }
+
+  case ComponentType::Banner:
+  {
+   auto banner = MachineArena::Make<Banner>(mImagesDir);
+   built[i].mComponent = banner;
+   built[i].mListener = banner->GetKeyDropListener();
+   break;
+  }
+  }
+
+  built[i].mComponent->SetPosition((int)record.mX, (int)record.mY);
+ }
+
+ auto links = snapshot.GetLinks();
+ for (size_t i = 0; i < snapshot.GetLinkCount(); i++)
+ {
+  auto& from = built[links[i].mFrom];
+  auto& to = built[links[i].mTo];
+  if (links[i].mType == LinkType::Drive && from.mSource != nullptr && to.mSink != nullptr)
+  {
+   from.mSource->AddSink(to.mSink);
+  }
+  else if (links[i].mType == LinkType::Belt && from.mPulley != nullptr && to.mPulley != nullptr)
+  {
+   from.mPulley->BeltTo(to.mPulley, links[i].mValue);
+  }
+  else if (links[i].mType == LinkType::KeyDrop && from.mCam != nullptr && to.mListener != nullptr)
+  {
+   from.mCam->AddKeyDrop(to.mListener);
+  }
+ }
+
+ auto drawOrder = snapshot.GetDrawOrder();
+ for (size_t i = 0; i < snapshot.GetDrawCount(); i++)
+ {
+  machine->AddComponent(built[drawOrder[i]].mComponent);
+ }
+
+ return machine;
+}
+
+/**
+ * Read a snapshot file. The file is read in one piece
+ * into the snapshot's buffer and used where it lies.
+ * @param filename File to read
+ * @param snapshot Snapshot to read into
+ * @return false if the file could not be read or is not a valid snapshot
+ */
+bool MachineLoader::ReadSnapshot(const std::wstring& filename, MachineSnapshot& snapshot)
+{
+ mError.clear();
+
+ wxFile file;
+ if (!wxFile::Exists(filename) || !file.Open(filename))
+ {
+  mError = L"Unable to open " + filename;
+  return false;
+ }
+
+ size_t size = file.Length();
+ if (file.Read(snapshot.Allocate(size), size) != (ssize_t)size)
+ {
+  mError = L"Unable to read " + filename;
+  return false;
+ }
+
+ if (!snapshot.Validate())
+ {
+  mError = filename + L" is not a valid machine snapshot";
+  return false;
+ }
+
+ return true;
+}
+
+/**
+ * Write a snapshot file
+ * @param filename File to write
+ * @param snapshot Snapshot to write
+ * @return false if the file could not be written
+ */
+bool MachineLoader::WriteSnapshot(const std::wstring& filename, const MachineSnapshot& snapshot)
+{
+ mError.clear();
+
+ wxFile file;
+ if (!file.Create(filename, true) ||
+     file.Write(snapshot.GetData(), snapshot.GetSize()) != snapshot.GetSize())
+ {
+  mError = L"Unable to write " + filename;
+  return false;
+ }
+
+ return true;
+}
+
+/**
+ * Find a declared component
+ * @param id Id of the component
+ * @param line Line number for error messages
+ * @param index Set to the index of the component
+ * @return false if there is no such component
+ */
+bool MachineLoader::Find(const std::string& id, int line, uint32_t* index)
+{
+ auto found = mIds.find(id);
+ if (found == mIds.end())
+ {
+  return Fail(line, L"unknown id " + wxString::FromUTF8(id.c_str()).ToStdWstring());
+ }
+
+ *index = found->second;
+ return true;
+}
+
+/**
+ * Record an error
+ * @param line Line number the error is on
+ * @param message Description of the error
+ * @return false
+ */
+bool MachineLoader::Fail(int line, const std::wstring& message)
+{
+ mError = L"Line " + std::to_wstring(line) + L": " + message;
+ return false;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file MachineLoader.h
+ * @author Thomas Conley
+ *
+ * Builds machines from machine description files and snapshots.
+ */
+ 
+#ifndef MACHINELOADER_H
+#define MACHINELOADER_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MachineSnapshot.h"
+
+class Machine;
+
+/**
+ * Builds machines from machine description files and snapshots.
+ *
+ * A description has one statement per line. Blank lines and
+ * anything after a # are ignored. Components are declared with
+ *
+ *     type id x y parameters...
+ *
+ * where the types and their parameters are
+ *
+ *     box     id x y boxSize lidSize
+ *     sparty  id x y image size springLength springWidth numLinks
+ *     crank   id x y speed
+ *     shaft   id x y diameter length offset
+ *     pulley  id x y diameter width
+ *     cam     id x y holeAngle
+ *     banner  id x y
+ *
+ * and connected and drawn with
+ *
+ *     drive   sourceId sinkId
+ *     belt    pulleyId pulleyId [slip]
+ *     keydrop camId listenerId
+ *     draw    id id ...
+ *
+ * Numbers must be finite, and those used as integer sizes and
+ * positions must fit in an int. Pulley diameters must be positive,
+ * and a belt's slip, the fraction of the rotation it loses, is at
+ * least 0 and less than 1.
+ *
+ * Components are added to the machine in the order they are
+ * drawn, and a component may be drawn more than once.
+ *
+ * A description is first compiled into a MachineSnapshot and
+ * the machine is built from that. Snapshots can be saved, and
+ * loading a saved snapshot skips the parsing altogether.
+ */
+class MachineLoader {
+private:
+ /// Path to the images directory
+ std::wstring mImagesDir;
+
+ /// Index of each component declared so far, by id
+ std::unordered_map<std::string, uint32_t> mIds;
+
+ /// Components declared so far
+ std::vector<MachineSnapshot::ComponentRecord> mComponents;
+
+ /// Connections made so far
+ std::vector<MachineSnapshot::LinkRecord> mLinks;
+
+ /// Draw order so far
+ std::vector<uint32_t> mDrawOrder;
+
+ /// String table so far
+ std::string mStrings;
+
+ /// Description of the first error
+ std::wstring mError;
+
+ bool Statement(const char* begin, const char* end, int line);
+ bool Find(const std::string& id, int line, uint32_t* index);
+ bool Fail(int line, const std::wstring& message);
+
+public:
+ MachineLoader(const std::wstring& resourcesDir);
+
+ std::shared_ptr<Machine> Load(const std::wstring& filename);
+ std::shared_ptr<Machine> Parse(const char* text, size_t length);
+ std::shared_ptr<Machine> Build(const MachineSnapshot& snapshot);
+
+ bool Read(const std::wstring& filename, MachineSnapshot& snapshot);
+ bool Compile(const char* text, size_t length, MachineSnapshot& snapshot);
+ bool ReadSnapshot(const std::wstring& filename, MachineSnapshot& snapshot);
+ bool WriteSnapshot(const std::wstring& filename, const MachineSnapshot& snapshot);
+
+ /// Get the description of why loading failed
+ /// @return Error message, empty if the last load succeeded
+ const std::wstring& GetError() const {return mError;}
+};
+
+
+
+#endif //MACHINELOADER_H
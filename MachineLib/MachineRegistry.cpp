@@ -0,0 +1,66 @@
+/**
+ * @file MachineRegistry.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include <wx/dir.h>
+#include "MachineRegistry.h"
+
+/// Directory of machine descriptions within the resources directory
+const std::wstring MachinesDirectory = L"/machines";
+
+/// Prefix of a machine description file name
+const std::wstring MachinePrefix = L"machine";
+
+/// Extension of a machine description file
+const std::wstring MachineExtension = L".machine";
+
+/// Extension of a machine snapshot file
+const std::wstring SnapshotExtension = L".snapshot";
+
+/**
+ * Register every machine description and snapshot in a resources directory
+ * @param resourcesDir Path to the resources directory
+ */
+void MachineRegistry::Scan(const std::wstring& resourcesDir)
+{
+ auto directory = resourcesDir + MachinesDirectory;
+ if (!wxDir::Exists(directory))
+ {
+  return;
+ }
+
+ // Snapshots are scanned last so they take the place of a
+ // description of the same machine
+ wxDir dir(directory);
+ for (auto& extension : {MachineExtension, SnapshotExtension})
+ {
+  wxString name;
+  bool found = dir.GetFirst(&name, MachinePrefix + L"*" + extension, wxDIR_FILES);
+  while (found)
+  {
+   // The number is whatever is between the prefix and the extension
+   wxString number = name.Mid(MachinePrefix.size(),
+           name.size() - MachinePrefix.size() - extension.size());
+   long machine;
+   if (number.ToLong(&machine))
+   {
+    Register((int)machine, directory + L"/" + name.ToStdWstring());
+   }
+
+   found = dir.GetNext(&name);
+  }
+ }
+}
+
+/**
+ * Find the description file for a machine
+ * @param machine Machine number
+ * @return Description file or an empty string if the machine is not registered
+ */
+std::wstring MachineRegistry::Find(int machine) const
+{
+ auto found = mFiles.find(machine);
+ return found == mFiles.end() ? std::wstring() : found->second;
+}
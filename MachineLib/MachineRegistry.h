@@ -0,0 +1,44 @@
+/**
+ * @file MachineRegistry.h
+ * @author Thomas Conley
+ *
+ * Maps machine numbers to machine description files.
+ */
+ 
+#ifndef MACHINEREGISTRY_H
+#define MACHINEREGISTRY_H
+
+#include <map>
+#include <string>
+
+/**
+ * Maps machine numbers to machine description files.
+ *
+ * Scanning a resources directory registers every
+ * machines/machine<N>.machine file in it as machine N.
+ * A machines/machine<N>.snapshot file takes the place
+ * of the description of machine N.
+ */
+class MachineRegistry {
+private:
+ /// Description file for each machine number
+ std::map<int, std::wstring> mFiles;
+
+public:
+ void Scan(const std::wstring& resourcesDir);
+
+ /// Register a description file for a machine number
+ /// @param machine Machine number
+ /// @param filename Description file
+ void Register(int machine, const std::wstring& filename) {mFiles[machine] = filename;}
+
+ std::wstring Find(int machine) const;
+
+ /// Get all of the registered machines
+ /// @return Description file for each machine number
+ const std::map<int, std::wstring>& GetFiles() const {return mFiles;}
+};
+
+
+
+#endif //MACHINEREGISTRY_H
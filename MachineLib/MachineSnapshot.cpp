@@ -0,0 +1,295 @@
+/**
+ * @file MachineSnapshot.cpp
+ * @author Thomas Conley
+ */
+
+#include "MachineSnapshot.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+/// Identifies a machine snapshot
+const char Magic[4] = {'J', 'B', 'M', 'S'};
+
+/**
+ * Round a size up to a whole number of 8 byte words
+ * @param size Size in bytes
+ * @return Rounded size in bytes
+ */
+static size_t Align(size_t size)
+{
+ return (size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+}
+
+/**
+ * Can a number be cast to an int?
+ * @param value Number to check
+ * @return true if it is finite and in the range of an int
+ */
+static bool IsInt(double value)
+{
+ return value > std::numeric_limits<int>::min() - 1.0 &&
+     value < std::numeric_limits<int>::max() + 1.0;
+}
+
+/**
+ * Build a snapshot from its parts
+ * @param components Component records
+ * @param links Link records, referring to components by index
+ * @param drawOrder Indices of the components in the order they are drawn
+ * @param strings String table, each string null terminated
+ */
+void MachineSnapshot::Create(const std::vector<ComponentRecord>& components,
+        const std::vector<LinkRecord>& links,
+        const std::vector<uint32_t>& drawOrder,
+        const std::string& strings)
+{
+ Header header = {};
+ memcpy(header.mMagic, Magic, sizeof(Magic));
+ header.mVersion = Version;
+ header.mComponentCount = (uint32_t)components.size();
+ header.mLinkCount = (uint32_t)links.size();
+ header.mDrawCount = (uint32_t)drawOrder.size();
+ header.mStringsSize = (uint32_t)strings.size();
+
+ auto linksOffset = sizeof(Header) + components.size() * sizeof(ComponentRecord);
+ auto drawOffset = linksOffset + links.size() * sizeof(LinkRecord);
+ auto stringsOffset = Align(drawOffset + drawOrder.size() * sizeof(uint32_t));
+
+ auto bytes = static_cast<char*>(Allocate(stringsOffset + strings.size()));
+ memset(bytes, 0, mSize);
+ memcpy(bytes, &header, sizeof(Header));
+ memcpy(bytes + sizeof(Header), components.data(), components.size() * sizeof(ComponentRecord));
+ memcpy(bytes + linksOffset, links.data(), links.size() * sizeof(LinkRecord));
+ memcpy(bytes + drawOffset, drawOrder.data(), drawOrder.size() * sizeof(uint32_t));
+ memcpy(bytes + stringsOffset, strings.data(), strings.size());
+}
+
+/**
+ * Make room for a snapshot that will be read in directly.
+ * Any previous contents are discarded.
+ * @param size Size of the snapshot in bytes
+ * @return Buffer to read the snapshot into
+ */
+void* MachineSnapshot::Allocate(size_t size)
+{
+ mBuffer.reset(new uint64_t[Align(size) / sizeof(uint64_t)]);
+ mSize = size;
+ return mBuffer.get();
+}
+
+/**
+ * Check a snapshot that was read in is complete and consistent,
+ * so the records can be used without further checks.
+ * @return true if the snapshot is valid
+ */
+bool MachineSnapshot::Validate() const
+{
+ if (mBuffer == nullptr || mSize < sizeof(Header))
+ {
+  return false;
+ }
+
+ auto header = GetHeader();
+ if (memcmp(header->mMagic, Magic, sizeof(Magic)) != 0 || header->mVersion != Version)
+ {
+  return false;
+ }
+
+ // The sizes come from the file, so check them before using them
+ if (header->mComponentCount > mSize / sizeof(ComponentRecord) ||
+     header->mLinkCount > mSize / sizeof(LinkRecord) ||
+     header->mDrawCount > mSize / sizeof(uint32_t) ||
+     GetStringsOffset() + header->mStringsSize != mSize)
+ {
+  return false;
+ }
+
+ // The last string must be terminated so no string runs off the end
+ auto strings = GetBytes() + GetStringsOffset();
+ if (header->mStringsSize > 0 && strings[header->mStringsSize - 1] != 0)
+ {
+  return false;
+ }
+
+ auto components = GetComponents();
+ for (size_t i = 0; i < header->mComponentCount; i++)
+ {
+  if (components[i].mType > ComponentType::Banner ||
+      (components[i].mImage != NoString && components[i].mImage >= header->mStringsSize) ||
+      CheckComponent(components[i]) != nullptr)
+  {
+   return false;
+  }
+ }
+
+ auto links = GetLinks();
+ for (size_t i = 0; i < header->mLinkCount; i++)
+ {
+  if (links[i].mType > LinkType::KeyDrop ||
+      links[i].mFrom >= header->mComponentCount || links[i].mTo >= header->mComponentCount ||
+      CheckLink(links[i], components[links[i].mFrom].mType, components[links[i].mTo].mType) != nullptr)
+  {
+   return false;
+  }
+ }
+
+ auto drawOrder = GetDrawOrder();
+ for (size_t i = 0; i < header->mDrawCount; i++)
+ {
+  if (drawOrder[i] >= header->mComponentCount)
+  {
+   return false;
+  }
+ }
+
+ return true;
+}
+
+/**
+ * Can a component type drive other components?
+ * @param type Component type
+ * @return true if it has a rotation source
+ */
+bool MachineSnapshot::IsSource(ComponentType type)
+{
+ return type == ComponentType::Crank || type == ComponentType::Shaft ||
+     type == ComponentType::Pulley || type == ComponentType::Cam;
+}
+
+/**
+ * Can a component type be driven by other components?
+ * @param type Component type
+ * @return true if it is a rotation sink
+ */
+bool MachineSnapshot::IsSink(ComponentType type)
+{
+ return type == ComponentType::Shaft || type == ComponentType::Pulley ||
+     type == ComponentType::Cam;
+}
+
+/**
+ * Can a component type listen for the key drop?
+ * @param type Component type
+ * @return true if it is a key drop listener
+ */
+bool MachineSnapshot::IsListener(ComponentType type)
+{
+ return type == ComponentType::Box || type == ComponentType::Sparty ||
+     type == ComponentType::Banner;
+}
+
+/**
+ * Check a component record's values can be built
+ * @param component Component record of a known type
+ * @return Why the record is not valid, or nullptr if it is
+ */
+const wchar_t* MachineSnapshot::CheckComponent(const ComponentRecord& component)
+{
+ // Positions, and the box and Sparty sizes, are cast to int
+ int ints = component.mType == ComponentType::Box ? 2 :
+     component.mType == ComponentType::Sparty ? 4 : 0;
+ if (!IsInt(component.mX) || !IsInt(component.mY))
+ {
+  return L"number out of range";
+ }
+
+ for (int i = 0; i < MaxParameters; i++)
+ {
+  if (i < ints ? !IsInt(component.mParameters[i]) : !std::isfinite(component.mParameters[i]))
+  {
+   return L"number out of range";
+  }
+ }
+
+ if (component.mType == ComponentType::Sparty && component.mImage == NoString)
+ {
+  return L"sparty needs an image";
+ }
+
+ // The belt ratio divides by the diameter
+ if (component.mType == ComponentType::Pulley && !(component.mParameters[0] > 0))
+ {
+  return L"pulley diameter must be positive";
+ }
+
+ return nullptr;
+}
+
+/**
+ * Check a link joins the kinds of component it needs
+ * @param link Link record of a known type
+ * @param from Type of the component it links from
+ * @param to Type of the component it links to
+ * @return Why the link is not valid, or nullptr if it is
+ */
+const wchar_t* MachineSnapshot::CheckLink(const LinkRecord& link, ComponentType from, ComponentType to)
+{
+ switch (link.mType)
+ {
+ case LinkType::Drive:
+  if (!IsSource(from) || !IsSink(to))
+  {
+   return L"drive needs a rotation source and sink";
+  }
+  break;
+
+ case LinkType::Belt:
+  if (from != ComponentType::Pulley || to != ComponentType::Pulley)
+  {
+   return L"belt needs two pulleys and an optional slip";
+  }
+
+  if (!(link.mValue >= 0 && link.mValue < 1))
+  {
+   return L"belt slip must be at least 0 and less than 1";
+  }
+  break;
+
+ case LinkType::KeyDrop:
+  if (from != ComponentType::Cam || !IsListener(to))
+  {
+   return L"keydrop needs a cam and a listener";
+  }
+  break;
+ }
+
+ return nullptr;
+}
+
+/**
+ * Get a string from the string table
+ * @param offset Offset of the string
+ * @return The string or nullptr for NoString
+ */
+const char* MachineSnapshot::GetString(uint32_t offset) const
+{
+ return offset == NoString ? nullptr : GetBytes() + GetStringsOffset() + offset;
+}
+
+/**
+ * Get where the link records start
+ * @return Offset in bytes
+ */
+size_t MachineSnapshot::GetLinksOffset() const
+{
+ return sizeof(Header) + GetHeader()->mComponentCount * sizeof(ComponentRecord);
+}
+
+/**
+ * Get where the draw order starts
+ * @return Offset in bytes
+ */
+size_t MachineSnapshot::GetDrawOffset() const
+{
+ return GetLinksOffset() + GetHeader()->mLinkCount * sizeof(LinkRecord);
+}
+
+/**
+ * Get where the string table starts
+ * @return Offset in bytes
+ */
+size_t MachineSnapshot::GetStringsOffset() const
+{
+ return Align(GetDrawOffset() + GetHeader()->mDrawCount * sizeof(uint32_t));
+}
@@ -0,0 +1,159 @@
+/**
+ * @file MachineSnapshot.h
+ * @author Thomas Conley
+ *
+ * Compact binary description of a machine.
+ */
+ 
+#ifndef MACHINESNAPSHOT_H
+#define MACHINESNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Compact binary description of a machine.
+ *
+ * A snapshot is one contiguous block: a header followed by
+ * fixed size component records, link records, the draw order
+ * and a table of null terminated strings. Records refer to
+ * components by their index and to strings by their offset in
+ * the table, so the block has no pointers and can be read or
+ * mapped from a file straight into the one buffer and used
+ * where it lies.
+ *
+ * The records of a valid snapshot also make sense as a machine:
+ * every number is finite, the numbers cast to int fit in one, and
+ * the links join the kinds of component they need. The loader
+ * checks what it compiles the same way, with CheckComponent and
+ * CheckLink.
+ */
+class MachineSnapshot {
+public:
+ /// Current version of the format
+ static constexpr uint32_t Version = 1;
+
+ /// Offset that means there is no string
+ static constexpr uint32_t NoString = 0xffffffff;
+
+ /// Number of parameters in a component record
+ static constexpr int MaxParameters = 5;
+
+ /// The kinds of component
+ enum class ComponentType : uint32_t {Box, Sparty, Crank, Shaft, Pulley, Cam, Banner};
+
+ /// The kinds of connection between components
+ enum class LinkType : uint32_t {Drive, Belt, KeyDrop};
+
+ /// Start of every snapshot
+ struct Header
+ {
+  char mMagic[4];               ///< Identifies the file as a snapshot
+  uint32_t mVersion;            ///< Format version
+  uint32_t mComponentCount;     ///< Number of component records
+  uint32_t mLinkCount;          ///< Number of link records
+  uint32_t mDrawCount;          ///< Number of entries in the draw order
+  uint32_t mStringsSize;        ///< Bytes in the string table
+  uint32_t mReserved[2];        ///< Keeps the records 8 byte aligned
+ };
+
+ /// One component and its construction parameters
+ struct ComponentRecord
+ {
+  ComponentType mType;          ///< Kind of component
+  uint32_t mImage;              ///< Image file name or NoString
+  double mX;                    ///< X position
+  double mY;                    ///< Y position
+  double mParameters[MaxParameters];  ///< Parameters in description file order
+ };
+
+ /// One connection between two components
+ struct LinkRecord
+ {
+  LinkType mType;               ///< Kind of connection
+  uint32_t mFrom;               ///< Driving component or cam
+  uint32_t mTo;                 ///< Driven component or listener
+  uint32_t mReserved;           ///< Keeps the value 8 byte aligned
+  double mValue;                ///< Belt slip, otherwise unused
+ };
+
+private:
+ /// The snapshot, allocated as 8 byte words so the records are aligned
+ std::unique_ptr<uint64_t[]> mBuffer;
+
+ /// Size of the snapshot in bytes
+ size_t mSize = 0;
+
+ const Header* GetHeader() const {return reinterpret_cast<const Header*>(mBuffer.get());}
+ const char* GetBytes() const {return reinterpret_cast<const char*>(mBuffer.get());}
+ size_t GetLinksOffset() const;
+ size_t GetDrawOffset() const;
+ size_t GetStringsOffset() const;
+
+public:
+ MachineSnapshot() = default;
+
+ void Create(const std::vector<ComponentRecord>& components,
+         const std::vector<LinkRecord>& links,
+         const std::vector<uint32_t>& drawOrder,
+         const std::string& strings);
+
+ void* Allocate(size_t size);
+ bool Validate() const;
+
+ static bool IsSource(ComponentType type);
+ static bool IsSink(ComponentType type);
+ static bool IsListener(ComponentType type);
+ static const wchar_t* CheckComponent(const ComponentRecord& component);
+ static const wchar_t* CheckLink(const LinkRecord& link, ComponentType from, ComponentType to);
+
+ /// Get the snapshot bytes, for writing to a file
+ /// @return Pointer to the start of the snapshot
+ const void* GetData() const {return mBuffer.get();}
+
+ /// Get the size of the snapshot
+ /// @return Size in bytes
+ size_t GetSize() const {return mSize;}
+
+ /// Get the number of components
+ /// @return Component count
+ size_t GetComponentCount() const {return GetHeader()->mComponentCount;}
+
+ /// Get the component records
+ /// @return Pointer to the first of GetComponentCount() records
+ const ComponentRecord* GetComponents() const
+ {
+  return reinterpret_cast<const ComponentRecord*>(GetBytes() + sizeof(Header));
+ }
+
+ /// Get the number of links
+ /// @return Link count
+ size_t GetLinkCount() const {return GetHeader()->mLinkCount;}
+
+ /// Get the link records
+ /// @return Pointer to the first of GetLinkCount() records
+ const LinkRecord* GetLinks() const
+ {
+  return reinterpret_cast<const LinkRecord*>(GetBytes() + GetLinksOffset());
+ }
+
+ /// Get the number of entries in the draw order
+ /// @return Draw order length
+ size_t GetDrawCount() const {return GetHeader()->mDrawCount;}
+
+ /// Get the order the components are drawn in
+ /// @return Pointer to the first of GetDrawCount() component indices
+ const uint32_t* GetDrawOrder() const
+ {
+  return reinterpret_cast<const uint32_t*>(GetBytes() + GetDrawOffset());
+ }
+
+ const char* GetString(uint32_t offset) const;
+};
+
+
+
+#endif //MACHINESNAPSHOT_H
@@ -9,6 +9,15 @@
 #include "Machine.h"
 #include "Machine1Factory.h"
 #include "Machine2Factory.h"
+#include "MachineLoader.h"
+#include "ImageCache.h"
+#include "WxRenderer.h"
+#include <algorithm>
+#include <cmath>
+
+/// Number of machine systems that exist. The last one to be
+/// destroyed releases the graphics bitmaps its machines shared.
+static std::atomic<int> MachineSystems(0);
 
 /**
  * Constructor
@@ -16,9 +25,30 @@
  */
 MachineSystem::MachineSystem(const std::wstring& resourcesDir) : mResourcesDir(resourcesDir)
 {
+ MachineSystems++;
+ mRegistry.Scan(mResourcesDir);
  ChooseMachine(1);
 }
 
+/**
+ * Destructor
+ */
+MachineSystem::~MachineSystem()
+{
+ CancelPendingMachine();
+ for (auto& builder : mBuilders)
+ {
+  builder.mThread.join();
+ }
+
+ // Graphics bitmaps may not outlive wxWidgets, which hosts clean up
+ // once they are done with their machine systems
+ if (--MachineSystems == 0)
+ {
+  cse335::ImageCache::Get().ClearBitmaps();
+ }
+}
+
 
 /**
  * Get the location of hte machine
@@ -35,14 +65,70 @@ wxPoint MachineSystem::GetLocation()
 */
 void MachineSystem::DrawMachine(std::shared_ptr<wxGraphicsContext> graphics)
 {
+ WxRenderer renderer(graphics);
+ DrawMachine(renderer);
+
+ if (mProfileOverlay)
+ {
+  DrawProfileOverlay(graphics);
+ }
+
+}
+
+/**
+ * Draw the machine at the currently specified location with any
+ * renderer. The profile overlay is only drawn on a graphics context.
+ * @param renderer Renderer to draw with
+ */
+void MachineSystem::DrawMachine(IRenderer& renderer)
+{
+ AdoptPendingMachine();
+
  // This will put the machine where it is supposed to be drawn
- graphics->PushState();
- graphics->Translate(mLocation.x, mLocation.y);
+ renderer.PushState();
+ renderer.Translate(mLocation.x, mLocation.y);
 
- mMachine->Draw(graphics);
+ mMachine->Draw(renderer);
 
- graphics->PopState();
+ renderer.PopState();
 
+ mDrawnMachine = mMachine;
+ mDrawnLocation = mLocation;
+ mDrawnBounds = mMachine->GetBoundingBox();
+ mDrawnBounds.Offset(mLocation);
+}
+
+/**
+ * Get the area DrawMachine has to repaint to show the machine as it
+ * is now. A host can invalidate just this area after setting a frame.
+ * @return Dirty rectangle in the coordinates DrawMachine draws in,
+ * empty if nothing changed since the last DrawMachine call
+ */
+wxRect MachineSystem::GetDirtyRect()
+{
+ AdoptPendingMachine();
+
+ // A different machine or location repaints everything
+ wxRect dirty;
+ if (mMachine != mDrawnMachine || mLocation != mDrawnLocation)
+ {
+  dirty = mMachine->GetBoundingBox();
+  dirty.Offset(mLocation);
+  dirty.Union(mDrawnBounds);
+ }
+ else
+ {
+  dirty = mMachine->GetDirtyRect();
+  dirty.Offset(mLocation);
+ }
+
+ // The timings change every frame
+ if (mProfileOverlay && !mProfileOverlayRect.IsEmpty())
+ {
+  dirty.Union(mProfileOverlayRect);
+ }
+
+ return dirty;
 }
 
 /**
@@ -51,20 +137,151 @@ void MachineSystem::DrawMachine(std::shared_ptr<wxGraphicsContext> graphics)
 */
 void MachineSystem::SetMachineFrame(int frame)
 {
- if (frame < mFrame)
+ SetMachineTime(frame / mFrameRate);
+}
+
+/**
+ * Set the machine to a time. The machine is stepped at the tick
+ * rate whatever the frame rate, so it reaches the same state however
+ * it got to the time. A time between ticks is stepped to from the
+ * tick before it, and that tick's state is kept to step on from.
+ * @param seconds Machine time in seconds
+ */
+void MachineSystem::SetMachineTime(double seconds)
+{
+ AdoptPendingMachine();
+ seconds = std::max(seconds, 0.0);
+
+ // A machine with closed form components can go straight to any time
+ auto mechanism = mMachine->GetMechanism();
+ if (mEvaluateDirectly && mechanism->CanEvaluate())
+ {
+  mTime = seconds;
+  mTick = -1;
+  mBetweenTicks = false;
+  mechanism->EvaluateAt(mTime);
+  return;
+ }
+
+ if (mBetweenTicks)
+ {
+  mMachine->RestoreState(mTickState);
+  mBetweenTicks = false;
+ }
+
+ // The allowance keeps a time on a tick from rounding to the one before
+ int tick = (int)std::floor(seconds * mTickRate + 1e-6);
+ if (mTick < 0 || tick < mTick)
  {
   Reset();
  }
 
- while (mFrame < frame) {
-  mFrame++;
-  mTime = mFrame / mFrameRate;
-  mMachine->Advance(1.0/ mFrameRate);  // Advance components
+ // Skip ahead to the closest checkpoint rather than replaying every tick
+ int checkpointTick = 0;
+ auto checkpoint = mCheckpoints.Nearest(tick, &checkpointTick);
+ if (checkpoint != nullptr && checkpointTick > mTick)
+ {
+  mMachine->RestoreState(*checkpoint);
+  mTick = checkpointTick;
+ }
+
+ std::vector<double> state;
+ while (mTick < tick) {
+  mTick++;
+  mMachine->Advance(1.0 / mTickRate);  // Advance components
+
+  if (mCheckpoints.IsDue(mTick))
+  {
+   state.clear();
+   mMachine->SaveState(state);
+   mCheckpoints.Store(mTick, state);
+  }
+ }
+
+ double remainder = seconds - mTick / mTickRate;
+ if (remainder > 1e-9)
+ {
+  mTickState.clear();
+  mMachine->SaveState(mTickState);
+  mMachine->Advance(remainder);
+  mBetweenTicks = true;
+ }
+
+ mTime = seconds;
+}
+
+/**
+ * Get the recent timings of every component
+ * @param phase Advance or draw timings
+ * @return Statistics per component, empty if profiling is not compiled in
+ */
+std::vector<FrameProfiler::Stats> MachineSystem::GetFrameStats(FrameProfiler::Phase phase)
+{
+ auto profiler = mMachine->GetProfiler();
+ if (profiler == nullptr)
+ {
+  return {};
  }
+
+ return profiler->GetStats(phase);
 }
 
 /**
- * Set the expected frame rate in frames per second
+ * Draw a table of the component timings in the top left corner
+ * @param graphics Graphics context to draw on
+ */
+void MachineSystem::DrawProfileOverlay(std::shared_ptr<wxGraphicsContext> graphics)
+{
+ auto advance = GetFrameStats(FrameProfiler::Phase::Advance);
+ auto draw = GetFrameStats(FrameProfiler::Phase::Draw);
+ if (draw.empty())
+ {
+  return;
+ }
+
+ const int LineHeight = 14;
+ graphics->SetPen(*wxTRANSPARENT_PEN);
+ graphics->SetBrush(wxBrush(wxColour(0, 0, 0, 160)));
+ mProfileOverlayRect = wxRect(0, 0, 330, LineHeight * (draw.size() + 4) + 8);
+ graphics->DrawRectangle(mProfileOverlayRect.x, mProfileOverlayRect.y,
+                         mProfileOverlayRect.width, mProfileOverlayRect.height);
+
+ wxFont font(wxSize(0, 11), wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+ graphics->SetFont(font, *wxWHITE);
+ graphics->DrawText(wxString::Format(L"%-8s %8s %8s %8s %8s",
+                                    L"us", L"adv p95", L"draw avg", L"p95", L"max"), 4, 4);
+ for (size_t i = 0; i < draw.size(); i++)
+ {
+  auto line = wxString::Format(L"%-8s %8.1f %8.1f %8.1f %8.1f",
+                               draw[i].mName.c_str(), advance[i].mP95 * 1e6,
+                               draw[i].mMean * 1e6, draw[i].mP95 * 1e6, draw[i].mMax * 1e6);
+  graphics->DrawText(line, 4, 4 + LineHeight * (i + 1));
+ }
+
+ // The components only record their drawing, so the time to
+ // optimize the draw list and replay it is shown for the frame
+ auto profiler = mMachine->GetProfiler();
+ int row = (int)draw.size() + 1;
+ for (auto phase : {FrameProfiler::FramePhase::Optimize, FrameProfiler::FramePhase::Replay})
+ {
+  auto frame = profiler->GetFrameStats(phase);
+  auto line = wxString::Format(L"%-8s %8s %8.1f %8.1f %8.1f", frame.mName.c_str(), L"",
+                               frame.mMean * 1e6, frame.mP95 * 1e6, frame.mMax * 1e6);
+  graphics->DrawText(line, 4, 4 + LineHeight * row++);
+ }
+
+ // Graphics context calls the components made, and how many
+ // were left to make after the draw list was optimized
+ auto calls = profiler->GetDrawCalls();
+ graphics->DrawText(wxString::Format(L"%-8s %8lu -> %lu", L"calls",
+                                    (unsigned long)calls.mRecorded, (unsigned long)calls.mReplayed),
+                    4, 4 + LineHeight * row);
+}
+
+/**
+ * Set the expected frame rate in frames per second. This only
+ * changes the time of each frame, the machine is stepped at the
+ * tick rate.
  * @param rate Frame rate in frames per second
  */
 void MachineSystem::SetFrameRate(double rate)
@@ -73,23 +290,338 @@ void MachineSystem::SetFrameRate(double rate)
 }
 
 /**
-* Set the machine number
+ * Set how often the machine is stepped, independent of the frame rate.
+ * The machine is stepped again at the new rate when it is next set.
+ * @param rate Ticks per second
+ */
+void MachineSystem::SetTickRate(double rate)
+{
+ if (rate == mTickRate)
+ {
+  return;
+ }
+
+ // Checkpoints were taken with the old tick duration
+ mCheckpoints.Clear();
+ for (auto& cached : mMachineCache)
+ {
+  cached.mCheckpoints.Clear();
+ }
+
+ // The machine is stepped again from zero the next time it is set
+ mTickRate = rate;
+ mTick = -1;
+ mBetweenTicks = false;
+}
+
+/**
+* Set the machine number. Machines that were chosen recently are
+* reused rather than rebuilt, and are brought to the current frame.
 * @param machine An integer number. Each number makes a different machine
 */
 void MachineSystem::ChooseMachine(int machine)
 {
+ // This choice replaces any made while a machine is being built
+ CancelPendingMachine();
+
+ if (!ReuseMachine(machine))
+ {
+  UseMachine(machine, BuildMachine(mRegistry, mResourcesDir, machine));
+ }
+}
+
+/**
+ * Choose a machine without blocking while it is built. The current
+ * machine is still drawn until the new one is ready, and the new one
+ * is swapped in by the next DrawMachine or SetMachineFrame call, so
+ * the swap happens on the thread that draws.
+ *
+ * The ready function is called once the machine is built. In a
+ * program with a wxApp it is queued to the GUI thread with CallAfter,
+ * so it may refresh windows. Without one it is called on the building
+ * thread and must do its own marshalling. It is called right away if
+ * the machine is already built, and not at all if another choice
+ * replaces this one or the system is destroyed before it runs. A
+ * replaced build is not waited for.
+ *
+ * @param machine Machine number
+ * @param ready Function to call when the machine is ready, may be empty
+ */
+void MachineSystem::ChooseMachineAsync(int machine, std::function<void()> ready)
+{
+ CancelPendingMachine();
+
+ if (ReuseMachine(machine))
+ {
+  if (ready)
+  {
+   ready();
+  }
+  return;
+ }
+
+ JoinFinishedBuilders();
+
+ // The builder gets its own copies so it shares only the result with this object
+ auto pending = std::make_shared<PendingMachine>();
+ pending->mNumber = machine;
+ mPendingMachine = pending;
+ std::thread thread([pending, registry = mRegistry, resourcesDir = mResourcesDir, machine, ready]() {
+  auto built = BuildMachine(registry, resourcesDir, machine);
+  {
+   std::lock_guard<std::mutex> lock(pending->mMutex);
+   pending->mMachine = built;
+  }
+
+  if (ready && !pending->mCancelled)
+  {
+   if (wxTheApp != nullptr)
+   {
+    // Only the GUI thread may touch windows. The pending machine outlives
+    // the system, so a choice cancelled meanwhile is still seen.
+    wxTheApp->CallAfter([pending, ready]() {
+     if (!pending->mCancelled)
+     {
+      ready();
+     }
+    });
+   }
+   else
+   {
+    ready();
+   }
+  }
+  pending->mFinished = true;
+ });
+ mBuilders.push_back({std::move(thread), pending});
+}
+
+/**
+ * Is a machine chosen with ChooseMachineAsync still being built?
+ * @return true if the current machine is about to be replaced
+ */
+bool MachineSystem::IsMachinePending() const
+{
+ return mPendingMachine != nullptr;
+}
+
+/**
+ * Swap in a machine built in the background once it is ready
+ */
+void MachineSystem::AdoptPendingMachine()
+{
+ if (mPendingMachine == nullptr)
+ {
+  return;
+ }
+
+ std::shared_ptr<Machine> machine;
+ {
+  std::lock_guard<std::mutex> lock(mPendingMachine->mMutex);
+  machine = mPendingMachine->mMachine;
+ }
+
+ if (machine == nullptr)
+ {
+  return;
+ }
+
+ int number = mPendingMachine->mNumber;
+ mPendingMachine = nullptr;
+ UseMachine(number, machine);
+}
+
+/**
+ * Discard any machine being built in the background. This does not
+ * wait for the build, which finishes on its own and is thrown away.
+ */
+void MachineSystem::CancelPendingMachine()
+{
+ if (mPendingMachine != nullptr)
+ {
+  mPendingMachine->mCancelled = true;
+  mPendingMachine = nullptr;
+ }
+}
+
+/**
+ * Join the builder threads that have already finished
+ */
+void MachineSystem::JoinFinishedBuilders()
+{
+ for (auto builder = mBuilders.begin(); builder != mBuilders.end(); )
+ {
+  if (builder->mPending->mFinished)
+  {
+   builder->mThread.join();
+   builder = mBuilders.erase(builder);
+  }
+  else
+  {
+   ++builder;
+  }
+ }
+}
+
+/**
+ * Make a kept machine the current machine
+ * @param machine Machine number
+ * @return false if the machine is not kept
+ */
+bool MachineSystem::ReuseMachine(int machine)
+{
+ auto cached = std::find_if(mMachineCache.begin(), mMachineCache.end(),
+         [machine](const CachedMachine& cached) {return cached.mNumber == machine;});
+ if (cached == mMachineCache.end())
+ {
+  return false;
+ }
+
+ auto interval = mCheckpoints.GetInterval();
+ auto budget = mCheckpoints.GetBudget();
+ LeaveMachine();
+
  mMachineNumber = machine;
- if(machine == 1)
+ mMachineCache.splice(mMachineCache.begin(), mMachineCache, cached);
+ mMachine = mMachineCache.front().mMachine;
+ mCheckpoints = std::move(mMachineCache.front().mCheckpoints);
+ CatchUp(interval, budget);
+ return true;
+}
+
+/**
+ * Make a newly built machine the current machine and keep it
+ * @param machine Machine number
+ * @param built The built machine
+ */
+void MachineSystem::UseMachine(int machine, std::shared_ptr<Machine> built)
+{
+ auto interval = mCheckpoints.GetInterval();
+ auto budget = mCheckpoints.GetBudget();
+ LeaveMachine();
+
+ mMachineNumber = machine;
+ mMachine = built;
+ mCheckpoints = MachineCheckpoints();
+ if (mMachineCacheSize > 0)
  {
-  Machine1Factory factory(mResourcesDir);
-  mMachine = factory.Create();
+  mMachineCache.push_front({machine, mMachine, MachineCheckpoints()});
+  TrimMachineCache();
  }
- else
+
+ CatchUp(interval, budget);
+}
+
+/**
+ * Keep the checkpoints of the machine being left with it
+ */
+void MachineSystem::LeaveMachine()
+{
+ if (!mMachineCache.empty() && mMachineCache.front().mMachine == mMachine)
+ {
+  mMachineCache.front().mCheckpoints = std::move(mCheckpoints);
+ }
+}
+
+/**
+ * Bring a newly chosen machine to the current time
+ * @param interval Checkpoint interval in use before the machine was chosen
+ * @param budget Checkpoint budget in use before the machine was chosen
+ */
+void MachineSystem::CatchUp(int interval, size_t budget)
+{
+ // Settings apply to every machine, which may discard
+ // checkpoints taken with other settings
+ mCheckpoints.SetInterval(interval);
+ mCheckpoints.SetBudget(budget);
+
+ double time = mTime;
+ Reset();
+ SetMachineTime(time);
+}
+
+/**
+ * Build a machine, from its description file if it has one.
+ * Uses nothing but its arguments, so it can run on any thread.
+ * @param registry Machine description files
+ * @param resourcesDir Path to the resources directory
+ * @param machine Machine number
+ * @return The compiled machine, with its images decoded
+ */
+std::shared_ptr<Machine> MachineSystem::BuildMachine(const MachineRegistry& registry,
+        const std::wstring& resourcesDir, int machine)
+{
+ std::shared_ptr<Machine> built;
+
+ // Machines with a description file are built from it, and the
+ // factories cover any that do not have one or fail to load
+ auto filename = registry.Find(machine);
+ if (!filename.empty())
+ {
+  MachineLoader loader(resourcesDir);
+  built = loader.Load(filename);
+ }
+
+ if (built == nullptr)
+ {
+  if(machine == 1)
+  {
+   Machine1Factory factory(resourcesDir);
+   built = factory.Create();
+  }
+  else
+  {
+   Machine2Factory factory(resourcesDir);
+   built = factory.Create();
+  }
+ }
+
+ // Decoding here keeps it off the thread that draws the first frame
+ built->Compile();
+ built->LoadImages();
+ return built;
+}
+
+/**
+ * Set how many built machines are kept for reuse. Each machine
+ * holds at most the checkpoint budget of states, and its images
+ * are shared through the image cache, so this bounds the memory
+ * the kept machines use.
+ * @param machines Most machines to keep, 0 to rebuild on every choice
+ */
+void MachineSystem::SetMachineCacheSize(size_t machines)
+{
+ mMachineCacheSize = machines;
+ TrimMachineCache();
+}
+
+/**
+ * Drop the least recently chosen machines over the cache size
+ */
+void MachineSystem::TrimMachineCache()
+{
+ if (mMachineCache.size() <= mMachineCacheSize)
  {
-  Machine2Factory factory(mResourcesDir);
-  mMachine = factory.Create();
+  return;
  }
 
+ mMachineCache.resize(mMachineCacheSize);
+
+ // Release images only the dropped machines were using
+ cse335::ImageCache::Get().EvictUnused();
+}
+
+/**
+ * Use a machine that was not built by one of the machine
+ * factories. The machine starts again from frame zero.
+ * @param machine Machine to use
+ */
+void MachineSystem::SetMachine(std::shared_ptr<Machine> machine)
+{
+ mCheckpoints.Clear();
+ mMachine = machine;
+ mMachine->Compile();
+ Reset();
 }
 
 /**
@@ -110,6 +642,17 @@ double MachineSystem::GetMachineTime()
  return mTime;
 }
 
+/**
+ * Get when the current machine's keys drop as it runs from time zero.
+ * The schedule is solved again whenever a crank speed changes.
+ * @return Key drops in time order
+ */
+std::vector<Mechanism::Event> MachineSystem::GetEventSchedule()
+{
+ AdoptPendingMachine();
+ return mMachine->GetMechanism()->GetSchedule();
+}
+
 /**
  * Set the flag from the control panel
  * @param flag Flag to set
@@ -125,10 +668,29 @@ void MachineSystem::SetFlag(int flag)
 void MachineSystem::Reset()
 {
  mTime = 0.0;
- mFrame = 0;
+ mTick = 0;
+ mBetweenTicks = false;
  mMachine->Reset(); // Reset all components within the machine
 }
 
+/**
+ * Set how many ticks apart machine state checkpoints are taken
+ * @param ticks Ticks between checkpoints, 0 disables checkpointing
+ */
+void MachineSystem::SetCheckpointInterval(int ticks)
+{
+ mCheckpoints.SetInterval(ticks);
+}
+
+/**
+ * Set the memory budget for machine state checkpoints
+ * @param bytes Maximum bytes used by checkpoints
+ */
+void MachineSystem::SetCheckpointBudget(size_t bytes)
+{
+ mCheckpoints.SetBudget(bytes);
+}
+
 /**
  * Set the location
  * @param location
@@ -8,8 +8,18 @@
 #ifndef MACHINESYSTEM_H
 #define MACHINESYSTEM_H
 #include "IMachineSystem.h"
+#include "MachineCheckpoints.h"
+#include "FrameProfiler.h"
+#include "MachineRegistry.h"
+#include "Mechanism.h"
+#include <atomic>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
 
 class Machine;
+class IRenderer;
 
 /// Implements the `IMachineSystem` interface to manage a machine's state
 class MachineSystem : public IMachineSystem {
@@ -32,24 +42,152 @@ private:
  ///Time
  double mTime = 0.0;
 
- /// frame
- double mFrame;
+ /// Simulation ticks per second, independent of the frame rate
+ double mTickRate = 30;
 
+ /// Number of whole ticks the machine has been stepped, negative
+ /// if it was evaluated directly and must be stepped again from zero
+ int mTick = 0;
 
+ /// State of the machine at mTick while it is stepped past it
+ std::vector<double> mTickState;
 
+ /// Has the machine been stepped past mTick to a time between ticks?
+ bool mBetweenTicks = false;
+
+ /// Description files for the machines that have them
+ MachineRegistry mRegistry;
+
+ /// Periodic snapshots of the machine state used for seeking
+ MachineCheckpoints mCheckpoints;
+
+ /// A built machine kept so choosing it again does not rebuild it
+ struct CachedMachine
+ {
+  int mNumber;                      ///< Machine number
+  std::shared_ptr<Machine> mMachine;    ///< The machine
+  MachineCheckpoints mCheckpoints;  ///< Its checkpoints while it is not chosen
+ };
+
+ /// Built machines, most recently chosen first
+ std::list<CachedMachine> mMachineCache;
+
+ /// Most machines kept in the cache
+ size_t mMachineCacheSize = 4;
+
+ /// A machine chosen with ChooseMachineAsync, shared with the
+ /// thread building it so a cancelled build can finish on its own
+ struct PendingMachine
+ {
+  int mNumber = 0;                          ///< Machine number
+  std::atomic<bool> mCancelled{false};      ///< Has another choice replaced it?
+  std::atomic<bool> mFinished{false};       ///< Has its thread finished?
+  std::mutex mMutex;                        ///< Protects mMachine
+  std::shared_ptr<Machine> mMachine;        ///< The machine once it is built
+ };
+
+ /// A thread building a machine
+ struct Builder
+ {
+  std::thread mThread;                      ///< The thread
+  std::shared_ptr<PendingMachine> mPending; ///< What it is building
+ };
+
+ /// Threads building machines, including cancelled ones, not yet joined
+ std::list<Builder> mBuilders;
+
+ /// The machine most recently chosen with ChooseMachineAsync, if not yet adopted
+ std::shared_ptr<PendingMachine> mPendingMachine;
+
+ /// Seek by evaluating the machine at the frame time when every component allows it
+ bool mEvaluateDirectly = true;
+
+ /// Draw the component timings over the machine
+ bool mProfileOverlay = false;
+
+ /// The machine as of the last DrawMachine call
+ std::shared_ptr<Machine> mDrawnMachine;
+
+ /// Where the last drawn machine was drawn
+ wxRect mDrawnBounds;
+
+ /// Location of the last drawn machine
+ wxPoint mDrawnLocation;
+
+ /// Area covered by the timings table when it was last drawn
+ wxRect mProfileOverlayRect;
+
+ void DrawProfileOverlay(std::shared_ptr<wxGraphicsContext> graphics);
+ void TrimMachineCache();
+ void AdoptPendingMachine();
+ void CancelPendingMachine();
+ void JoinFinishedBuilders();
+ bool ReuseMachine(int machine);
+ void UseMachine(int machine, std::shared_ptr<Machine> built);
+ void LeaveMachine();
+ void CatchUp(int interval, size_t budget);
+ static std::shared_ptr<Machine> BuildMachine(const MachineRegistry& registry,
+         const std::wstring& resourcesDir, int machine);
 
 public:
  MachineSystem(const std::wstring& resourcesDir);
+ ~MachineSystem();
+
  void SetLocation(wxPoint location) override;
  wxPoint GetLocation() override;
  void DrawMachine(std::shared_ptr<wxGraphicsContext> graphics) override;
+ void DrawMachine(IRenderer& renderer);
  void SetMachineFrame(int frame) override;
+ void SetMachineTime(double seconds);
  void SetFrameRate(double rate) override;
+ void SetTickRate(double rate);
  void ChooseMachine(int machine)override;
+ void ChooseMachineAsync(int machine, std::function<void()> ready = nullptr);
+ bool IsMachinePending() const;
+ void SetMachine(std::shared_ptr<Machine> machine);
  int GetMachineNumber() override;
  double GetMachineTime() override;
  void SetFlag(int flag) override;
  void Reset();
+
+ void SetMachineCacheSize(size_t machines);
+ wxRect GetDirtyRect();
+
+ /// Get the number of built machines being kept
+ /// @return Number of cached machines
+ size_t GetMachineCacheCount() const {return mMachineCache.size();}
+
+ void SetCheckpointInterval(int ticks);
+ void SetCheckpointBudget(size_t bytes);
+
+ /// Get the simulation rate
+ /// @return Ticks per second
+ double GetTickRate() const {return mTickRate;}
+
+ /// Choose whether seeks evaluate the machine directly at the frame time.
+ /// When false, seeks always step tick by tick from a checkpoint.
+ /// @param direct true to evaluate directly when the machine allows it
+ void SetEvaluateDirectly(bool direct) {mEvaluateDirectly = direct;}
+
+ std::vector<FrameProfiler::Stats> GetFrameStats(FrameProfiler::Phase phase);
+ std::vector<Mechanism::Event> GetEventSchedule();
+
+ /// Choose whether to draw the component timings over the machine.
+ /// Only has an effect when built with MACHINE_PROFILING.
+ /// @param show true to draw the timings
+ void SetProfileOverlay(bool show) {mProfileOverlay = show;}
+
+ /// Get the checkpoint store
+ /// @return MachineCheckpoints
+ const MachineCheckpoints& GetCheckpoints() const {return mCheckpoints;}
+
+ /// Get the registry of machine description files
+ /// @return MachineRegistry
+ MachineRegistry& GetRegistry() {return mRegistry;}
+
+ /// Get the current machine
+ /// @return Machine
+ std::shared_ptr<Machine> GetMachine() {return mMachine;}
 };
 
 
@@ -0,0 +1,384 @@
+/**
+ * @file Mechanism.cpp
+ * @author Thomas Conley
+ */
+
+#include "Mechanism.h"
+#include <algorithm>
+#include "CrankModel.h"
+#include "RotatingModel.h"
+#include "CamModel.h"
+#include "BoxModel.h"
+#include "SpartyModel.h"
+#include "BannerModel.h"
+
+/**
+ * Destructor
+ */
+Mechanism::~Mechanism()
+{
+ // The models may outlive the mechanism, so they take their state back
+ Unpool();
+}
+
+/**
+ * Add a model to the mechanism. A model that is already
+ * part of the mechanism is not added again, so it is only
+ * advanced once per step.
+ * @param model Model to add
+ */
+void Mechanism::AddModel(std::shared_ptr<ComponentModel> model)
+{
+ if (std::find(mModels.begin(), mModels.end(), model) == mModels.end())
+ {
+  mModels.push_back(model);
+  mPooled = false;
+  mScheduled = false;
+ }
+}
+
+/**
+ * Sort the models into the pool for their type
+ */
+void Mechanism::Pool()
+{
+ Unpool();
+ mCranks.clear();
+ mCams.clear();
+ mBoxes.clear();
+ mSparties.clear();
+ mBanners.clear();
+ mOthers.clear();
+
+ // Indices of the models in each pool, in the order the pools are advanced
+ std::vector<size_t> order[6];
+ for (size_t i = 0; i < mModels.size(); i++)
+ {
+  auto pointer = mModels[i].get();
+  if (auto crank = dynamic_cast<CrankModel*>(pointer))
+  {
+   mCranks.push_back(crank);
+   order[0].push_back(i);
+  }
+  else if (auto cam = dynamic_cast<CamModel*>(pointer))
+  {
+   mCams.push_back(cam);
+   order[1].push_back(i);
+  }
+  else if (auto box = dynamic_cast<BoxModel*>(pointer))
+  {
+   mBoxes.push_back(box);
+   order[2].push_back(i);
+  }
+  else if (auto sparty = dynamic_cast<SpartyModel*>(pointer))
+  {
+   mSparties.push_back(sparty);
+   order[3].push_back(i);
+  }
+  else if (auto banner = dynamic_cast<BannerModel*>(pointer))
+  {
+   mBanners.push_back(banner);
+   order[4].push_back(i);
+  }
+  else if (dynamic_cast<RotatingModel*>(pointer) == nullptr)
+  {
+   mOthers.push_back(pointer);
+   order[5].push_back(i);
+  }
+ }
+
+ mAdvanceOrder.clear();
+ for (const auto& pool : order)
+ {
+  mAdvanceOrder.insert(mAdvanceOrder.end(), pool.begin(), pool.end());
+ }
+
+ // The arrays are sized before any state moves in, so the entries stay put
+ mCrankStates.resize(mCranks.size());
+ for (size_t i = 0; i < mCranks.size(); i++)
+ {
+  mCranks[i]->GetState().Pool(&mCrankStates[i]);
+ }
+
+ mClocks.resize(mBoxes.size() + mSparties.size() + mBanners.size());
+ auto clock = mClocks.data();
+ for (auto box : mBoxes)
+ {
+  box->GetClock().Pool(clock++);
+ }
+
+ for (auto sparty : mSparties)
+ {
+  sparty->GetClock().Pool(clock++);
+ }
+
+ for (auto banner : mBanners)
+ {
+  banner->GetClock().Pool(clock++);
+ }
+
+ mPooled = true;
+}
+
+/**
+ * Move the pooled state back into the models
+ */
+void Mechanism::Unpool()
+{
+ for (auto crank : mCranks)
+ {
+  crank->GetState().Unpool();
+ }
+
+ for (auto box : mBoxes)
+ {
+  box->GetClock().Unpool();
+ }
+
+ for (auto sparty : mSparties)
+ {
+  sparty->GetClock().Unpool();
+ }
+
+ for (auto banner : mBanners)
+ {
+  banner->GetClock().Unpool();
+ }
+
+ mCrankStates.clear();
+ mClocks.clear();
+}
+
+/**
+ * Prepare every model to run. Call this once the
+ * machine is built and again if it is changed.
+ */
+void Mechanism::Compile()
+{
+ for (const auto& model : mModels)
+ {
+  model->Compile();
+ }
+
+ Pool();
+ mScheduled = false;
+}
+
+/**
+ * Advance every model. The cranks go first so everything
+ * they turn is at its new rotation before the rest step.
+ * @param delta Time to advance in seconds
+ */
+void Mechanism::Advance(double delta)
+{
+ if (!mPooled)
+ {
+  Pool();
+ }
+
+ for (auto& crank : mCrankStates)
+ {
+  crank.mRotation += delta * crank.mSpeed;
+ }
+
+ for (auto crank : mCranks)
+ {
+  crank->Turn();
+ }
+
+ for (auto cam : mCams)
+ {
+  cam->Advance(delta);
+ }
+
+ // The boxes, Sparties and banners only step their clocks
+ for (auto& clock : mClocks)
+ {
+  clock += delta;
+ }
+
+ for (auto model : mOthers)
+ {
+  model->Advance(delta);
+ }
+}
+
+/**
+ * Solve for when each cam drops its key. The cranks turn at a constant
+ * speed from zero, so each cam turns at a constant rate from its offset
+ * along the path from its crank, and the drop is where that rate first
+ * carries the hole under the key.
+ */
+void Mechanism::Schedule()
+{
+ if (!mPooled)
+ {
+  Pool();
+ }
+
+ mSchedule.clear();
+ mScheduleSpeeds.clear();
+ for (auto cam : mCams)
+ {
+  // A cam that starts with the hole under the key drops it at once
+  double time = CamModel::FindDrop(cam->GetStartingAngle(), 0);
+  for (auto crank : mCranks)
+  {
+   if (time >= 0)
+   {
+    break;
+   }
+
+   // A crank that has not been compiled is flattened just to look
+   RotationGraph uncompiled;
+   const RotationGraph* graph = &crank->GetRotationGraph();
+   if (!graph->IsCompiled())
+   {
+    uncompiled.Compile(crank->GetSource());
+    graph = &uncompiled;
+   }
+
+   int sink = graph->Find(cam);
+   if (sink >= 0)
+   {
+    time = CamModel::FindDrop(graph->GetOffset(sink), crank->GetSpeed() * graph->GetScale(sink));
+   }
+   uncompiled.Clear();
+  }
+
+  cam->SetDropTime(time);
+  if (time >= 0)
+  {
+   mSchedule.push_back({cam, time});
+  }
+ }
+
+ std::sort(mSchedule.begin(), mSchedule.end(),
+         [](const Event& a, const Event& b) {return a.mTime < b.mTime;});
+
+ for (auto crank : mCranks)
+ {
+  mScheduleSpeeds.push_back(crank->GetSpeed());
+ }
+ mScheduled = true;
+}
+
+/**
+ * Get the key drops the mechanism reaches, solving for them again
+ * if the mechanism or any crank speed has changed since the last time
+ * @return Events in time order
+ */
+const std::vector<Mechanism::Event>& Mechanism::GetSchedule()
+{
+ bool current = mScheduled && mPooled && mScheduleSpeeds.size() == mCranks.size();
+ for (size_t i = 0; current && i < mCranks.size(); i++)
+ {
+  current = mScheduleSpeeds[i] == mCranks[i]->GetSpeed();
+ }
+
+ if (!current)
+ {
+  Schedule();
+ }
+
+ return mSchedule;
+}
+
+/**
+ * Get the order Advance steps the models in. Callers that time
+ * each model with AdvanceModel must step them in this order, so
+ * the cranks turn everything before the cams look for the key drop.
+ * @return Indices of the models in the order they were added
+ */
+const std::vector<size_t>& Mechanism::GetAdvanceOrder()
+{
+ if (!mPooled)
+ {
+  Pool();
+ }
+
+ return mAdvanceOrder;
+}
+
+/**
+ * Advance one model, for callers that time each model
+ * @param model Index of the model in the order they were added
+ * @param delta Time to advance in seconds
+ */
+void Mechanism::AdvanceModel(size_t model, double delta)
+{
+ mModels[model]->Advance(delta);
+}
+
+/**
+ * Reset every model to time zero
+ */
+void Mechanism::Reset()
+{
+ for (const auto& model : mModels)
+ {
+  model->Reset();
+ }
+}
+
+/**
+ * Can every model compute its state directly from the machine time?
+ * @return true if EvaluateAt can be used instead of stepping
+ */
+bool Mechanism::CanEvaluate() const
+{
+ for (const auto& model : mModels)
+ {
+  if (!model->CanEvaluate())
+  {
+   return false;
+  }
+ }
+
+ return true;
+}
+
+/**
+ * Set every model directly to its state at a machine time.
+ * Only valid when CanEvaluate is true.
+ * @param time Machine time in seconds
+ */
+void Mechanism::EvaluateAt(double time)
+{
+ GetSchedule();
+
+ for (const auto& model : mModels)
+ {
+  model->EvaluateAt(time);
+ }
+
+ for (const auto& model : mModels)
+ {
+  model->EvaluateEvents(time);
+ }
+}
+
+/**
+ * Save the animation state of every model
+ * @param state Vector to append the model states to
+ */
+void Mechanism::SaveState(std::vector<double>& state)
+{
+ for (const auto& model : mModels)
+ {
+  model->SaveState(state);
+ }
+}
+
+/**
+ * Restore the animation state of every model
+ * @param state State previously filled in by SaveState
+ */
+void Mechanism::RestoreState(const std::vector<double>& state)
+{
+ const double* values = state.data();
+ for (const auto& model : mModels)
+ {
+  values = model->RestoreState(values);
+ }
+}
@@ -0,0 +1,122 @@
+/**
+ * @file Mechanism.h
+ * @author Thomas Conley
+ *
+ * The simulation of a machine without any drawing.
+ */
+ 
+#ifndef MECHANISM_H
+#define MECHANISM_H
+
+#include <memory>
+#include <vector>
+#include "ComponentModel.h"
+#include "CrankModel.h"
+
+class RotatingModel;
+class CamModel;
+class BoxModel;
+class SpartyModel;
+class BannerModel;
+
+/**
+ * The simulation of a machine without any drawing.
+ *
+ * Holds the models of every component in the order they are
+ * advanced. Machine drives one of these, and it can also be
+ * built and stepped on its own for batch simulation.
+ *
+ * The models are also sorted into a pool for each type, so Advance
+ * steps all the cranks, then all the cams and so on with direct
+ * calls instead of a virtual call per model. Rotating models are
+ * turned by their crank and are not stepped at all. mModels keeps
+ * the order for checkpoints and per-model profiling.
+ *
+ * The state the steps change, the crank rotations and speeds and
+ * the clocks of the key drop listeners, moves out of the models
+ * into contiguous arrays, so those steps are loops over plain
+ * values. The models use the state where it lies until the
+ * mechanism is pooled again or destroyed. Cams are stepped through
+ * their pool, since each one checks its own key.
+ *
+ * The key drops are also solved for ahead of time, from the crank
+ * speeds and the ratios through the rotation network, so the
+ * mechanism can be set straight to any time.
+ */
+class Mechanism {
+public:
+ /// A key drop the mechanism reaches when it runs from time zero
+ struct Event {
+  /// Cam whose key drops
+  CamModel* mCam;
+
+  /// Machine time of the drop in seconds
+  double mTime;
+ };
+
+private:
+ /// Models of the components in the order they are advanced
+ std::vector<std::shared_ptr<ComponentModel>> mModels;
+
+ std::vector<CrankModel*> mCranks;      ///< Crank models
+ std::vector<CamModel*> mCams;          ///< Cam models
+ std::vector<BoxModel*> mBoxes;         ///< Box models
+ std::vector<SpartyModel*> mSparties;   ///< Sparty models
+ std::vector<BannerModel*> mBanners;    ///< Banner models
+ std::vector<ComponentModel*> mOthers;  ///< Models of any other type
+
+ /// Rotation and speed of each crank in mCranks
+ std::vector<CrankModel::State> mCrankStates;
+
+ /// Clock of each box, Sparty and banner, in that order
+ std::vector<double> mClocks;
+
+ /// Indices into mModels in the order Advance steps them
+ std::vector<size_t> mAdvanceOrder;
+
+ /// Are the pools up to date with mModels?
+ bool mPooled = false;
+
+ /// Key drops in time order
+ std::vector<Event> mSchedule;
+
+ /// Speed of each crank the schedule was solved for
+ std::vector<double> mScheduleSpeeds;
+
+ /// Has the schedule been solved since the mechanism changed?
+ bool mScheduled = false;
+
+ void Pool();
+ void Unpool();
+ void Schedule();
+
+public:
+ Mechanism() = default;
+ ~Mechanism();
+
+ /// Copy constructor (disabled)
+ Mechanism(const Mechanism &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const Mechanism &) = delete;
+
+ void AddModel(std::shared_ptr<ComponentModel> model);
+ void Compile();
+ void Advance(double delta);
+ void AdvanceModel(size_t model, double delta);
+ const std::vector<size_t>& GetAdvanceOrder();
+ const std::vector<Event>& GetSchedule();
+ void Reset();
+ bool CanEvaluate() const;
+ void EvaluateAt(double time);
+ void SaveState(std::vector<double>& state);
+ void RestoreState(const std::vector<double>& state);
+
+ /// Get the number of models in the mechanism
+ /// @return Model count
+ size_t GetModelCount() const {return mModels.size();}
+};
+
+
+
+#endif //MECHANISM_H
@@ -0,0 +1,147 @@
+/**
+ * @file ParallelRenderer.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "ParallelRenderer.h"
+#include "MachineSystem.h"
+#include "FrameRenderer.h"
+#include "ImageCache.h"
+#include <thread>
+#include <vector>
+
+/**
+ * Constructor
+ * @param resourcesDir Resources directory for the machines
+ * @param width Width of a frame in pixels
+ * @param height Height of a frame in pixels
+ */
+ParallelRenderer::ParallelRenderer(const std::wstring& resourcesDir, int width, int height) :
+    mResourcesDir(resourcesDir), mWidth(width), mHeight(height)
+{
+}
+
+/**
+ * Render a range of frames
+ * @param start First frame to render
+ * @param end Last frame to render
+ * @param writer Called on this thread with each frame in order
+ * @return true if every frame was written
+ */
+bool ParallelRenderer::Render(int start, int end, FrameWriter writer)
+{
+ mBuffer.clear();
+ mNextFrame = start;
+ mStopped = false;
+
+ int nextChunk = start;
+ std::vector<std::thread> workers;
+ for (int i = 0; i < mThreads; i++)
+ {
+  workers.emplace_back(&ParallelRenderer::Worker, this, start, end, &nextChunk);
+ }
+
+ bool written = true;
+ while (written && mNextFrame <= end)
+ {
+  std::unique_ptr<wxImage> image;
+  {
+   std::unique_lock<std::mutex> lock(mMutex);
+   mChanged.wait(lock, [this] {return mBuffer.count(mNextFrame) > 0 || mStopped;});
+   if (mStopped)
+   {
+    written = false;
+    break;
+   }
+
+   image = std::move(mBuffer[mNextFrame]);
+   mBuffer.erase(mNextFrame);
+  }
+
+  written = writer(mNextFrame, *image);
+
+  {
+   std::lock_guard<std::mutex> lock(mMutex);
+   mNextFrame++;
+   mStopped = !written;
+  }
+  mChanged.notify_all();
+ }
+
+ for (auto& worker : workers)
+ {
+  worker.join();
+ }
+
+ mBuffer.clear();
+ return written;
+}
+
+/**
+ * Render chunks of frames until the range is done.
+ *
+ * Each worker has its own machine, so nothing it simulates or
+ * draws is shared with the other workers. The machine seeks to
+ * the start of each chunk, directly when it has a closed form
+ * and by replaying from a checkpoint when it does not.
+ *
+ * @param start First frame to render
+ * @param end Last frame to render
+ * @param nextChunk First frame of the next chunk to take, shared by the workers
+ */
+void ParallelRenderer::Worker(int start, int end, int* nextChunk)
+{
+ // Drop the bitmaps this thread created however it leaves, after
+ // the machine and renderer that use them are gone
+ struct ThreadBitmaps
+ {
+  ~ThreadBitmaps() {cse335::ImageCache::Get().EvictThreadBitmaps();}
+ } threadBitmaps;
+
+ MachineSystem machine(mResourcesDir);
+ machine.ChooseMachine(mMachineNumber);
+ machine.SetFrameRate(mFrameRate);
+
+ FrameRenderer renderer(mWidth, mHeight);
+ renderer.SetScale(mScale);
+ renderer.SetSoftware(mSoftware);
+
+ while (true)
+ {
+  int chunk;
+  {
+   std::lock_guard<std::mutex> lock(mMutex);
+   if (mStopped || *nextChunk > end)
+   {
+    return;
+   }
+
+   chunk = *nextChunk;
+   *nextChunk += mChunkFrames;
+  }
+
+  int chunkEnd = std::min(chunk + mChunkFrames - 1, end);
+  for (int frame = chunk; frame <= chunkEnd; frame++)
+  {
+   {
+    // Don't get too far ahead of the writer
+    std::unique_lock<std::mutex> lock(mMutex);
+    mChanged.wait(lock, [this, frame] {return frame < mNextFrame + mMaxBuffered || mStopped;});
+    if (mStopped)
+    {
+     return;
+    }
+   }
+
+   machine.SetMachineFrame(frame);
+   auto image = std::make_unique<wxImage>(renderer.Render(&machine));
+
+   {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mBuffer[frame] = std::move(image);
+   }
+   mChanged.notify_all();
+  }
+ }
+}
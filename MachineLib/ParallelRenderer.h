@@ -0,0 +1,122 @@
+/**
+ * @file ParallelRenderer.h
+ * @author Thomas Conley
+ *
+ * Renders a range of machine frames on several threads.
+ */
+ 
+#ifndef PARALLELRENDERER_H
+#define PARALLELRENDERER_H
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * Renders a range of machine frames on several threads.
+ *
+ * The range is split into chunks of frames. Each worker thread
+ * builds its own MachineSystem and FrameRenderer, seeks its machine
+ * to the start of each chunk it takes and renders the chunk in
+ * order. Finished frames go through a reorder buffer so the writer
+ * sees them in frame order on the calling thread.
+ */
+class ParallelRenderer {
+public:
+ /// Function that writes a finished frame, returning false to stop
+ typedef std::function<bool(int frame, const wxImage& image)> FrameWriter;
+
+private:
+ /// Resources directory for the machines
+ std::wstring mResourcesDir;
+
+ /// Machine number to render
+ int mMachineNumber = 1;
+
+ /// Frame rate in frames per second
+ double mFrameRate = 30;
+
+ /// Width of a frame in pixels
+ int mWidth;
+
+ /// Height of a frame in pixels
+ int mHeight;
+
+ /// Scale from machine pixels to frame pixels
+ double mScale = 1;
+
+ /// Draw with the software renderer
+ bool mSoftware = false;
+
+ /// Number of worker threads
+ int mThreads = 1;
+
+ /// Number of frames in each chunk
+ int mChunkFrames = 30;
+
+ /// Most frames held waiting to be written
+ int mMaxBuffered = 64;
+
+ /// Rendered frames waiting to be written, by frame number
+ std::map<int, std::unique_ptr<wxImage>> mBuffer;
+
+ /// Next frame the writer needs
+ int mNextFrame = 0;
+
+ /// Set when rendering stops early
+ bool mStopped = false;
+
+ /// Protects the buffer and frame counters
+ std::mutex mMutex;
+
+ /// Signalled when a frame is added or written
+ std::condition_variable mChanged;
+
+ void Worker(int start, int end, int* nextChunk);
+
+public:
+ ParallelRenderer(const std::wstring& resourcesDir, int width, int height);
+
+ /// Copy constructor (disabled)
+ ParallelRenderer(const ParallelRenderer &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const ParallelRenderer &) = delete;
+
+ bool Render(int start, int end, FrameWriter writer);
+
+ /// Set the machine number to render
+ /// @param machine Machine number
+ void SetMachineNumber(int machine) {mMachineNumber = machine;}
+
+ /// Set the frame rate
+ /// @param rate Frame rate in frames per second
+ void SetFrameRate(double rate) {mFrameRate = rate;}
+
+ /// Set the scale from machine pixels to frame pixels
+ /// @param scale Scale, 1 draws the machine at its natural size
+ void SetScale(double scale) {mScale = scale;}
+
+ /// Choose whether to draw with the software renderer
+ /// @param software true for the software renderer
+ void SetSoftware(bool software) {mSoftware = software;}
+
+ /// Set the number of worker threads
+ /// @param threads Thread count, at least 1
+ void SetThreads(int threads) {mThreads = threads > 0 ? threads : 1;}
+
+ /// Set the number of frames each worker renders at a time
+ /// @param frames Frames in a chunk, at least 1
+ void SetChunkFrames(int frames) {mChunkFrames = frames > 0 ? frames : 1;}
+
+ /// Set how many finished frames may wait to be written
+ /// @param frames Frame count, at least one chunk per thread is sensible
+ void SetMaxBuffered(int frames) {mMaxBuffered = frames > 0 ? frames : 1;}
+};
+
+
+
+#endif //PARALLELRENDERER_H
@@ -15,6 +15,7 @@
 #include <wx/hyperlink.h>
 #include <wx/generic/hyperlink.h>
 #include "Polygon.h"
+#include "ImageCache.h"
 
 using namespace cse335;
 
@@ -69,7 +70,7 @@ void Polygon::Rectangle(double x, double y, double width, double height)
     if(width <= 0)
     {
         // Optional automatic width determination from image
-        if(!Assert(mImage != nullptr,
+        if(!Assert(EnsureImage(),
                    L"You must select an image before calling Rectangle with no specified width."))
         {
             return;
@@ -81,7 +82,7 @@ void Polygon::Rectangle(double x, double y, double width, double height)
     if(height <= 0)
     {
         // Optional automatic height determination from image
-        if(!Assert(mImage != nullptr,
+        if(!Assert(EnsureImage(),
                    L"You must select an image before calling Rectangle with no specified height."))
         {
             return;
@@ -119,7 +120,7 @@ void Polygon::BottomCenteredRectangle(double width, double height)
 {
     if(width == 0)
     {
-        if(!Assert(mImage != nullptr,
+        if(!Assert(EnsureImage(),
                    L"You must select an image before calling BottomCenteredRectangle with no width."))
         {
             return;
@@ -129,7 +130,7 @@ void Polygon::BottomCenteredRectangle(double width, double height)
     }
     else if(height == 0)
     {
-        if(!Assert(mImage != nullptr,
+        if(!Assert(EnsureImage(),
                    L"You must select an image before calling BottomCenteredRectangle with no height."))
         {
             return;
@@ -150,7 +151,7 @@ void Polygon::CenteredSquare(double size)
 {
     if(size == 0)
     {
-        if(!Assert(mImage != nullptr,
+        if(!Assert(EnsureImage(),
                    L"You must select an image before calling BottomCenteredRectangle."))
         {
             return;
@@ -204,21 +205,38 @@ void Polygon::SetColor(wxColour color)
  */
 void Polygon::SetImage(std::wstring filename)
 {
-    // Prevent error popup from wxWidgets
-    wxLogNull logNo;
+    mImage = nullptr;
+    mImageFile = filename;
+    mBitmapDirty = true;
+    mMode = Mode::Image;
+}
 
-    mImage = std::make_unique<wxImage>();
-    if(mImage->LoadFile(filename, wxBITMAP_TYPE_ANY))
-    {
-        mMode = Mode::Image;
-    }
-    else
+/**
+ * Load the image set by SetImage if it has not been loaded yet.
+ *
+ * Loading is deferred until the image is first needed so that
+ * polygons can be constructed without decoding any images. This
+ * runs on whatever thread draws or builds the machine, so a failure
+ * is logged, which wxWidgets hands on to the GUI thread, rather
+ * than shown in a dialog box.
+ *
+ * @return true if an image is available
+ */
+bool Polygon::EnsureImage()
+{
+    if(mImage == nullptr && !mImageFile.empty())
     {
-        std::wstringstream str;
-        str << L"Unable to load '" << filename << "'" << std::endl;
-        wxMessageBox(str.str(), L"Polygon Image File Load Failure!");
-        mImage = nullptr;
+        mImage = ImageCache::Get().Load(mImageFile);
+        if(mImage == nullptr)
+        {
+            wxLogError(L"Polygon image file load failure: unable to load '%s'", mImageFile.c_str());
+
+            // Only report the failure once
+            mImageFile.clear();
+        }
     }
+
+    return mImage != nullptr;
 }
 
 
@@ -257,7 +275,10 @@ void Polygon::DrawPolygon(std::shared_ptr<wxGraphicsContext> graphics, double x,
             break;
 
         case Mode::Image:
-            DrawImagePolygon(graphics, x, y, rotation);
+            if(EnsureImage())
+            {
+                DrawImagePolygon(graphics, x, y, rotation);
+            }
             break;
 
         default:
@@ -331,13 +352,14 @@ void Polygon::DrawImagePolygon(std::shared_ptr<wxGraphicsContext> graphics, doub
         // Implementation of opacity for Windows systems.
         // Windows does not support transparency layers.
         if(mOpacity < 1) {
+            // The cached image is shared, so work on a copy
+            wxImage img = mImage->Copy();
+
             // Ensure the image has an alpha map
-            if (!mImage->HasAlpha()) {
-                mImage->InitAlpha();
+            if (!img.HasAlpha()) {
+                img.InitAlpha();
             }
 
-            wxImage img = mImage->Copy();
-
             unsigned char *alpha = img.GetAlpha();
             for(int i=0; i<img.GetWidth()*img.GetHeight(); i++)
             {
@@ -348,10 +370,10 @@ void Polygon::DrawImagePolygon(std::shared_ptr<wxGraphicsContext> graphics, doub
         }
         else
         {
-            mGraphicsBitmap = graphics->CreateBitmapFromImage(*mImage);
+            mGraphicsBitmap = ImageCache::Get().GetBitmap(graphics, mImageFile, *mImage);
         }
 #else
-        mGraphicsBitmap = graphics->CreateBitmapFromImage(*mImage);
+        mGraphicsBitmap = ImageCache::Get().GetBitmap(graphics, mImageFile, *mImage);
 #endif
 
         //
@@ -440,7 +462,7 @@ void Polygon::DrawCrosshair(std::shared_ptr<wxGraphicsContext> graphics, double
  */
 int Polygon::GetImageWidth()
 {
-    if(!Assert(mImage != nullptr, L"You must specify an image before you can call GetImageWidth()"))
+    if(!Assert(EnsureImage(), L"You must specify an image before you can call GetImageWidth()"))
     {
         return 0;
     }
@@ -456,7 +478,7 @@ int Polygon::GetImageWidth()
  */
 int Polygon::GetImageHeight()
 {
-    if(!Assert(mImage != nullptr, L"You must specify an image before you can call GetImageHeight()"))
+    if(!Assert(EnsureImage(), L"You must specify an image before you can call GetImageHeight()"))
     {
         return 0;
     }
@@ -4,7 +4,7 @@
  * @author Anik Momtaz
  * @author Charles Owen
  *
- * @version 1.06
+ * @version 1.07
  *
  * Generic polygon class that is used to make shapes we
  * will use in our project.
@@ -17,6 +17,7 @@
  * 1.04 Added Circle function
  * 1.05 Special version that works with inverted Y axis
  * 1.06 Updated links to the new website
+ * 1.07 Images are shared through ImageCache and loaded on first use
  */
 
 #pragma once
@@ -59,8 +60,11 @@ namespace cse335 {
         /// The current mode
         Mode mMode = Mode::Unset;
 
-        /// The basic texture image we load
-        std::unique_ptr<wxImage> mImage;
+        /// The basic texture image we load, shared through ImageCache
+        std::shared_ptr<const wxImage> mImage;
+
+        /// Filename the texture image was loaded from
+        std::wstring mImageFile;
 
         /// The graphics bitmap we actually draw
         wxGraphicsBitmap mGraphicsBitmap;
@@ -93,6 +97,8 @@ namespace cse335 {
 
         bool Assert(bool condition, wxString msg, const wxString& url = wxEmptyString);
 
+        bool EnsureImage();
+
         //<editor-fold desc="Code to support the deferred assertion message box" defaultstate="collapsed">
         /**
          * Class to display an error message dialog box after a delay
@@ -142,6 +148,12 @@ namespace cse335 {
 
         void SetImage(std::wstring filename);
 
+        /**
+         * Decode the image now rather than when the polygon is first drawn
+         * @return true if an image is available
+         */
+        bool PreloadImage() {return EnsureImage();}
+
         void DrawPolygon(std::shared_ptr<wxGraphicsContext> graphics, double x, double y, double rotation=0);
 
         virtual void SetOpacity(double opacity);
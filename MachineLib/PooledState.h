@@ -0,0 +1,78 @@
+/**
+ * @file PooledState.h
+ * @author Thomas Conley
+ *
+ * State of a model that can live in a Mechanism pool.
+ */
+
+#ifndef POOLEDSTATE_H
+#define POOLEDSTATE_H
+
+/**
+ * State of a model that can live in a Mechanism pool.
+ *
+ * The model keeps the state itself until a Mechanism pools it.
+ * The state then moves into the Mechanism's contiguous array for
+ * that type of model, so the Mechanism can step every model of
+ * the type in one loop over plain values. The model reads and
+ * writes it through here either way.
+ *
+ * @tparam T Type of the state
+ */
+template <class T>
+class PooledState {
+private:
+ /// The state while it is not pooled
+ T mOwn{};
+
+ /// Where the state is, mOwn or a pool entry
+ T* mState = &mOwn;
+
+public:
+ PooledState() = default;
+
+ /// Copy constructor (disabled)
+ PooledState(const PooledState &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const PooledState &) = delete;
+
+ /**
+  * Move the state into a pool entry
+  * @param entry Pool entry, which must not move while the state is in it
+  */
+ void Pool(T* entry)
+ {
+  *entry = *mState;
+  mState = entry;
+ }
+
+ /**
+  * Move the state back out of its pool entry
+  */
+ void Unpool()
+ {
+  mOwn = *mState;
+  mState = &mOwn;
+ }
+
+ /// Get the state
+ /// @return Reference to the state, wherever it is
+ T& operator*() {return *mState;}
+
+ /// Get the state
+ /// @return Reference to the state, wherever it is
+ const T& operator*() const {return *mState;}
+
+ /// Get a member of the state
+ /// @return Pointer to the state, wherever it is
+ T* operator->() {return mState;}
+
+ /// Get a member of the state
+ /// @return Pointer to the state, wherever it is
+ const T* operator->() const {return mState;}
+};
+
+
+
+#endif //POOLEDSTATE_H
@@ -5,6 +5,7 @@
 
 #include "pch.h"
 #include "Pulley.h"
+#include "MachineArena.h"
 
 /// How wide the hub is on each side of the pulley
 const double PulleyHubWidth = 3;
@@ -50,7 +51,8 @@ const int DepthOffset = 10;
  * @param diameter
  * @param width
  */
-Pulley::Pulley(double diameter, double width) : mDiameter(diameter), mWidth(width), mRotation(0.0)
+Pulley::Pulley(double diameter, double width) : mDiameter(diameter), mWidth(width),
+    mModel(MachineArena::Make<RotatingModel>())
 {
  // Configure the pulley body
  mPulleyBody.SetColour(wxColour(0,0,0));
@@ -79,14 +81,16 @@ Pulley::Pulley(double diameter, double width) : mDiameter(diameter), mWidth(widt
  */
 void Pulley::Draw(std::shared_ptr<wxGraphicsContext> graphics)
 {
+ double rotation = mModel->GetRotation();
+
  // Draw the pulley body
- mPulleyBody.Draw(graphics, GetPosition().x - PulleyBodyOffsetX, GetPosition().y - PulleyBodyOffsetY, mRotation);
+ mPulleyBody.Draw(graphics, GetPosition().x - PulleyBodyOffsetX, GetPosition().y - PulleyBodyOffsetY, rotation);
 
  // Draw the left hub
- mHubLeft.Draw(graphics, GetPosition().x - mWidth / 2 - PulleyHubWidth, GetPosition().y - PulleyHubOffset, mRotation);
+ mHubLeft.Draw(graphics, GetPosition().x - mWidth / 2 - PulleyHubWidth, GetPosition().y - PulleyHubOffset, rotation);
 
  // Draw the right hub
- mHubRight.Draw(graphics, GetPosition().x + mWidth / 2 + PulleyHubWidth, GetPosition().y - PulleyHubOffset, mRotation);
+ mHubRight.Draw(graphics, GetPosition().x + mWidth / 2 + PulleyHubWidth, GetPosition().y - PulleyHubOffset, rotation);
 
  // If the pulley is connected to another pulley, draw the connecting belt
  if (mConnectedPulley) {
@@ -114,45 +118,47 @@ void Pulley::Draw(std::shared_ptr<wxGraphicsContext> graphics)
 }
 
 /**
- * Reset the pulley into its original location
+ * Connect the 2 hubs/pulleys together. The other pulley
+ * turns slower in proportion to how much larger it is.
+ * @param otherPulley
+ * @param slip Fraction of the rotation lost to the belt slipping
  */
-void Pulley::Reset()
+void Pulley::BeltTo(std::shared_ptr<Pulley> otherPulley, double slip)
 {
- mRotation = 0.0;
+ mConnectedPulley = otherPulley;
 
-}
+ double ratio = mDiameter / otherPulley->GetDiameter() * (1 - slip);
+ GetSource()->AddSink(otherPulley->GetSink(), ratio);
 
-/**
- * Set Rotation of pulley
- * @param rotation
- */
-void Pulley::SetRotation(double rotation)
-{
- mRotation = rotation;
- mRotationSource.Rotate(mRotation);
 }
 
 /**
- * Update the animation
- * @param time
+ * Get the area the pulley draws in, including its belt
+ * @return Bounding box
  */
-void Pulley::Update(double time)
+wxRect Pulley::GetBoundingBox()
 {
- Component::Update(time);
+ auto position = GetPosition();
+ double radius = mDiameter / 2;
+ double top = position.y - PulleyHubOffset - radius;
+ double bottom = position.y - PulleyBodyOffsetY + radius;
+ if (mConnectedPulley)
+ {
+  // The belt runs from the bottom of this pulley to the top of the other
+  double end = mConnectedPulley->GetPosition().y - mConnectedPulley->GetDiameter() / 2;
+  top = std::min(top, end);
+  bottom = std::max(bottom, end);
+ }
+
+ return BoundingBox(position.x - mWidth / 2 - PulleyHubWidth - PulleyBeltDepth, top,
+         position.x + mWidth / 2 + PulleyHubWidth * 2 + PulleyBeltDepth + DepthOffset, bottom);
 }
 
 /**
- * Connect the 2 hubs/pulleys together
- * @param otherPulley
+ * Get the values the pulley's drawing depends on
+ * @param appearance Vector to append the values to
  */
-void Pulley::BeltTo(std::shared_ptr<Pulley> otherPulley)
+void Pulley::GetAppearance(std::vector<double>& appearance)
 {
- mConnectedPulley = otherPulley;
-
- mPreviousY = GetPosition().y;
-
- mRotationSource.AddSink(otherPulley);
-
+ appearance.push_back(mModel->GetRotation());
 }
-
-
@@ -9,11 +9,10 @@
 #define PULLEY_H
 #include "Component.h"
 #include "Cylinder.h"
-#include "IRotationSink.h"
-#include "RotationSource.h"
+#include "RotatingModel.h"
 
 /// The Pulley component
-class Pulley : public Component, public IRotationSink{
+class Pulley : public Component{
 private:
  /// Cylinder for the pulley body
  cse335::Cylinder mPulleyBody;
@@ -26,27 +25,17 @@ private:
  double mDiameter;
  /// Total width of the pulley
  double mWidth;
- /// Current rotation (in turns)
- double mRotation;
 
  /// Pointer to the connected pulley
  std::shared_ptr<Pulley> mConnectedPulley;
 
- /// The previous Y location
- int mPreviousY;
-
- /// Member variable for the rotation source
- RotationSource mRotationSource;
+ /// Simulation of the pulley rotation
+ std::shared_ptr<RotatingModel> mModel;
 
 public:
  Pulley(double diameter, double width);
  void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
- void Reset() override;
- void SetRotation(double rotation) override;
-
-
- void BeltTo(std::shared_ptr<Pulley> otherPulley);
- void Update(double time) override;
+ void BeltTo(std::shared_ptr<Pulley> otherPulley, double slip = 0);
 
  /**
   * Get position x
@@ -60,9 +49,24 @@ public:
   */
  double GetDiameter() { return mDiameter; }
 
+ /// Get the simulation model
+ /// @return RotatingModel
+ std::shared_ptr<ComponentModel> GetModel() override {return mModel;}
+
+ /// Get the name of the kind of component
+ /// @return Name
+ std::wstring GetName() override {return L"Pulley";}
+
+ wxRect GetBoundingBox() override;
+ void GetAppearance(std::vector<double>& appearance) override;
+
+ /// Get the rotation sink that turns this pulley
+ /// @return IRotationSink
+ std::shared_ptr<IRotationSink> GetSink() {return mModel;}
+
  /// Get the rotation source
  /// @return RotationSource*
- RotationSource* GetSource() {return &mRotationSource;}
+ RotationSource* GetSource() {return mModel->GetSource();}
 
 
 };
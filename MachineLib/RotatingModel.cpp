@@ -0,0 +1,44 @@
+/**
+ * @file RotatingModel.cpp
+ * @author Thomas Conley
+ */
+
+#include "RotatingModel.h"
+
+/**
+ * Reset the rotation
+ */
+void RotatingModel::Reset()
+{
+ mRotation = 0.0;
+}
+
+/**
+ * Set the rotation and pass it on to anything we drive
+ * @param rotation Rotation in turns
+ */
+void RotatingModel::SetRotation(double rotation)
+{
+ mRotation = rotation;
+ mRotationSource.Rotate(mRotation);
+}
+
+/**
+ * Save the rotation to a checkpoint
+ * @param state
+ */
+void RotatingModel::SaveState(std::vector<double>& state)
+{
+ state.push_back(mRotation);
+}
+
+/**
+ * Restore the rotation from a checkpoint
+ * @param state
+ * @return Pointer past the values this model saved
+ */
+const double* RotatingModel::RestoreState(const double* state)
+{
+ mRotation = *state++;
+ return state;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file RotatingModel.h
+ * @author Thomas Conley
+ *
+ *
+ */
+ 
+#ifndef ROTATINGMODEL_H
+#define ROTATINGMODEL_H
+#include "ComponentModel.h"
+#include "IRotationSink.h"
+#include "RotationSource.h"
+
+/// Simulation of a component turned by a rotation source, such as a shaft or pulley
+class RotatingModel final : public ComponentModel, public IRotationSink {
+private:
+ /// Rotation in turns
+ double mRotation = 0;
+
+ /// Rotation source for whatever this component drives
+ RotationSource mRotationSource;
+
+public:
+ RotatingModel() = default;
+ void Reset() override;
+ void SetRotation(double rotation) override;
+ void SaveState(std::vector<double>& state) override;
+ const double* RestoreState(const double* state) override;
+
+ /// The rotation comes from the source, so there is nothing else to evaluate
+ /// @return true
+ bool CanEvaluate() const override {return true;}
+
+ /// Get the rotation
+ /// @return Rotation in turns
+ double GetRotation() const {return mRotation;}
+
+ /// Get the rotation source
+ /// @return RotationSource
+ RotationSource* GetSource() override {return &mRotationSource;}
+};
+
+
+
+#endif //ROTATINGMODEL_H
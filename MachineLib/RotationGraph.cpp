@@ -0,0 +1,149 @@
+/**
+ * @file RotationGraph.cpp
+ * @author Thomas Conley
+ */
+
+#include "RotationGraph.h"
+#include "RotationSource.h"
+#include "IRotationSink.h"
+#include <unordered_map>
+
+/**
+ * Flatten the network driven by a root source.
+ *
+ * Sinks are numbered as they are found, then the connections are
+ * ordered so that every connection into a sink comes before any
+ * connection out of it. Connections that form a loop are dropped.
+ *
+ * @param root Source that drives the network
+ */
+void RotationGraph::Compile(RotationSource* root)
+{
+ Clear();
+
+ // Number every sink reachable from the root. Index 0 is the root.
+ std::unordered_map<IRotationSink*, int> indices;
+ std::vector<RotationSource*> sources = {root};
+ std::vector<Edge> edges;
+
+ mSinks.push_back(nullptr);
+ for (size_t source = 0; source < sources.size(); source++)
+ {
+  if (sources[source] == nullptr)
+  {
+   continue;
+  }
+
+  for (const auto& link : sources[source]->GetSinks())
+  {
+   auto sink = link.mSink.get();
+   auto found = indices.find(sink);
+   int index;
+   if (found == indices.end())
+   {
+    index = (int)mSinks.size();
+    indices[sink] = index;
+    mSinks.push_back(sink);
+    sources.push_back(sink->GetSource());
+   }
+   else
+   {
+    index = found->second;
+   }
+
+   edges.push_back({(int)source, index, link.mRatio, link.mOffset});
+  }
+ }
+
+ // Order the edges by a topological sort of their sources
+ std::vector<int> incoming(mSinks.size(), 0);
+ std::vector<std::vector<int>> outgoing(mSinks.size());
+ for (size_t i = 0; i < edges.size(); i++)
+ {
+  incoming[edges[i].mSink]++;
+  outgoing[edges[i].mSource].push_back((int)i);
+ }
+
+ std::vector<int> ready = {0};
+ while (!ready.empty())
+ {
+  int node = ready.back();
+  ready.pop_back();
+
+  for (auto i : outgoing[node])
+  {
+   mEdges.push_back(edges[i]);
+   if (--incoming[edges[i].mSink] == 0)
+   {
+    ready.push_back(edges[i].mSink);
+   }
+  }
+ }
+
+ // Multiply out the path to each sink. When a sink has more
+ // than one source, the last edge into it wins, as it would
+ // when the sources turn it one after the other.
+ mScales.assign(mSinks.size(), 1);
+ mOffsets.assign(mSinks.size(), 0);
+ for (const auto& edge : mEdges)
+ {
+  mScales[edge.mSink] = mScales[edge.mSource] * edge.mRatio;
+  mOffsets[edge.mSink] = mOffsets[edge.mSource] * edge.mRatio + edge.mOffset;
+ }
+
+ for (auto source : sources)
+ {
+  if (source != nullptr)
+  {
+   source->SetCompiled(true);
+   mSources.push_back(source);
+  }
+ }
+}
+
+/**
+ * Find the index of a sink in the graph
+ * @param sink Sink to look for
+ * @return Index of the sink, or -1 if the root does not turn it
+ */
+int RotationGraph::Find(const IRotationSink* sink) const
+{
+ for (size_t i = 1; i < mSinks.size(); i++)
+ {
+  if (mSinks[i] == sink)
+  {
+   return (int)i;
+  }
+ }
+
+ return -1;
+}
+
+/**
+ * Hand propagation back to the sources and empty the graph
+ */
+void RotationGraph::Clear()
+{
+ for (auto source : mSources)
+ {
+  source->SetCompiled(false);
+ }
+
+ mSources.clear();
+ mEdges.clear();
+ mSinks.clear();
+ mScales.clear();
+ mOffsets.clear();
+}
+
+/**
+ * Turn the root and everything it drives
+ * @param rotation Rotation of the root in turns
+ */
+void RotationGraph::Rotate(double rotation)
+{
+ for (size_t i = 1; i < mSinks.size(); i++)
+ {
+  mSinks[i]->SetRotation(rotation * mScales[i] + mOffsets[i]);
+ }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file RotationGraph.h
+ * @author Thomas Conley
+ *
+ * The rotation network of a machine flattened into an array.
+ */
+ 
+#ifndef ROTATIONGRAPH_H
+#define ROTATIONGRAPH_H
+
+#include <cstddef>
+#include <vector>
+
+class RotationSource;
+class IRotationSink;
+
+/**
+ * The rotation network of a machine flattened into an array.
+ *
+ * Compiling walks every sink reachable from a root source and
+ * records each connection as an edge, ordered so an edge comes
+ * after every edge into its source. The ratios and offsets along
+ * the path to each sink are then multiplied out, so Rotate hands
+ * each sink its rotation with one multiply instead of each source
+ * recursively turning its sinks.
+ *
+ * Compile again after changing the connections.
+ */
+class RotationGraph {
+public:
+ /// One connection in the network
+ struct Edge {
+  /// Index of the rotation that drives this edge
+  int mSource;
+
+  /// Index of the rotation this edge sets
+  int mSink;
+
+  /// Turns of the sink for each turn of the source
+  double mRatio;
+
+  /// Rotation added to the sink in turns
+  double mOffset;
+ };
+
+private:
+ /// Connections in the order they are evaluated
+ std::vector<Edge> mEdges;
+
+ /// Sink for each rotation index, index 0 is the root
+ std::vector<IRotationSink*> mSinks;
+
+ /// Turns of each sink for each turn of the root
+ std::vector<double> mScales;
+
+ /// Rotation added to each sink in turns
+ std::vector<double> mOffsets;
+
+ /// Sources that this graph propagates for
+ std::vector<RotationSource*> mSources;
+
+public:
+ RotationGraph() = default;
+
+ /// Copy constructor (disabled)
+ RotationGraph(const RotationGraph &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const RotationGraph &) = delete;
+
+ void Compile(RotationSource* root);
+ void Clear();
+ void Rotate(double rotation);
+
+ /// Has the graph been compiled?
+ /// @return true if Rotate propagates through the graph
+ bool IsCompiled() const {return !mSources.empty();}
+
+ /// Get the connections in the order they are evaluated
+ /// @return Edges
+ const std::vector<Edge>& GetEdges() const {return mEdges;}
+
+ /// Get the turns of a sink for each turn of the root
+ /// @param sink Index of the sink, 0 is the root
+ /// @return Ratio along the path to the sink
+ double GetScale(int sink) const {return mScales[sink];}
+
+ /// Get the rotation added to a sink when the root is at zero
+ /// @param sink Index of the sink, 0 is the root
+ /// @return Offset along the path to the sink in turns
+ double GetOffset(int sink) const {return mOffsets[sink];}
+
+ int Find(const IRotationSink* sink) const;
+
+ /// Get the number of sinks the graph turns
+ /// @return Sink count
+ size_t GetSinkCount() const {return mSinks.empty() ? 0 : mSinks.size() - 1;}
+};
+
+
+
+#endif //ROTATIONGRAPH_H
@@ -3,9 +3,7 @@
  * @author Thomas Conley
  */
 
-#include "pch.h"
 #include "RotationSource.h"
-#include <cmath>
 
 #include "IRotationSink.h"
 
@@ -14,10 +12,12 @@ RotationSource::RotationSource() {}
 /**
  * Add a sink/component to the vector
  * @param sink
+ * @param ratio Turns of the sink for each turn of this source
+ * @param offset Rotation added to the sink in turns
  */
-void RotationSource::AddSink(std::shared_ptr<IRotationSink> sink)
+void RotationSource::AddSink(std::shared_ptr<IRotationSink> sink, double ratio, double offset)
 {
-    mSinks.push_back(sink);
+    mSinks.push_back({sink, ratio, offset});
 }
 
 /**
@@ -26,9 +26,14 @@ void RotationSource::AddSink(std::shared_ptr<IRotationSink> sink)
  */
 void RotationSource::Rotate(double rotation)
 {
-    for (auto sink : mSinks)
+    // The compiled graph has already turned the sinks
+    if (mCompiled)
     {
-        sink->SetRotation(rotation);
-        //sink->Advance(rotation);
+        return;
     }
-}
\ No newline at end of file
+
+    for (const auto& link : mSinks)
+    {
+        link.mSink->SetRotation(rotation * link.mRatio + link.mOffset);
+    }
+}
@@ -9,22 +9,50 @@
 #define ROTATIONSOURCE_H
 
 #include <memory>
-#include <memory>
-#include "Component.h"
+#include <vector>
 #include "IRotationSink.h"
+#include "MachineArena.h"
 
 /// this handles the rotation for multiple movements
 class RotationSource {
+public:
+ /// A connection from this source to a sink
+ struct Link {
+  /// The sink being turned
+  std::shared_ptr<IRotationSink> mSink;
+
+  /// Turns of the sink for each turn of this source
+  double mRatio = 1;
+
+  /// Rotation added to the sink in turns
+  double mOffset = 0;
+ };
+
 private:
  /// vector of all components that spin
- std::vector<std::shared_ptr<IRotationSink>> mSinks;
+ MachineArena::Vector<Link> mSinks;
 
+ /// Set when a RotationGraph propagates for this source
+ bool mCompiled = false;
 
 public:
  /// Constructor to initialize the rotation source
  RotationSource();
- void AddSink(std::shared_ptr<IRotationSink> sink);
+ void AddSink(std::shared_ptr<IRotationSink> sink, double ratio = 1, double offset = 0);
  void Rotate(double rotation);
+
+ /// Get the connections to the sinks
+ /// @return Links in the order they were added
+ const MachineArena::Vector<Link>& GetSinks() const {return mSinks;}
+
+ /// Set whether a RotationGraph propagates rotation for this source.
+ /// A compiled source does nothing when rotated directly.
+ /// @param compiled true if a graph has taken over
+ void SetCompiled(bool compiled) {mCompiled = compiled;}
+
+ /// Is a RotationGraph propagating rotation for this source?
+ /// @return true if compiled
+ bool IsCompiled() const {return mCompiled;}
 };
 
 
@@ -4,6 +4,7 @@
  */
 #include "pch.h"
 #include "Shaft.h"
+#include "MachineArena.h"
 
 /// The color to draw the shaft
 const wxColour ShaftColor = wxColour(220, 220, 220);
@@ -21,7 +22,7 @@ const int ShaftLinesWidth = 1;
 const int ShaftNumLines = 4;
 
 /// Constructor
-Shaft::Shaft()
+Shaft::Shaft() : mModel(MachineArena::Make<RotatingModel>())
 {
 
 }
@@ -40,38 +41,10 @@ void Shaft::Draw(std::shared_ptr<wxGraphicsContext> graphics)
  mCylinder.SetLines(ShaftLineColor, ShaftLinesWidth, ShaftNumLines);  // Set lines for the cylinder
 
  // Now draw the cylinder (shaft) at the given position with rotation
- mCylinder.Draw(graphics, GetPosition().x, GetPosition().y - 8, mRotation);
+ mCylinder.Draw(graphics, GetPosition().x, GetPosition().y - 8, mModel->GetRotation());
 
 }
 
-/**
- * Reset the shaft to its original spot
- */
-void Shaft::Reset()
-{
- mRotation = 0.0;
-
-}
-
-/**
- * Set the rotation
- * @param rotation
- */
-void Shaft::SetRotation(double rotation)
-{
- mRotation = rotation;
- mRotationSource.Rotate(mRotation);
-}
-
-/**
- * Update the Shaft animation
- * @param time
- */
-void Shaft::Update(double time)
-{
- Component::Update(time);
-}
-
 /**
  * Set the size of the shaft
  * @param diameter
@@ -89,6 +62,23 @@ void Shaft::SetOffset(double offset) {
  mCylinder.SetOffset(offset);
 }
 
+/**
+ * Get the area the shaft draws in
+ * @return Bounding box
+ */
+wxRect Shaft::GetBoundingBox()
+{
+ auto position = GetPosition();
+ double radius = mCylinder.GetDiameter() / 2.0;
+ return BoundingBox(position.x, position.y - 8 - radius,
+         position.x + mCylinder.GetLength(), position.y - 8 + radius);
+}
 
-
-
+/**
+ * Get the values the shaft's drawing depends on
+ * @param appearance Vector to append the values to
+ */
+void Shaft::GetAppearance(std::vector<double>& appearance)
+{
+ appearance.push_back(mModel->GetRotation());
+}
@@ -9,44 +9,45 @@
 #define SHAFT_H
 #include "Component.h"
 #include "Cylinder.h"
-#include "IRotationSink.h"
-#include "RotationSource.h"
+#include "RotatingModel.h"
 
 /// The Shaft component
-class Shaft : public Component, public IRotationSink{
+class Shaft : public Component{
 private:
  /// Cyliner of the shaft
  cse335::Cylinder mCylinder;
 
- /// Diameter of the shaft
- double mDiameter;
-
- /// length of the shaft
- double mLength;
-
- /// Rotation offset
- double mOffset;
-
- /// Rotation of the shaft
- double mRotation;
-
- /// Rotation source
- RotationSource mRotationSource;
+ /// Simulation of the shaft rotation
+ std::shared_ptr<RotatingModel> mModel;
 
 public:
  Shaft();
  void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
- void Reset() override;
- void SetRotation(double rotation) override;
- void Update(double time) override;
  void SetSize(double diameter, double length);
  void SetOffset(double offset);
 
+ /// Get the simulation model
+ /// @return RotatingModel
+ std::shared_ptr<ComponentModel> GetModel() override {return mModel;}
+
+ /// Get the name of the kind of component
+ /// @return Name
+ std::wstring GetName() override {return L"Shaft";}
+
+ wxRect GetBoundingBox() override;
+ void GetAppearance(std::vector<double>& appearance) override;
+
+ /**
+  * Get the rotation sink that turns this shaft
+  * @return IRotationSink
+  */
+ std::shared_ptr<IRotationSink> GetSink() {return mModel;}
+
  /**
   * Get the rotation source
   * @return RotationSource
   */
- RotationSource* GetSource() {return &mRotationSource;}
+ RotationSource* GetSource() {return mModel->GetSource();}
 };
 
 
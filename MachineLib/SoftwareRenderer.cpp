@@ -0,0 +1,1073 @@
+/**
+ * @file SoftwareRenderer.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "SoftwareRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/// Sample rows per pixel row when antialiasing
+const int SubScanlines = 4;
+
+/// Longest a miter join may be, in line widths, before it is beveled
+const double MiterLimit = 10;
+
+/**
+ * Blend a solid colour over a run of pixels
+ * @param pixels First pixel of the run
+ * @param coverage Coverage of each pixel
+ * @param count Number of pixels
+ * @param colour Premultiplied colour, 0 to 255
+ */
+static void BlendSolid(unsigned char* pixels, const float* coverage, int count, const float* colour)
+{
+ for (int i = 0; i < count; i++)
+ {
+  float alpha = std::min(coverage[i], 1.0f);
+  float keep = 1 - colour[3] * alpha * (1.0f / 255);
+  for (int c = 0; c < 4; c++)
+  {
+   pixels[i * 4 + c] = (unsigned char)(colour[c] * alpha + pixels[i * 4 + c] * keep + 0.5f);
+  }
+ }
+}
+
+/**
+ * Blend a run of premultiplied pixels over a run of pixels
+ * @param pixels First pixel of the run
+ * @param source Premultiplied source pixels, 0 to 255
+ * @param mask Coverage of each pixel, or null for full coverage
+ * @param count Number of pixels
+ */
+static void BlendPixels(unsigned char* pixels, const float* source, const float* mask, int count)
+{
+ // Separate loops keep the test for a mask out of the one that is vectorized
+ if (mask == nullptr)
+ {
+  for (int i = 0; i < count; i++)
+  {
+   float keep = 1 - source[i * 4 + 3] * (1.0f / 255);
+   for (int c = 0; c < 4; c++)
+   {
+    pixels[i * 4 + c] = (unsigned char)(source[i * 4 + c] + pixels[i * 4 + c] * keep + 0.5f);
+   }
+  }
+  return;
+ }
+
+ for (int i = 0; i < count; i++)
+ {
+  float keep = 1 - source[i * 4 + 3] * mask[i] * (1.0f / 255);
+  for (int c = 0; c < 4; c++)
+  {
+   pixels[i * 4 + c] = (unsigned char)(source[i * 4 + c] * mask[i] + pixels[i * 4 + c] * keep + 0.5f);
+  }
+ }
+}
+
+/**
+ * Get a pixel of an image, premultiplied
+ * @param rgb RGB data of the image
+ * @param alpha Alpha data of the image, or null if it has none
+ * @param i Index of the pixel
+ * @param pixel Receives the premultiplied pixel, 0 to 255
+ */
+static void Premultiply(const unsigned char* rgb, const unsigned char* alpha, size_t i, float* pixel)
+{
+ float a = alpha != nullptr ? alpha[i] : 255;
+ pixel[0] = rgb[i * 3] * a * (1.0f / 255);
+ pixel[1] = rgb[i * 3 + 1] * a * (1.0f / 255);
+ pixel[2] = rgb[i * 3 + 2] * a * (1.0f / 255);
+ pixel[3] = a;
+}
+
+/**
+ * Get the premultiplied colour of a wxColour
+ * @param colour Colour
+ * @param premultiplied Receives the colour, 0 to 255
+ */
+static void Premultiply(const wxColour& colour, float* premultiplied)
+{
+ float alpha = colour.Alpha() * (1.0f / 255);
+ premultiplied[0] = colour.Red() * alpha;
+ premultiplied[1] = colour.Green() * alpha;
+ premultiplied[2] = colour.Blue() * alpha;
+ premultiplied[3] = colour.Alpha();
+}
+
+/**
+ * Constructor
+ * @param width Width in pixels
+ * @param height Height in pixels
+ */
+SoftwareRenderer::SoftwareRenderer(int width, int height) :
+    mWidth(std::max(width, 0)), mHeight(std::max(height, 0)),
+    mPixels((size_t)mWidth * mHeight * 4, 0), mCoverage(mWidth + 1, 0)
+{
+}
+
+/**
+ * Constructor for a renderer that draws over an image
+ * @param image Image to draw into, written when the renderer is destroyed
+ */
+SoftwareRenderer::SoftwareRenderer(wxImage& image) : SoftwareRenderer(image.GetWidth(), image.GetHeight())
+{
+ mTarget = &image;
+ ReadImage(image);
+}
+
+/**
+ * Destructor
+ */
+SoftwareRenderer::~SoftwareRenderer()
+{
+ if (mTarget != nullptr)
+ {
+  WriteImage(*mTarget);
+ }
+}
+
+/**
+ * Fill every pixel with a colour
+ * @param colour Colour to fill with
+ */
+void SoftwareRenderer::Clear(const wxColour& colour)
+{
+ float premultiplied[4];
+ Premultiply(colour, premultiplied);
+ unsigned char pixel[4];
+ for (int c = 0; c < 4; c++)
+ {
+  pixel[c] = (unsigned char)(premultiplied[c] + 0.5f);
+ }
+
+ uint32_t packed;
+ memcpy(&packed, pixel, sizeof(packed));
+ std::fill_n(reinterpret_cast<uint32_t*>(mPixels.data()), (size_t)mWidth * mHeight, packed);
+}
+
+/**
+ * Get the pixels as an image
+ * @return Image with an alpha channel
+ */
+wxImage SoftwareRenderer::ToImage() const
+{
+ wxImage image(mWidth, mHeight, false);
+ image.InitAlpha();
+ WriteImage(image);
+ return image;
+}
+
+/**
+ * Copy the pixels of an image the size of the renderer
+ * @param image Image to read
+ */
+void SoftwareRenderer::ReadImage(const wxImage& image)
+{
+ const unsigned char* rgb = image.GetData();
+ const unsigned char* alpha = image.HasAlpha() ? image.GetAlpha() : nullptr;
+ for (size_t i = 0; i < (size_t)mWidth * mHeight; i++)
+ {
+  float pixel[4];
+  Premultiply(rgb, alpha, i, pixel);
+  for (int c = 0; c < 4; c++)
+  {
+   mPixels[i * 4 + c] = (unsigned char)(pixel[c] + 0.5f);
+  }
+ }
+}
+
+/**
+ * Copy the pixels into an image the size of the renderer
+ * @param image Image to write, which must have an alpha channel
+ */
+void SoftwareRenderer::WriteImage(wxImage& image) const
+{
+ unsigned char* rgb = image.GetData();
+ unsigned char* alpha = image.GetAlpha();
+ for (size_t i = 0; i < (size_t)mWidth * mHeight; i++)
+ {
+  const unsigned char* pixel = &mPixels[i * 4];
+  int a = pixel[3];
+  for (int c = 0; c < 3; c++)
+  {
+   rgb[i * 3 + c] = a == 0 ? 0 : (unsigned char)std::min(255, (pixel[c] * 255 + a / 2) / a);
+  }
+
+  if (alpha != nullptr)
+  {
+   alpha[i] = (unsigned char)a;
+  }
+ }
+}
+
+/**
+ * Get the current transform
+ * @return Transform from user to device coordinates
+ */
+DrawList::Matrix SoftwareRenderer::GetTransform() const
+{
+ return mState.mMatrix;
+}
+
+/**
+ * Get the size of the buffer
+ * @param width Receives the width in pixels
+ * @param height Receives the height in pixels
+ */
+void SoftwareRenderer::GetSize(double* width, double* height) const
+{
+ *width = mWidth;
+ *height = mHeight;
+}
+
+/**
+ * Get the current antialiasing mode
+ * @return Antialiasing mode
+ */
+wxAntialiasMode SoftwareRenderer::GetAntialiasMode() const
+{
+ return mState.mAntialias;
+}
+
+/**
+ * Get the current interpolation quality
+ * @return Interpolation quality
+ */
+wxInterpolationQuality SoftwareRenderer::GetInterpolationQuality() const
+{
+ return mState.mInterpolation;
+}
+
+/**
+ * Make a software renderer that draws over an image
+ * @param image Image to draw into
+ * @return New renderer, which writes the image when destroyed
+ */
+std::unique_ptr<IRenderer> SoftwareRenderer::CreateImageRenderer(wxImage& image)
+{
+ return std::make_unique<SoftwareRenderer>(image);
+}
+
+/**
+ * Save the transform, clip and modes
+ */
+void SoftwareRenderer::PushState()
+{
+ mStates.push_back(mState);
+}
+
+/**
+ * Restore the last saved state
+ */
+void SoftwareRenderer::PopState()
+{
+ if (!mStates.empty())
+ {
+  mState = mStates.back();
+  mStates.pop_back();
+ }
+}
+
+/**
+ * Translate the transform
+ * @param dx X offset
+ * @param dy Y offset
+ */
+void SoftwareRenderer::Translate(double dx, double dy)
+{
+ mState.mMatrix.Translate(dx, dy);
+}
+
+/**
+ * Scale the transform
+ * @param xScale X scale
+ * @param yScale Y scale
+ */
+void SoftwareRenderer::Scale(double xScale, double yScale)
+{
+ mState.mMatrix.Scale(xScale, yScale);
+}
+
+/**
+ * Rotate the transform
+ * @param angle Angle in radians
+ */
+void SoftwareRenderer::Rotate(double angle)
+{
+ mState.mMatrix.Rotate(angle);
+}
+
+/**
+ * Apply a matrix before the current transform
+ * @param matrix Matrix to apply
+ */
+void SoftwareRenderer::ConcatTransform(const DrawList::Matrix& matrix)
+{
+ mState.mMatrix.Concat(matrix);
+}
+
+/**
+ * Replace the current transform
+ * @param matrix New transform
+ */
+void SoftwareRenderer::SetTransform(const DrawList::Matrix& matrix)
+{
+ mState.mMatrix = matrix;
+}
+
+/**
+ * Intersect the clip with a polygon
+ * @param points Corners of the polygon in user coordinates
+ * @param count Number of corners
+ */
+void SoftwareRenderer::ClipPolygon(const wxPoint2DDouble* points, size_t count)
+{
+ mPoints.assign(points, points + count);
+ for (auto& point : mPoints)
+ {
+  mState.mMatrix.Apply(point.m_x, point.m_y);
+ }
+ AddPolygon(mPoints.data(), mPoints.size(), false);
+
+ auto old = mState.mClip;
+ auto clip = std::make_shared<std::vector<float>>((size_t)mWidth * mHeight, 0.0f);
+ Rasterize(wxWINDING_RULE, [this, &old, &clip](int y, int left, int right, float* coverage) {
+  float* mask = &(*clip)[(size_t)y * mWidth];
+  for (int x = left; x < right; x++)
+  {
+   mask[x] = std::min(coverage[x], 1.0f);
+  }
+
+  if (old != nullptr)
+  {
+   const float* oldMask = &(*old)[(size_t)y * mWidth];
+   for (int x = left; x < right; x++)
+   {
+    mask[x] *= oldMask[x];
+   }
+  }
+ });
+ mState.mClip = clip;
+}
+
+/**
+ * Intersect the clip with a region
+ * @param region Region in user coordinates
+ */
+void SoftwareRenderer::Clip(const wxRegion& region)
+{
+ auto clip = std::make_shared<std::vector<float>>((size_t)mWidth * mHeight, 0.0f);
+ auto old = mState.mClip;
+
+ // Clip to each rectangle from the original clip and merge the results
+ for (wxRegionIterator rects(region); rects; ++rects)
+ {
+  wxRect rect = rects.GetRect();
+  wxPoint2DDouble corners[] = {{(double)rect.x, (double)rect.y},
+                               {(double)rect.x + rect.width, (double)rect.y},
+                               {(double)rect.x + rect.width, (double)rect.y + rect.height},
+                               {(double)rect.x, (double)rect.y + rect.height}};
+  mState.mClip = old;
+  ClipPolygon(corners, 4);
+  for (size_t i = 0; i < clip->size(); i++)
+  {
+   (*clip)[i] = std::min((*clip)[i] + (*mState.mClip)[i], 1.0f);
+  }
+ }
+
+ mState.mClip = clip;
+}
+
+/**
+ * Intersect the clip with a rectangle
+ * @param x Left of the rectangle
+ * @param y Top of the rectangle
+ * @param w Width of the rectangle
+ * @param h Height of the rectangle
+ */
+void SoftwareRenderer::Clip(double x, double y, double w, double h)
+{
+ wxPoint2DDouble corners[] = {{x, y}, {x + w, y}, {x + w, y + h}, {x, y + h}};
+ ClipPolygon(corners, 4);
+}
+
+/**
+ * Remove the clip
+ */
+void SoftwareRenderer::ResetClip()
+{
+ mState.mClip = nullptr;
+}
+
+/**
+ * Set the brush fills use. Only solid brushes made by the recorder are drawn.
+ * @param brush Brush entry of the list
+ */
+void SoftwareRenderer::SetBrush(const DrawList::BrushEntry& brush)
+{
+ if (!brush.mForeign.IsNull() || !brush.mBrush.IsOk() || brush.mBrush.IsTransparent())
+ {
+  std::fill_n(mFillColour, 4, 0.0f);
+  return;
+ }
+
+ Premultiply(brush.mBrush.GetColour(), mFillColour);
+}
+
+/**
+ * Set the pen strokes use. Only solid pens made by the recorder are drawn.
+ * @param pen Pen entry of the list
+ */
+void SoftwareRenderer::SetPen(const DrawList::PenEntry& pen)
+{
+ if (!pen.mForeign.IsNull() || pen.mNull || pen.mInfo.GetStyle() == wxPENSTYLE_TRANSPARENT)
+ {
+  std::fill_n(mPenColour, 4, 0.0f);
+  return;
+ }
+
+ Premultiply(pen.mInfo.GetColour(), mPenColour);
+ mPenWidth = pen.mInfo.GetWidth();
+ mPenCap = pen.mInfo.GetCap();
+ mPenJoin = pen.mInfo.GetJoin();
+}
+
+/**
+ * Set the antialiasing mode
+ * @param antialias New mode
+ */
+void SoftwareRenderer::SetAntialiasMode(wxAntialiasMode antialias)
+{
+ mState.mAntialias = antialias;
+}
+
+/**
+ * Set the interpolation quality of bitmaps
+ * @param interpolation New quality
+ */
+void SoftwareRenderer::SetInterpolationQuality(wxInterpolationQuality interpolation)
+{
+ mState.mInterpolation = interpolation;
+}
+
+/**
+ * Set the composition mode. Everything is drawn over what is there.
+ * @param op New composition mode
+ */
+void SoftwareRenderer::SetCompositionMode(wxCompositionMode op)
+{
+}
+
+/**
+ * Add the edges of a polygon to the shape being rasterized
+ * @param points Corners of the polygon in device coordinates
+ * @param count Number of corners
+ * @param reverse true to add the polygon as if it went the other way
+ */
+void SoftwareRenderer::AddPolygon(const wxPoint2DDouble* points, size_t count, bool reverse)
+{
+ for (size_t i = 0; i < count; i++)
+ {
+  auto& a = points[i];
+  auto& b = points[(i + 1) % count];
+  if (a.m_y == b.m_y || !std::isfinite(a.m_x + a.m_y + b.m_x + b.m_y))
+  {
+   continue;
+  }
+
+  int direction = reverse ? -1 : 1;
+  auto& top = a.m_y < b.m_y ? a : b;
+  auto& bottom = a.m_y < b.m_y ? b : a;
+  double slope = (bottom.m_x - top.m_x) / (bottom.m_y - top.m_y);
+  mEdges.push_back({top.m_x, top.m_y, bottom.m_y, slope, a.m_y < b.m_y ? direction : -direction});
+ }
+}
+
+/**
+ * Add a piece of a stroke, turned so all pieces wind the same way
+ * @param points Corners of the piece in device coordinates
+ * @param count Number of corners
+ */
+void SoftwareRenderer::AddPiece(const wxPoint2DDouble* points, size_t count)
+{
+ double area = 0;
+ for (size_t i = 0; i < count; i++)
+ {
+  auto& a = points[i];
+  auto& b = points[(i + 1) % count];
+  area += a.m_x * b.m_y - b.m_x * a.m_y;
+ }
+
+ AddPolygon(points, count, area < 0);
+}
+
+/**
+ * Add a disc for a round join or cap
+ * @param center Center in device coordinates
+ * @param radius Radius in pixels
+ */
+void SoftwareRenderer::AddDisc(const wxPoint2DDouble& center, double radius)
+{
+ int segments = std::clamp((int)std::ceil(M_PI * radius), 8, 128);
+ mPoints.clear();
+ for (int i = 0; i < segments; i++)
+ {
+  double angle = 2 * M_PI * i / segments;
+  mPoints.emplace_back(center.m_x + radius * std::cos(angle), center.m_y + radius * std::sin(angle));
+ }
+
+ AddPiece(mPoints.data(), mPoints.size());
+}
+
+/**
+ * Add the join between two segments of a stroke
+ * @param point Where the segments meet
+ * @param in Unit direction of the segment into the point
+ * @param out Unit direction of the segment out of the point
+ * @param halfWidth Half the line width in pixels
+ */
+void SoftwareRenderer::AddJoin(const wxPoint2DDouble& point, const wxPoint2DDouble& in,
+        const wxPoint2DDouble& out, double halfWidth)
+{
+ double cross = in.m_x * out.m_y - in.m_y * out.m_x;
+ double dot = in.m_x * out.m_x + in.m_y * out.m_y;
+ if (std::abs(cross) < 1e-9 && dot > 0)
+ {
+  return;
+ }
+
+ if (mPenJoin == wxJOIN_ROUND)
+ {
+  AddDisc(point, halfWidth);
+  return;
+ }
+
+ // The gap to fill is on the outside of the turn
+ double side = cross > 0 ? -halfWidth : halfWidth;
+ wxPoint2DDouble a(point.m_x - in.m_y * side, point.m_y + in.m_x * side);
+ wxPoint2DDouble b(point.m_x - out.m_y * side, point.m_y + out.m_x * side);
+
+ // The miter is 1 / sin(half the angle between the segments) line widths long
+ if (mPenJoin == wxJOIN_MITER && 1 + dot > 2 / (MiterLimit * MiterLimit))
+ {
+  wxPoint2DDouble miter(point.m_x - (in.m_y + out.m_y) * side / (1 + dot),
+                        point.m_y + (in.m_x + out.m_x) * side / (1 + dot));
+  wxPoint2DDouble piece[] = {point, a, miter, b};
+  AddPiece(piece, 4);
+ }
+ else
+ {
+  wxPoint2DDouble piece[] = {point, a, b};
+  AddPiece(piece, 3);
+ }
+}
+
+/**
+ * Add the coverage of a span of one sample row
+ * @param x0 Left end of the span
+ * @param x1 Right end of the span
+ * @param weight Coverage of a fully covered pixel
+ * @param left Leftmost covered pixel so far, updated
+ * @param right One past the rightmost covered pixel so far, updated
+ */
+void SoftwareRenderer::AddSpan(double x0, double x1, double weight, int* left, int* right)
+{
+ float* coverage = mCoverage.data();
+ int first, last;
+ if (IsAntialiased())
+ {
+  // Pixels the span only partly crosses get the part it covers
+  x0 = std::clamp(x0, 0.0, (double)mWidth);
+  x1 = std::clamp(x1, 0.0, (double)mWidth);
+  if (x1 <= x0)
+  {
+   return;
+  }
+
+  first = (int)x0;
+  last = (int)x1;
+  if (first == last)
+  {
+   coverage[first] += (float)((x1 - x0) * weight);
+  }
+  else
+  {
+   coverage[first] += (float)((first + 1 - x0) * weight);
+   for (int x = first + 1; x < last; x++)
+   {
+    coverage[x] += (float)weight;
+   }
+   coverage[last] += (float)((x1 - last) * weight);
+  }
+  last = std::min(last + 1, mWidth);
+ }
+ else
+ {
+  // Pixels whose centers are in the span are covered
+  first = std::max(0, (int)std::ceil(x0 - 0.5));
+  last = std::min(mWidth, (int)std::ceil(x1 - 0.5));
+  for (int x = first; x < last; x++)
+  {
+   coverage[x] += (float)weight;
+  }
+ }
+
+ if (first < last)
+ {
+  *left = std::min(*left, first);
+  *right = std::max(*right, last);
+ }
+}
+
+/**
+ * Scan convert the edges added since the last call. Each pixel row
+ * the shape covers is passed to a function with the coverage of its
+ * pixels, and the edges are removed.
+ * @param fillStyle Fill rule
+ * @param row Function called with the row, the covered range and the coverage row
+ */
+template <class RowFunction>
+void SoftwareRenderer::Rasterize(wxPolygonFillMode fillStyle, RowFunction row)
+{
+ if (mEdges.empty())
+ {
+  return;
+ }
+
+ std::sort(mEdges.begin(), mEdges.end(), [](const Edge& a, const Edge& b) {return a.mY0 < b.mY0;});
+ double bottom = 0;
+ for (auto& edge : mEdges)
+ {
+  bottom = std::max(bottom, edge.mY1);
+ }
+
+ int samples = IsAntialiased() ? SubScanlines : 1;
+ double weight = IsAntialiased() ? 1.0 / samples : 1;
+ int first = std::max(0, (int)std::floor(mEdges.front().mY0));
+ int last = std::min(mHeight, (int)std::ceil(bottom));
+
+ size_t next = 0;
+ mActive.clear();
+ for (int y = first; y < last; y++)
+ {
+  while (next < mEdges.size() && mEdges[next].mY0 < y + 1)
+  {
+   mActive.push_back(next++);
+  }
+  mActive.erase(std::remove_if(mActive.begin(), mActive.end(),
+          [this, y](size_t i) {return mEdges[i].mY1 <= y;}), mActive.end());
+
+  int left = mWidth, right = 0;
+  for (int s = 0; s < samples; s++)
+  {
+   double sampleY = y + (s + 0.5) / samples;
+   mCrossings.clear();
+   for (auto i : mActive)
+   {
+    auto& edge = mEdges[i];
+    if (edge.mY0 <= sampleY && sampleY < edge.mY1)
+    {
+     mCrossings.push_back({edge.mX0 + (sampleY - edge.mY0) * edge.mSlope, edge.mDirection});
+    }
+   }
+   std::sort(mCrossings.begin(), mCrossings.end(),
+           [](const Crossing& a, const Crossing& b) {return a.mX < b.mX;});
+
+   int winding = 0;
+   for (size_t c = 0; c + 1 < mCrossings.size(); c++)
+   {
+    winding += mCrossings[c].mDirection;
+    if (fillStyle == wxWINDING_RULE ? winding != 0 : (winding & 1) != 0)
+    {
+     AddSpan(mCrossings[c].mX, mCrossings[c + 1].mX, weight, &left, &right);
+    }
+   }
+  }
+
+  if (left < right)
+  {
+   row(y, left, right, mCoverage.data());
+   std::fill(mCoverage.begin() + left, mCoverage.begin() + right + 1, 0.0f);
+  }
+ }
+
+ mEdges.clear();
+}
+
+/**
+ * Blend a solid colour over the covered part of a row
+ * @param y Row
+ * @param left First covered pixel
+ * @param right One past the last covered pixel
+ * @param coverage Coverage of the pixels of the row
+ * @param colour Premultiplied colour, 0 to 255
+ */
+void SoftwareRenderer::BlendSpan(int y, int left, int right, float* coverage, const float* colour)
+{
+ unsigned char* pixels = &mPixels[((size_t)y * mWidth + left) * 4];
+ float* cover = coverage + left;
+ int count = right - left;
+ if (mState.mClip != nullptr)
+ {
+  const float* clip = &(*mState.mClip)[(size_t)y * mWidth + left];
+  for (int i = 0; i < count; i++)
+  {
+   cover[i] *= clip[i];
+  }
+ }
+
+ // Fully covered runs of an opaque colour are stored, not blended
+ bool opaque = colour[3] >= 255;
+ unsigned char solid[4] = {(unsigned char)(colour[0] + 0.5f), (unsigned char)(colour[1] + 0.5f),
+                           (unsigned char)(colour[2] + 0.5f), 255};
+ uint32_t packed;
+ memcpy(&packed, solid, sizeof(packed));
+
+ int i = 0;
+ while (i < count)
+ {
+  int start = i;
+  if (opaque && cover[i] >= 1)
+  {
+   while (i < count && cover[i] >= 1)
+   {
+    i++;
+   }
+   std::fill_n(reinterpret_cast<uint32_t*>(pixels + start * 4), i - start, packed);
+  }
+  else
+  {
+   while (i < count && !(opaque && cover[i] >= 1))
+   {
+    i++;
+   }
+   BlendSolid(pixels + start * 4, cover + start, i - start, colour);
+  }
+ }
+}
+
+/**
+ * Fill a path with the current fill colour
+ * @param path Path to fill
+ * @param fillStyle Fill rule
+ */
+void SoftwareRenderer::Fill(const DrawList::Path& path, wxPolygonFillMode fillStyle)
+{
+ if (mFillColour[3] <= 0)
+ {
+  return;
+ }
+
+ path.Flatten(mState.mMatrix, mPolygons);
+ for (auto& polygon : mPolygons)
+ {
+  AddPolygon(polygon.data(), polygon.size(), false);
+ }
+
+ Rasterize(fillStyle, [this](int y, int left, int right, float* coverage) {
+  BlendSpan(y, left, right, coverage, mFillColour);
+ });
+}
+
+/**
+ * Stroke a path with the current pen. The line width is scaled by
+ * the average scale of the transform.
+ * @param path Path to stroke
+ */
+void SoftwareRenderer::Stroke(const DrawList::Path& path)
+{
+ if (mPenColour[3] <= 0)
+ {
+  return;
+ }
+
+ std::vector<bool> closed;
+ path.Flatten(mState.mMatrix, mPolygons, &closed);
+
+ auto& matrix = mState.mMatrix;
+ double scale = std::sqrt(std::abs(matrix.mA * matrix.mD - matrix.mB * matrix.mC));
+ double halfWidth = (mPenWidth > 0 ? mPenWidth * scale : 1) / 2;
+
+ // Every segment, join and cap becomes a piece, and the pieces
+ // are filled together so where they overlap is only drawn once
+ for (size_t p = 0; p < mPolygons.size(); p++)
+ {
+  auto& line = mPolygons[p];
+  line.erase(std::unique(line.begin(), line.end()), line.end());
+  if (closed[p] && line.size() > 1 && line.front() == line.back())
+  {
+   line.pop_back();
+  }
+
+  size_t count = line.size();
+  if (count == 1)
+  {
+   if (mPenCap == wxCAP_ROUND)
+   {
+    AddDisc(line[0], halfWidth);
+   }
+   continue;
+  }
+
+  bool loop = closed[p] && count > 2;
+  size_t segments = loop ? count : count - 1;
+  auto direction = [&line, count](size_t s) {
+   auto& a = line[s];
+   auto& b = line[(s + 1) % count];
+   double length = std::hypot(b.m_x - a.m_x, b.m_y - a.m_y);
+   return wxPoint2DDouble((b.m_x - a.m_x) / length, (b.m_y - a.m_y) / length);
+  };
+
+  for (size_t s = 0; s < segments; s++)
+  {
+   auto d = direction(s);
+   auto a = line[s];
+   auto b = line[(s + 1) % count];
+   if (!loop && mPenCap == wxCAP_PROJECTING)
+   {
+    if (s == 0)
+    {
+     a = wxPoint2DDouble(a.m_x - d.m_x * halfWidth, a.m_y - d.m_y * halfWidth);
+    }
+    if (s == segments - 1)
+    {
+     b = wxPoint2DDouble(b.m_x + d.m_x * halfWidth, b.m_y + d.m_y * halfWidth);
+    }
+   }
+
+   double nx = -d.m_y * halfWidth, ny = d.m_x * halfWidth;
+   wxPoint2DDouble piece[] = {{a.m_x + nx, a.m_y + ny}, {b.m_x + nx, b.m_y + ny},
+                              {b.m_x - nx, b.m_y - ny}, {a.m_x - nx, a.m_y - ny}};
+   AddPiece(piece, 4);
+  }
+
+  for (size_t v = loop ? 0 : 1; v < (loop ? count : count - 1); v++)
+  {
+   AddJoin(line[v], direction((v + count - 1) % count), direction(v), halfWidth);
+  }
+
+  if (!loop && mPenCap == wxCAP_ROUND)
+  {
+   AddDisc(line.front(), halfWidth);
+   AddDisc(line.back(), halfWidth);
+  }
+ }
+
+ Rasterize(wxWINDING_RULE, [this](int y, int left, int right, float* coverage) {
+  BlendSpan(y, left, right, coverage, mPenColour);
+ });
+}
+
+/**
+ * Fill a path with the brush
+ * @param path Path entry of the list
+ * @param fillStyle Fill rule
+ */
+void SoftwareRenderer::FillPath(const DrawList::PathEntry& path, wxPolygonFillMode fillStyle)
+{
+ if (path.mPath != nullptr)
+ {
+  Fill(*path.mPath, fillStyle);
+ }
+}
+
+/**
+ * Stroke a path with the pen
+ * @param path Path entry of the list
+ */
+void SoftwareRenderer::StrokePath(const DrawList::PathEntry& path)
+{
+ if (path.mPath != nullptr)
+ {
+  Stroke(*path.mPath);
+ }
+}
+
+/**
+ * Fill a path with the brush, then stroke it with the pen
+ * @param path Path entry of the list
+ * @param fillStyle Fill rule
+ */
+void SoftwareRenderer::DrawPath(const DrawList::PathEntry& path, wxPolygonFillMode fillStyle)
+{
+ if (path.mPath != nullptr)
+ {
+  Fill(*path.mPath, fillStyle);
+  Stroke(*path.mPath);
+ }
+}
+
+/**
+ * Draw a bitmap stretched to a rectangle. A bitmap drawn at its own
+ * size on whole pixels is copied a row at a time, anything else is
+ * sampled through the inverse of the transform.
+ * @param bitmap Bitmap entry of the list
+ * @param x Left of the rectangle
+ * @param y Top of the rectangle
+ * @param w Width of the rectangle
+ * @param h Height of the rectangle
+ */
+void SoftwareRenderer::DrawBitmap(const DrawList::BitmapEntry& bitmap, double x, double y, double w, double h)
+{
+ if (bitmap.mBitmap == nullptr || w <= 0 || h <= 0)
+ {
+  return;
+ }
+
+ auto& image = bitmap.mBitmap->GetImage();
+ int imageWidth = image.GetWidth();
+ int imageHeight = image.GetHeight();
+ if (imageWidth <= 0 || imageHeight <= 0)
+ {
+  return;
+ }
+
+ const unsigned char* rgb = image.GetData();
+ const unsigned char* alpha = image.HasAlpha() ? image.GetAlpha() : nullptr;
+ const float* clip = mState.mClip != nullptr ? mState.mClip->data() : nullptr;
+ mRow.resize((size_t)mWidth * 4);
+
+ auto& matrix = mState.mMatrix;
+ double originX = x, originY = y;
+ matrix.Apply(originX, originY);
+ auto whole = [](double value) {return std::abs(value - std::round(value)) < 1e-6;};
+ if (matrix.mB == 0 && matrix.mC == 0 && whole(originX) && whole(originY) &&
+     std::abs(matrix.mA * w - imageWidth) < 1e-6 && std::abs(matrix.mD * h - imageHeight) < 1e-6)
+ {
+  int left = (int)std::round(originX);
+  int top = (int)std::round(originY);
+  int first = std::max(0, -left);
+  int last = std::min(imageWidth, mWidth - left);
+  for (int row = std::max(0, -top); row < std::min(imageHeight, mHeight - top) && first < last; row++)
+  {
+   size_t source = (size_t)row * imageWidth;
+   for (int column = first; column < last; column++)
+   {
+    Premultiply(rgb, alpha, source + column, &mRow[(size_t)(column - first) * 4]);
+   }
+
+   size_t target = (size_t)(top + row) * mWidth + left + first;
+   BlendPixels(&mPixels[target * 4], mRow.data(), clip != nullptr ? clip + target : nullptr, last - first);
+  }
+  return;
+ }
+
+ DrawList::Matrix inverse = matrix;
+ if (!inverse.Invert())
+ {
+  return;
+ }
+
+ // Device pixels the rectangle can touch
+ double corners[4][2] = {{x, y}, {x + w, y}, {x + w, y + h}, {x, y + h}};
+ double left = mWidth, top = mHeight, right = 0, bottom = 0;
+ for (auto& corner : corners)
+ {
+  matrix.Apply(corner[0], corner[1]);
+  left = std::min(left, corner[0]);
+  top = std::min(top, corner[1]);
+  right = std::max(right, corner[0]);
+  bottom = std::max(bottom, corner[1]);
+ }
+
+ int firstX = std::max(0, (int)std::floor(left));
+ int lastX = std::min(mWidth, (int)std::ceil(right));
+ bool smooth = mState.mInterpolation != wxINTERPOLATION_NONE && mState.mInterpolation != wxINTERPOLATION_FAST;
+ double scaleX = imageWidth / w;
+ double scaleY = imageHeight / h;
+ for (int py = std::max(0, (int)std::floor(top)); py < std::min(mHeight, (int)std::ceil(bottom)); py++)
+ {
+  for (int px = firstX; px < lastX; px++)
+  {
+   float* pixel = &mRow[(size_t)(px - firstX) * 4];
+   double u = px + 0.5, v = py + 0.5;
+   inverse.Apply(u, v);
+   u = (u - x) * scaleX;
+   v = (v - y) * scaleY;
+   if (u < 0 || v < 0 || u >= imageWidth || v >= imageHeight)
+   {
+    std::fill_n(pixel, 4, 0.0f);
+   }
+   else if (!smooth)
+   {
+    Premultiply(rgb, alpha, (size_t)v * imageWidth + (size_t)u, pixel);
+   }
+   else
+   {
+    // Blend the four source pixels around the sample point
+    double sx = std::clamp(u - 0.5, 0.0, imageWidth - 1.0);
+    double sy = std::clamp(v - 0.5, 0.0, imageHeight - 1.0);
+    int x0 = (int)sx, y0 = (int)sy;
+    int x1 = std::min(x0 + 1, imageWidth - 1), y1 = std::min(y0 + 1, imageHeight - 1);
+    float fx = (float)(sx - x0), fy = (float)(sy - y0);
+    float samples[4][4];
+    Premultiply(rgb, alpha, (size_t)y0 * imageWidth + x0, samples[0]);
+    Premultiply(rgb, alpha, (size_t)y0 * imageWidth + x1, samples[1]);
+    Premultiply(rgb, alpha, (size_t)y1 * imageWidth + x0, samples[2]);
+    Premultiply(rgb, alpha, (size_t)y1 * imageWidth + x1, samples[3]);
+    for (int c = 0; c < 4; c++)
+    {
+     float upper = samples[0][c] + (samples[1][c] - samples[0][c]) * fx;
+     float lower = samples[2][c] + (samples[3][c] - samples[2][c]) * fx;
+     pixel[c] = upper + (lower - upper) * fy;
+    }
+   }
+  }
+
+  size_t target = (size_t)py * mWidth + firstX;
+  BlendPixels(&mPixels[target * 4], mRow.data(), clip != nullptr ? clip + target : nullptr, lastX - firstX);
+ }
+}
+
+/**
+ * Text is not drawn by the software renderer
+ * @param text Text entry of the list
+ * @param x Left of the text
+ * @param y Top of the text
+ */
+void SoftwareRenderer::DrawText(const DrawList::TextEntry& text, double x, double y)
+{
+}
+
+/**
+ * Start drawing into a transparent layer
+ * @param opacity Opacity of the layer, 0 to 1
+ */
+void SoftwareRenderer::BeginLayer(double opacity)
+{
+ mLayers.push_back({std::move(mPixels), opacity});
+ mPixels.assign((size_t)mWidth * mHeight * 4, 0);
+}
+
+/**
+ * Blend the layer onto the pixels below it
+ */
+void SoftwareRenderer::EndLayer()
+{
+ if (mLayers.empty())
+ {
+  return;
+ }
+
+ auto layer = std::move(mLayers.back());
+ mLayers.pop_back();
+
+ float opacity = (float)std::clamp(layer.mOpacity, 0.0, 1.0);
+ const unsigned char* top = mPixels.data();
+ unsigned char* below = layer.mPixels.data();
+ for (size_t i = 0; i < layer.mPixels.size(); i += 4)
+ {
+  float keep = 1 - top[i + 3] * opacity * (1.0f / 255);
+  for (int c = 0; c < 4; c++)
+  {
+   below[i + c] = (unsigned char)(top[i + c] * opacity + below[i + c] * keep + 0.5f);
+  }
+ }
+
+ mPixels = std::move(layer.mPixels);
+}
@@ -0,0 +1,169 @@
+/**
+ * @file SoftwareRenderer.h
+ * @author Thomas Conley
+ *
+ * Renderer that rasterizes into its own RGBA buffer.
+ */
+
+#ifndef SOFTWARERENDERER_H
+#define SOFTWARERENDERER_H
+
+#include "IRenderer.h"
+
+/**
+ * Renderer that rasterizes into its own RGBA buffer.
+ *
+ * Nothing goes through wxWidgets drawing, so it is cheap to make
+ * one for a thumbnail or an exported frame and it needs no display.
+ * Paths are flattened and scan converted with a few subsamples per
+ * pixel row and exact coverage across it, and solid spans and bitmap
+ * rows are blended in plain loops the compiler vectorizes.
+ *
+ * Solid brushes and pens, clipping, layers and bitmaps are drawn.
+ * Text, gradients and objects from other renderers are skipped, and
+ * every composition mode draws as wxCOMPOSITION_OVER.
+ */
+class SoftwareRenderer : public IRenderer {
+private:
+ /// What PushState saves
+ struct State {
+  DrawList::Matrix mMatrix;     ///< Transform from user to device coordinates
+  std::shared_ptr<const std::vector<float>> mClip;      ///< Coverage of each pixel, null for no clip
+  wxAntialiasMode mAntialias = wxANTIALIAS_DEFAULT;     ///< Antialiasing mode
+  wxInterpolationQuality mInterpolation = wxINTERPOLATION_DEFAULT;      ///< Bitmap interpolation
+ };
+
+ /// The pixels below a layer BeginLayer started
+ struct Layer {
+  std::vector<unsigned char> mPixels;   ///< Pixels below the layer
+  double mOpacity;                      ///< Opacity of the layer
+ };
+
+ /// A polygon edge, top to bottom
+ struct Edge {
+  double mX0;   ///< X at the top
+  double mY0;   ///< Top
+  double mY1;   ///< Bottom
+  double mSlope;        ///< Change in x per unit of y
+  int mDirection;       ///< 1 if the polygon goes down this edge, -1 if up
+ };
+
+ /// Where a row of samples crosses an edge
+ struct Crossing {
+  double mX;            ///< X of the crossing
+  int mDirection;       ///< Direction of the edge
+ };
+
+ /// Width in pixels
+ int mWidth;
+
+ /// Height in pixels
+ int mHeight;
+
+ /// Premultiplied RGBA pixels, row by row from the top
+ std::vector<unsigned char> mPixels;
+
+ /// Current state
+ State mState;
+
+ /// States saved by PushState
+ std::vector<State> mStates;
+
+ /// Layers started by BeginLayer
+ std::vector<Layer> mLayers;
+
+ /// Premultiplied fill colour, 0 to 255
+ float mFillColour[4] = {0, 0, 0, 0};
+
+ /// Premultiplied pen colour, 0 to 255
+ float mPenColour[4] = {0, 0, 0, 0};
+
+ /// Pen width in user units
+ double mPenWidth = 1;
+
+ /// Pen cap
+ wxPenCap mPenCap = wxCAP_ROUND;
+
+ /// Pen join
+ wxPenJoin mPenJoin = wxJOIN_ROUND;
+
+ /// Image written when the renderer is destroyed, if any
+ wxImage* mTarget = nullptr;
+
+ std::vector<Edge> mEdges;              ///< Edges of the shape being rasterized
+ std::vector<size_t> mActive;           ///< Edges that reach the current row
+ std::vector<Crossing> mCrossings;      ///< Crossings of the current sample row
+ std::vector<float> mCoverage;          ///< Coverage of the current row
+ std::vector<float> mRow;               ///< Premultiplied bitmap pixels of the current row
+ std::vector<std::vector<wxPoint2DDouble>> mPolygons;   ///< Flattened path
+ std::vector<wxPoint2DDouble> mPoints;  ///< Points of a stroke piece
+
+ /// Determine if edges are antialiased
+ /// @return true unless antialiasing is off
+ bool IsAntialiased() const {return mState.mAntialias != wxANTIALIAS_NONE;}
+
+ void ReadImage(const wxImage& image);
+ void WriteImage(wxImage& image) const;
+ void AddPolygon(const wxPoint2DDouble* points, size_t count, bool reverse);
+ void AddPiece(const wxPoint2DDouble* points, size_t count);
+ void AddDisc(const wxPoint2DDouble& center, double radius);
+ void AddJoin(const wxPoint2DDouble& point, const wxPoint2DDouble& in, const wxPoint2DDouble& out, double halfWidth);
+ void AddSpan(double x0, double x1, double weight, int* left, int* right);
+ template <class RowFunction>
+ void Rasterize(wxPolygonFillMode fillStyle, RowFunction row);
+ void BlendSpan(int y, int left, int right, float* coverage, const float* colour);
+ void Fill(const DrawList::Path& path, wxPolygonFillMode fillStyle);
+ void Stroke(const DrawList::Path& path);
+ void ClipPolygon(const wxPoint2DDouble* points, size_t count);
+
+public:
+ SoftwareRenderer(int width, int height);
+ explicit SoftwareRenderer(wxImage& image);
+ ~SoftwareRenderer() override;
+
+ /// Copy constructor (disabled)
+ SoftwareRenderer(const SoftwareRenderer &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const SoftwareRenderer &) = delete;
+
+ void Clear(const wxColour& colour);
+ wxImage ToImage() const;
+
+ /// Get the pixels
+ /// @return Premultiplied RGBA pixels, row by row from the top
+ const std::vector<unsigned char>& GetPixels() const {return mPixels;}
+
+ DrawList::Matrix GetTransform() const override;
+ void GetSize(double* width, double* height) const override;
+ wxAntialiasMode GetAntialiasMode() const override;
+ wxInterpolationQuality GetInterpolationQuality() const override;
+ std::unique_ptr<IRenderer> CreateImageRenderer(wxImage& image) override;
+
+ void PushState() override;
+ void PopState() override;
+ void Translate(double dx, double dy) override;
+ void Scale(double xScale, double yScale) override;
+ void Rotate(double angle) override;
+ void ConcatTransform(const DrawList::Matrix& matrix) override;
+ void SetTransform(const DrawList::Matrix& matrix) override;
+ void Clip(const wxRegion& region) override;
+ void Clip(double x, double y, double w, double h) override;
+ void ResetClip() override;
+ void SetBrush(const DrawList::BrushEntry& brush) override;
+ void SetPen(const DrawList::PenEntry& pen) override;
+ void SetAntialiasMode(wxAntialiasMode antialias) override;
+ void SetInterpolationQuality(wxInterpolationQuality interpolation) override;
+ void SetCompositionMode(wxCompositionMode op) override;
+ void FillPath(const DrawList::PathEntry& path, wxPolygonFillMode fillStyle) override;
+ void StrokePath(const DrawList::PathEntry& path) override;
+ void DrawPath(const DrawList::PathEntry& path, wxPolygonFillMode fillStyle) override;
+ void DrawBitmap(const DrawList::BitmapEntry& bitmap, double x, double y, double w, double h) override;
+ void DrawText(const DrawList::TextEntry& text, double x, double y) override;
+ void BeginLayer(double opacity) override;
+ void EndLayer() override;
+};
+
+
+
+#endif //SOFTWARERENDERER_H
@@ -6,6 +6,7 @@
 
 #include "pch.h"
 #include "Sparty.h"
+#include "MachineArena.h"
 
 /// The spring pen size to use in pixels
 const double SpringWireSize = 2;
@@ -16,23 +17,9 @@ const double SpringWireMinSpacing = 1;
 /// Spring Color
 const wxColour SpringColor = wxColour(220, 220, 220);
 
-/// Sparty popup time in seconds
-const double SpartyPopupTime = 25;
-
-/// the minimum spring size
-const double MinSpringPosition = 40.0;
-
 /// move the spring into the right spot
 const int SpringOffset = 20;
 
-/// Minimum amplitude for horizontal bounce
-const double MinHorizontalBounceAmplitude = 30.0;
-
-/// Frequency of horizontal bounce
-const double HorizontalBounceFrequency = 5.0;
-
-/// makes the sparty slowly stop bouncing around
-const double HorizontalBounceDecay = 0.05;
 /**
  * Constructor
  * @param imagesDir
@@ -44,20 +31,9 @@ const double HorizontalBounceDecay = 0.05;
 Sparty::Sparty(const std::wstring& imagesDir, int size, int springLength, int springWidth, int numLinks)
     : mImagesDir(imagesDir),
       mSize(size),
-      mSpringLength(springLength),
       mSpringWidth(springWidth),
       mNumLinks(numLinks),
-      mSpringPosition(MinSpringPosition),
-      mIsPopup(false),
-      mShouldDecompress(false),  // Initially set to false, meaning no decompression
-      mIsBouncing(false),        // Initially, Sparty is not bouncing
-      mBounceTime(0.0),
-      mBounceAmplitude(15.0),     // Starting bounce height (can be adjusted)
-      mBounceFrequency(2.0),     // Frequency of bounce (can be adjusted)
-      mBounceDecay(0.05),         // Decay of the bounce amplitude (can be adjusted)
-      mHorizontalAmplitude(MinHorizontalBounceAmplitude),
-      mHorizontalFrequency(HorizontalBounceFrequency),
-      mHorizontalBounceDecay(HorizontalBounceDecay)
+      mModel(MachineArena::Make<SpartyModel>(springLength))
 {
     mSparty.Rectangle(-mSize / 2, 0, mSize, mSize);
     mSparty.SetImage(mImagesDir);
@@ -72,21 +48,15 @@ void Sparty::Draw(std::shared_ptr<wxGraphicsContext> graphics)
     graphics->PushState();
 
     // Apply horizontal and vertical translation to both Sparty and the spring
-    double horizontalOffset = mHorizontalAmplitude * std::sin(mHorizontalFrequency * mBounceTime);
+    double horizontalOffset = mModel->GetHorizontalOffset();
     graphics->Translate(horizontalOffset, 0);  // Move both horizontally
 
     // Draw the spring first (spring will move horizontally with Sparty)
-    DrawSpring(graphics, 0, 0, mSpringPosition, mSpringWidth, mNumLinks);
-
-    // Now draw Sparty image on top of the spring, applying bounce translation
-    if (mIsBouncing) {
-        // Apply vertical bouncing translation (sinusoidal bounce effect)
-        double bounceOffset = mBounceAmplitude * std::sin(mBounceFrequency * mBounceTime);
-        graphics->Translate(0, -mSpringPosition + SpringOffset + bounceOffset);  // Adjust vertical translation for bounce
-    } else {
-        // If not bouncing, just use normal vertical positioning
-        graphics->Translate(0, -mSpringPosition + SpringOffset);
-    }
+    double springPosition = mModel->GetSpringPosition();
+    DrawSpring(graphics, 0, 0, springPosition, mSpringWidth, mNumLinks);
+
+    // Now draw Sparty image on top of the spring, applying the bounce translation
+    graphics->Translate(0, -springPosition + SpringOffset + mModel->GetBounceOffset());
 
     // Draw the Sparty image at the correct position
     mSparty.DrawPolygon(graphics, 0, 0);
@@ -94,46 +64,6 @@ void Sparty::Draw(std::shared_ptr<wxGraphicsContext> graphics)
     graphics->PopState();
 }
 
-/**
- * Update positions so Sparty springs upwards
- */
-void Sparty::UpdatePosition()
-{
-    // Check if decompression is triggered
-    if (mShouldDecompress && mSpringPosition < mSpringLength) {
-        mSpringPosition += SpartyPopupTime;  // Gradually decompress the spring
-    } else if (mSpringPosition >= mSpringLength) {
-        mIsPopup = true;  // Sparty has finished popping up
-        StartBounce();    // Start bouncing once Sparty has popped up
-    }
-}
-
-/**
- * Reset Sparty and spring into original loctaions
- */
-void Sparty::Reset()
-{
-    mSpringPosition = MinSpringPosition;
-    mIsPopup = false;
-    mShouldDecompress = false;
-    mIsBouncing = false;
-    mBounceTime = 0.0;
-    mBounceAmplitude = 15.0;
-    mHorizontalAmplitude = MinHorizontalBounceAmplitude;  // Reset horizontal bounce
-}
-
-/**
- * Sets flags for when key drop is triggered
- * @param keyY
- */
-void Sparty::KeyDroppedTriggered(double keyY)
-{
-    // Set the flag to start decompression
-    mShouldDecompress = true;
-    mIsPopup = false;  // Ensure Sparty is not already in the popped-up state
-
-}
-
 /**
  * Draw the spring
  * @param graphics
@@ -145,63 +75,79 @@ void Sparty::KeyDroppedTriggered(double keyY)
  */
 void Sparty::DrawSpring(std::shared_ptr<wxGraphicsContext> graphics, int x, int y, double length, double width, int numLinks)
 {
-    auto path = graphics->CreatePath();
-
-    double y1 = y;
     double linkLength = length / numLinks;
 
     double xR = x + width / 2;
     double xL = x - width / 2;
 
-    path.MoveToPoint(x + mHorizontalAmplitude * std::sin(mHorizontalFrequency * mBounceTime), y1); // Apply horizontal offset
-
-    for (int i = 0; i < numLinks; i++) {
-        auto y2 = y1 - linkLength;
-        auto y3 = y2 - linkLength / 2;
-
-        path.AddCurveToPoint(xR, y1, xR, y3, x, y3);
-        path.AddCurveToPoint(xL, y3, xL, y2, x, y2);
-
-        y1 = y2;
+    // The spring starts at the horizontal offset, which changes as Sparty
+    // bounces, so the first half link is made every time. The rest of the
+    // path only has to be made again when the spring is stretched.
+    double yStart = y - linkLength * 1.5;
+    auto start = graphics->CreatePath();
+    start.MoveToPoint(x + mModel->GetHorizontalOffset(), y); // Apply horizontal offset
+    start.AddCurveToPoint(xR, y, xR, yStart, x, yStart);
+
+    std::tuple<int, int, double, double, int> key(x, y, length, width, numLinks);
+    if (mSpringRenderer != graphics->GetRenderer() || key != mSpringKey)
+    {
+        mSpringPath = graphics->CreatePath();
+        mSpringRenderer = graphics->GetRenderer();
+        mSpringKey = key;
+
+        double y1 = y;
+        mSpringPath.MoveToPoint(x, yStart);
+
+        for (int i = 0; i < numLinks; i++) {
+            auto y2 = y1 - linkLength;
+            auto y3 = y2 - linkLength / 2;
+
+            if (i > 0)
+            {
+                mSpringPath.AddCurveToPoint(xR, y1, xR, y3, x, y3);
+            }
+            mSpringPath.AddCurveToPoint(xL, y3, xL, y2, x, y2);
+
+            y1 = y2;
+        }
     }
 
-    graphics->StrokePath(path);
+    graphics->StrokePath(start);
+    graphics->StrokePath(mSpringPath);
 }
 
 /**
- * Update the animation of sparty bouncing and him springing up
- * @param delta
+ * Get the area Sparty and the spring draw in
+ * @return Bounding box
  */
-void Sparty::Advance(double delta)
+wxRect Sparty::GetBoundingBox()
 {
-    if (mIsBouncing) {
-        mBounceTime += delta; // Update bounce time
-
-        // Vertical bounce decay
-        mBounceAmplitude -= mBounceDecay;
-        if (mBounceAmplitude < 0) mBounceAmplitude = 0;  // Stop vertical bouncing when amplitude is too small
-
-        // Horizontal bounce decay
-        mHorizontalAmplitude -= mHorizontalBounceDecay;
-        if (mHorizontalAmplitude < 0) mHorizontalAmplitude = 0; // Stop horizontal bouncing when amplitude is too small
-    }
-
-    UpdatePosition();  // Update the spring position and other related states
+    double horizontalOffset = mModel->GetHorizontalOffset();
+    double springPosition = mModel->GetSpringPosition();
+    double spartyBottom = -springPosition + SpringOffset + mModel->GetBounceOffset();
+
+    // The spring path starts offset twice, once by the translation
+    // and once by the path itself
+    double halfWidth = std::max(mSize, mSpringWidth) / 2.0 + std::abs(horizontalOffset);
+    return BoundingBox(horizontalOffset - halfWidth, std::min(spartyBottom - mSize, -springPosition),
+            horizontalOffset + halfWidth, std::max(spartyBottom, 0.0) + SpringWireSize);
 }
 
 /**
- * Start the bouncing animation of sparty
+ * Get the values Sparty's drawing depends on
+ * @param appearance Vector to append the values to
  */
-void Sparty::StartBounce()
+void Sparty::GetAppearance(std::vector<double>& appearance)
 {
-    if (mIsPopup && !mIsBouncing) {
-        mIsBouncing = true;  // Start bouncing once Sparty pops up
-
-        // Set initial horizontal bounce parameters
-        mHorizontalAmplitude = MinHorizontalBounceAmplitude;  // Initial horizontal amplitude (adjustable)
-        mHorizontalFrequency = 1.0;   // Initial horizontal bounce frequency (adjustable)
-        mHorizontalBounceDecay = 0.05; // Decay for horizontal bounce
-    }
+    appearance.push_back(mModel->GetHorizontalOffset());
+    appearance.push_back(mModel->GetSpringPosition());
+    appearance.push_back(mModel->GetBounceOffset());
 }
 
-
+/**
+ * Decode the Sparty image
+ */
+void Sparty::LoadImages()
+{
+    mSparty.PreloadImage();
+}
@@ -9,10 +9,11 @@
 #define SPARTY_H
 #include "Component.h"
 #include "Polygon.h"
-#include "IKeyDropListener.h"
+#include "SpartyModel.h"
+#include <tuple>
 
 /// The Sparty Component
-class Sparty : public Component, public IKeyDropListener {
+class Sparty : public Component {
 private:
  /// Sparty polygon
  cse335::Polygon mSparty;
@@ -23,57 +24,44 @@ private:
  /// size
  int mSize;
 
- /// Spring length
- int mSpringLength;
-
  /// Spring width
  int mSpringWidth;
 
  /// number of links/loops in spring
  int mNumLinks = 0;
 
- /// Controls the spring's decompression and Sparty's position
- double mSpringPosition;
-
- /// Flag to determine if Sparty is currently popping up
- bool mIsPopup;
-
- ///should Key trigger
- bool mShouldDecompress;
-
- /// Flag to indicate if Sparty is currently bouncing
- bool mIsBouncing;
-
- /// Time tracking for the bounce
- double mBounceTime;
-
- /// Amplitude (height) of the bounce
- double mBounceAmplitude;
+ /// Simulation of the spring and bounce
+ std::shared_ptr<SpartyModel> mModel;
 
- /// Frequency of the bounce (speed)
- double mBounceFrequency;
+ /// Spring path after its first half link, made by the last DrawSpring call
+ wxGraphicsPath mSpringPath;
 
- /// The decay rate for vertical bounce motion.
- double mBounceDecay;
+ /// Renderer mSpringPath belongs to
+ wxGraphicsRenderer* mSpringRenderer = nullptr;
 
- /// Amplitude of horizontal bounce
- double mHorizontalAmplitude;
-
- /// Frequency of horizontal bounce
- double mHorizontalFrequency;
-
- /// The decay rate for horizontal bounce motion.
- double mHorizontalBounceDecay;
+ /// Position, length, width and links mSpringPath was made for
+ std::tuple<int, int, double, double, int> mSpringKey;
 
 public:
  Sparty(const std::wstring &imagesDir, int size, int springLength, int springWidth, int numLinks);
  void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
  void DrawSpring(std::shared_ptr<wxGraphicsContext> graphics, int x, int y, double length, double width, int numLinks);
- void UpdatePosition();
- void Reset() override;
- void Advance(double delta) override;
- void StartBounce();
- void KeyDroppedTriggered(double keyY) override;
+
+ /// Get the simulation model
+ /// @return SpartyModel
+ std::shared_ptr<ComponentModel> GetModel() override {return mModel;}
+
+ /// Get the name of the kind of component
+ /// @return Name
+ std::wstring GetName() override {return L"Sparty";}
+
+ wxRect GetBoundingBox() override;
+ void GetAppearance(std::vector<double>& appearance) override;
+ void LoadImages() override;
+
+ /// Get the listener that pops Sparty up when the key drops
+ /// @return IKeyDropListener
+ IKeyDropListener* GetKeyDropListener() {return mModel.get();}
 };
 
 
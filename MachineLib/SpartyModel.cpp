@@ -0,0 +1,154 @@
+/**
+ * @file SpartyModel.cpp
+ * @author Thomas Conley
+ */
+
+#include "SpartyModel.h"
+#include <cmath>
+
+/// How fast the spring extends while popping up in pixels per second
+const double SpartyPopupSpeed = 750;
+
+/// the minimum spring size
+const double MinSpringPosition = 40.0;
+
+/// Starting bounce height
+const double BounceAmplitude = 15.0;
+
+/// Frequency of the vertical bounce
+const double BounceFrequency = 2.0;
+
+/// Decay of the bounce amplitude in pixels per second
+const double BounceDecay = 1.5;
+
+/// Minimum amplitude for horizontal bounce
+const double MinHorizontalBounceAmplitude = 30.0;
+
+/// Frequency of horizontal bounce
+const double HorizontalBounceFrequency = 1.0;
+
+/// makes the sparty slowly stop bouncing around, in pixels per second
+const double HorizontalBounceDecay = 1.5;
+
+/**
+ * Constructor
+ * @param springLength How long the spring is when fully extended in pixels
+ */
+SpartyModel::SpartyModel(int springLength) : mSpringLength(springLength)
+{
+}
+
+/**
+ * Reset Sparty and spring into original loctaions
+ */
+void SpartyModel::Reset()
+{
+    *mTime = 0;
+    mReleaseTime = -1;
+}
+
+/**
+ * Release the spring when the key drops
+ * @param time Machine time the key dropped
+ */
+void SpartyModel::KeyDroppedTriggered(double time)
+{
+    mReleaseTime = time;
+}
+
+/**
+ * Set Sparty to a machine time. The spring is released
+ * again if the key drop is reported for this time.
+ * @param time Machine time in seconds
+ */
+void SpartyModel::EvaluateAt(double time)
+{
+    *mTime = time;
+    mReleaseTime = -1;
+}
+
+/**
+ * Get the spring position
+ * @return Current spring length in pixels
+ */
+double SpartyModel::GetSpringPosition() const
+{
+    if (mReleaseTime < 0 || *mTime <= mReleaseTime) {
+        return MinSpringPosition;
+    }
+
+    double position = MinSpringPosition + SpartyPopupSpeed * (*mTime - mReleaseTime);
+    return position < mSpringLength ? position : mSpringLength;
+}
+
+/**
+ * How long Sparty has been bouncing. Bouncing starts
+ * once the spring is fully extended.
+ * @return Time in seconds, 0 if not bouncing yet
+ */
+double SpartyModel::GetBounceTime() const
+{
+    if (mReleaseTime < 0) {
+        return 0;
+    }
+
+    double popupTime = (mSpringLength - MinSpringPosition) / SpartyPopupSpeed;
+    double bounceTime = *mTime - mReleaseTime - popupTime;
+    return bounceTime > 0 ? bounceTime : 0;
+}
+
+/**
+ * Get the horizontal offset of Sparty and the spring
+ * @return Offset in pixels
+ */
+double SpartyModel::GetHorizontalOffset() const
+{
+    double bounceTime = GetBounceTime();
+
+    // Stop horizontal bouncing when amplitude is too small
+    double amplitude = MinHorizontalBounceAmplitude - HorizontalBounceDecay * bounceTime;
+    if (amplitude <= 0) {
+        return 0;
+    }
+
+    return amplitude * std::sin(HorizontalBounceFrequency * bounceTime);
+}
+
+/**
+ * Get the vertical bounce offset of Sparty
+ * @return Offset in pixels, 0 when not bouncing
+ */
+double SpartyModel::GetBounceOffset() const
+{
+    double bounceTime = GetBounceTime();
+
+    // Stop vertical bouncing when amplitude is too small
+    double amplitude = BounceAmplitude - BounceDecay * bounceTime;
+    if (amplitude <= 0) {
+        return 0;
+    }
+
+    return amplitude * std::sin(BounceFrequency * bounceTime);
+}
+
+/**
+ * Save the spring and bounce state to a checkpoint
+ * @param state
+ */
+void SpartyModel::SaveState(std::vector<double>& state)
+{
+    state.push_back(*mTime);
+    state.push_back(mReleaseTime);
+}
+
+/**
+ * Restore the spring and bounce state from a checkpoint
+ * @param state
+ * @return Pointer past the values this Sparty saved
+ */
+const double* SpartyModel::RestoreState(const double* state)
+{
+    *mTime = *state++;
+    mReleaseTime = *state++;
+    return state;
+}
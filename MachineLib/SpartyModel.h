@@ -0,0 +1,55 @@
+/**
+ * @file SpartyModel.h
+ * @author Thomas Conley
+ *
+ *
+ */
+ 
+#ifndef SPARTYMODEL_H
+#define SPARTYMODEL_H
+#include "ComponentModel.h"
+#include "IKeyDropListener.h"
+#include "PooledState.h"
+
+/// Simulation of Sparty popping up on the spring and bouncing
+class SpartyModel final : public ComponentModel, public IKeyDropListener {
+private:
+ /// Spring length when fully extended
+ int mSpringLength;
+
+ /// Machine time in seconds, stepped by Mechanism with the other clocks
+ PooledState<double> mTime;
+
+ /// Machine time the spring was released, negative until the key drops
+ double mReleaseTime = -1;
+
+ double GetBounceTime() const;
+
+public:
+ SpartyModel(int springLength);
+ void Reset() override;
+
+ /// Advance the model clock
+ /// @param delta Time to advance in seconds
+ void Advance(double delta) override {*mTime += delta;}
+
+ /// Get the model clock, for Mechanism to pool
+ /// @return Machine time in seconds
+ PooledState<double>& GetClock() {return mTime;}
+
+ void EvaluateAt(double time) override;
+ void KeyDroppedTriggered(double time) override;
+ void SaveState(std::vector<double>& state) override;
+ const double* RestoreState(const double* state) override;
+ double GetHorizontalOffset() const;
+ double GetBounceOffset() const;
+ double GetSpringPosition() const;
+
+ /// The spring and bounce are functions of the time since the key dropped
+ /// @return true
+ bool CanEvaluate() const override {return true;}
+};
+
+
+
+#endif //SPARTYMODEL_H
@@ -0,0 +1,295 @@
+/**
+ * @file WxRenderer.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "WxRenderer.h"
+
+/**
+ * Get the path to draw for a path entry
+ * @param path Path entry of the list
+ * @return Path made by the graphics context's renderer, or the foreign path
+ */
+wxGraphicsPath WxRenderer::GetPath(const DrawList::PathEntry& path) const
+{
+ return path.mPath != nullptr ? path.mPath->GetNative(mGraphics) : path.mForeign;
+}
+
+/**
+ * Get the current transform
+ * @return Transform of the graphics context
+ */
+DrawList::Matrix WxRenderer::GetTransform() const
+{
+ DrawList::Matrix matrix;
+ mGraphics->GetTransform().Get(&matrix.mA, &matrix.mB, &matrix.mC, &matrix.mD, &matrix.mTx, &matrix.mTy);
+ return matrix;
+}
+
+/**
+ * Get the size of the drawing area
+ * @param width Receives the width in pixels
+ * @param height Receives the height in pixels
+ */
+void WxRenderer::GetSize(double* width, double* height) const
+{
+ mGraphics->GetSize(width, height);
+}
+
+/**
+ * Get the current antialiasing mode
+ * @return Antialiasing mode of the graphics context
+ */
+wxAntialiasMode WxRenderer::GetAntialiasMode() const
+{
+ return mGraphics->GetAntialiasMode();
+}
+
+/**
+ * Get the current interpolation quality
+ * @return Interpolation quality of the graphics context
+ */
+wxInterpolationQuality WxRenderer::GetInterpolationQuality() const
+{
+ return mGraphics->GetInterpolationQuality();
+}
+
+/**
+ * Make a renderer that draws into an image with a graphics context
+ * @param image Image to draw into
+ * @return New renderer, which writes the image when destroyed
+ */
+std::unique_ptr<IRenderer> WxRenderer::CreateImageRenderer(wxImage& image)
+{
+ return std::make_unique<WxRenderer>(std::shared_ptr<wxGraphicsContext>(wxGraphicsContext::Create(image)));
+}
+
+/**
+ * Save the state of the graphics context
+ */
+void WxRenderer::PushState()
+{
+ mGraphics->PushState();
+}
+
+/**
+ * Restore the state of the graphics context
+ */
+void WxRenderer::PopState()
+{
+ mGraphics->PopState();
+}
+
+/**
+ * Translate the transform
+ * @param dx X offset
+ * @param dy Y offset
+ */
+void WxRenderer::Translate(double dx, double dy)
+{
+ mGraphics->Translate(dx, dy);
+}
+
+/**
+ * Scale the transform
+ * @param xScale X scale
+ * @param yScale Y scale
+ */
+void WxRenderer::Scale(double xScale, double yScale)
+{
+ mGraphics->Scale(xScale, yScale);
+}
+
+/**
+ * Rotate the transform
+ * @param angle Angle in radians
+ */
+void WxRenderer::Rotate(double angle)
+{
+ mGraphics->Rotate(angle);
+}
+
+/**
+ * Apply a matrix before the current transform
+ * @param matrix Matrix to apply
+ */
+void WxRenderer::ConcatTransform(const DrawList::Matrix& matrix)
+{
+ mGraphics->ConcatTransform(mGraphics->CreateMatrix(matrix.mA, matrix.mB, matrix.mC, matrix.mD,
+         matrix.mTx, matrix.mTy));
+}
+
+/**
+ * Replace the current transform
+ * @param matrix New transform
+ */
+void WxRenderer::SetTransform(const DrawList::Matrix& matrix)
+{
+ mGraphics->SetTransform(mGraphics->CreateMatrix(matrix.mA, matrix.mB, matrix.mC, matrix.mD,
+         matrix.mTx, matrix.mTy));
+}
+
+/**
+ * Clip to a region
+ * @param region Region in user coordinates
+ */
+void WxRenderer::Clip(const wxRegion& region)
+{
+ mGraphics->Clip(region);
+}
+
+/**
+ * Clip to a rectangle
+ * @param x Left of the rectangle
+ * @param y Top of the rectangle
+ * @param w Width of the rectangle
+ * @param h Height of the rectangle
+ */
+void WxRenderer::Clip(double x, double y, double w, double h)
+{
+ mGraphics->Clip(x, y, w, h);
+}
+
+/**
+ * Remove the clip
+ */
+void WxRenderer::ResetClip()
+{
+ mGraphics->ResetClip();
+}
+
+/**
+ * Set the brush
+ * @param brush Brush entry of the list
+ */
+void WxRenderer::SetBrush(const DrawList::BrushEntry& brush)
+{
+ if (brush.mForeign.IsNull())
+ {
+  mGraphics->SetBrush(brush.mBrush);
+ }
+ else
+ {
+  mGraphics->SetBrush(brush.mForeign);
+ }
+}
+
+/**
+ * Set the pen
+ * @param pen Pen entry of the list
+ */
+void WxRenderer::SetPen(const DrawList::PenEntry& pen)
+{
+ if (!pen.mForeign.IsNull())
+ {
+  mGraphics->SetPen(pen.mForeign);
+ }
+ else if (pen.mNull)
+ {
+  mGraphics->SetPen(wxNullGraphicsPen);
+ }
+ else
+ {
+  mGraphics->SetPen(mGraphics->CreatePen(pen.mInfo));
+ }
+}
+
+/**
+ * Set the antialiasing mode
+ * @param antialias New mode
+ */
+void WxRenderer::SetAntialiasMode(wxAntialiasMode antialias)
+{
+ mGraphics->SetAntialiasMode(antialias);
+}
+
+/**
+ * Set the interpolation quality
+ * @param interpolation New quality
+ */
+void WxRenderer::SetInterpolationQuality(wxInterpolationQuality interpolation)
+{
+ mGraphics->SetInterpolationQuality(interpolation);
+}
+
+/**
+ * Set the composition mode
+ * @param op New composition mode
+ */
+void WxRenderer::SetCompositionMode(wxCompositionMode op)
+{
+ mGraphics->SetCompositionMode(op);
+}
+
+/**
+ * Fill a path
+ * @param path Path entry of the list
+ * @param fillStyle Fill rule
+ */
+void WxRenderer::FillPath(const DrawList::PathEntry& path, wxPolygonFillMode fillStyle)
+{
+ mGraphics->FillPath(GetPath(path), fillStyle);
+}
+
+/**
+ * Stroke a path
+ * @param path Path entry of the list
+ */
+void WxRenderer::StrokePath(const DrawList::PathEntry& path)
+{
+ mGraphics->StrokePath(GetPath(path));
+}
+
+/**
+ * Fill and stroke a path
+ * @param path Path entry of the list
+ * @param fillStyle Fill rule
+ */
+void WxRenderer::DrawPath(const DrawList::PathEntry& path, wxPolygonFillMode fillStyle)
+{
+ mGraphics->DrawPath(GetPath(path), fillStyle);
+}
+
+/**
+ * Draw a bitmap
+ * @param bitmap Bitmap entry of the list
+ * @param x Left of the rectangle
+ * @param y Top of the rectangle
+ * @param w Width of the rectangle
+ * @param h Height of the rectangle
+ */
+void WxRenderer::DrawBitmap(const DrawList::BitmapEntry& bitmap, double x, double y, double w, double h)
+{
+ auto native = bitmap.mBitmap != nullptr ? bitmap.mBitmap->GetNative(mGraphics) : bitmap.mForeign;
+ mGraphics->DrawBitmap(native, x, y, w, h);
+}
+
+/**
+ * Draw text
+ * @param text Text entry of the list
+ * @param x Left of the text
+ * @param y Top of the text
+ */
+void WxRenderer::DrawText(const DrawList::TextEntry& text, double x, double y)
+{
+ mGraphics->SetFont(text.mFont);
+ mGraphics->DrawText(text.mText, x, y);
+}
+
+/**
+ * Start a layer
+ * @param opacity Opacity of the layer
+ */
+void WxRenderer::BeginLayer(double opacity)
+{
+ mGraphics->BeginLayer(opacity);
+}
+
+/**
+ * Blend the layer in
+ */
+void WxRenderer::EndLayer()
+{
+ mGraphics->EndLayer();
+}
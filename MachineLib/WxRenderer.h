@@ -0,0 +1,69 @@
+/**
+ * @file WxRenderer.h
+ * @author Thomas Conley
+ *
+ * Renderer that draws through a wxGraphicsContext.
+ */
+
+#ifndef WXRENDERER_H
+#define WXRENDERER_H
+
+#include "IRenderer.h"
+
+/**
+ * Renderer that draws through a wxGraphicsContext.
+ *
+ * Every command is passed on to the graphics context. Recorded
+ * paths and bitmaps are converted to the context's own the first
+ * time they are drawn, and objects from other renderers are used
+ * as they are.
+ */
+class WxRenderer : public IRenderer {
+private:
+ /// Graphics context to draw on
+ std::shared_ptr<wxGraphicsContext> mGraphics;
+
+ wxGraphicsPath GetPath(const DrawList::PathEntry& path) const;
+
+public:
+ /// Constructor
+ /// @param graphics Graphics context to draw on
+ explicit WxRenderer(std::shared_ptr<wxGraphicsContext> graphics) : mGraphics(graphics) {}
+
+ /// Get the graphics context drawn on
+ /// @return Graphics context
+ std::shared_ptr<wxGraphicsContext> GetGraphics() const {return mGraphics;}
+
+ DrawList::Matrix GetTransform() const override;
+ void GetSize(double* width, double* height) const override;
+ wxAntialiasMode GetAntialiasMode() const override;
+ wxInterpolationQuality GetInterpolationQuality() const override;
+ std::unique_ptr<IRenderer> CreateImageRenderer(wxImage& image) override;
+
+ void PushState() override;
+ void PopState() override;
+ void Translate(double dx, double dy) override;
+ void Scale(double xScale, double yScale) override;
+ void Rotate(double angle) override;
+ void ConcatTransform(const DrawList::Matrix& matrix) override;
+ void SetTransform(const DrawList::Matrix& matrix) override;
+ void Clip(const wxRegion& region) override;
+ void Clip(double x, double y, double w, double h) override;
+ void ResetClip() override;
+ void SetBrush(const DrawList::BrushEntry& brush) override;
+ void SetPen(const DrawList::PenEntry& pen) override;
+ void SetAntialiasMode(wxAntialiasMode antialias) override;
+ void SetInterpolationQuality(wxInterpolationQuality interpolation) override;
+ void SetCompositionMode(wxCompositionMode op) override;
+ void FillPath(const DrawList::PathEntry& path, wxPolygonFillMode fillStyle) override;
+ void StrokePath(const DrawList::PathEntry& path) override;
+ void DrawPath(const DrawList::PathEntry& path, wxPolygonFillMode fillStyle) override;
+ void DrawBitmap(const DrawList::BitmapEntry& bitmap, double x, double y, double w, double h) override;
+ void DrawText(const DrawList::TextEntry& text, double x, double y) override;
+ void BeginLayer(double opacity) override;
+ void EndLayer() override;
+};
+
+
+
+#endif //WXRENDERER_H
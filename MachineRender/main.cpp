@@ -0,0 +1,250 @@
+/**
+ * @file main.cpp
+ * @author Thomas Conley
+ *
+ * Command line program that renders a machine animation to files.
+ */
+
+#include "pch.h"
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
+#include <wx/thread.h>
+#include <chrono>
+#include <cstdio>
+
+#include <IMachineSystem.h>
+#include <MachineSystemFactory.h>
+#include <FrameRenderer.h>
+#include <ParallelRenderer.h>
+#include <MachineLoader.h>
+#include <MachineRegistry.h>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+/// Default frame width in machine pixels
+const int DefaultWidth = 800;
+
+/// Default frame height in machine pixels
+const int DefaultHeight = 700;
+
+/// The command line options
+static const wxCmdLineEntryDesc CommandLine[] = {
+    {wxCMD_LINE_SWITCH, "h", "help", "show this help", wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP},
+    {wxCMD_LINE_OPTION, "m", "machine", "machine number (default 1)", wxCMD_LINE_VAL_NUMBER},
+    {wxCMD_LINE_OPTION, "s", "start", "first frame to render (default 0)", wxCMD_LINE_VAL_NUMBER},
+    {wxCMD_LINE_OPTION, "e", "end", "last frame to render (default 299)", wxCMD_LINE_VAL_NUMBER},
+    {wxCMD_LINE_OPTION, "r", "fps", "frame rate in frames per second (default 30)", wxCMD_LINE_VAL_DOUBLE},
+    {wxCMD_LINE_OPTION, "x", "scale", "resolution scale (default 1)", wxCMD_LINE_VAL_DOUBLE},
+    {wxCMD_LINE_OPTION, "W", "width", "frame width before scaling (default 800)", wxCMD_LINE_VAL_NUMBER},
+    {wxCMD_LINE_OPTION, "H", "height", "frame height before scaling (default 700)", wxCMD_LINE_VAL_NUMBER},
+    {wxCMD_LINE_OPTION, "t", "threads", "worker threads (default one per processor)", wxCMD_LINE_VAL_NUMBER},
+    {wxCMD_LINE_OPTION, "c", "chunk", "frames each thread renders at a time (default 30)", wxCMD_LINE_VAL_NUMBER},
+    {wxCMD_LINE_OPTION, "f", "format", "png or raw (default png)"},
+    {wxCMD_LINE_SWITCH, "w", "software", "draw with the software renderer instead of wxWidgets"},
+    {wxCMD_LINE_OPTION, "o", "output", "printf pattern for png files, or file for raw, - for standard output"},
+    {wxCMD_LINE_OPTION, "d", "resources", "resources directory (default next to the program)"},
+    {wxCMD_LINE_OPTION, "S", "snapshot", "write a snapshot of the machine's description to this file instead of rendering"},
+    {wxCMD_LINE_NONE}
+};
+
+/**
+ * Get the resources directory
+ * @param parser Parsed command line
+ * @return The directory given on the command line or the one next to the program
+ */
+static wxString ResourcesDir(wxCmdLineParser& parser)
+{
+    wxString resourcesDir = wxFileName(wxStandardPaths::Get().GetExecutablePath()).GetPath();
+    parser.Found("resources", &resourcesDir);
+    return resourcesDir;
+}
+
+/**
+ * Write a snapshot of the chosen machine's description file
+ * @param parser Parsed command line
+ * @param output Snapshot file to write
+ * @return Exit code
+ */
+static int Snapshot(wxCmdLineParser& parser, const wxString& output)
+{
+    long machineNumber = 1;
+    parser.Found("machine", &machineNumber);
+
+    auto resourcesDir = ResourcesDir(parser).ToStdWstring();
+    MachineRegistry registry;
+    registry.Scan(resourcesDir);
+    auto filename = registry.Find(machineNumber);
+    if (filename.empty())
+    {
+        wxFprintf(stderr, "Machine %d has no description file\n", (int)machineNumber);
+        return 1;
+    }
+
+    MachineLoader loader(resourcesDir);
+    MachineSnapshot snapshot;
+    if (!loader.Read(filename, snapshot) || !loader.WriteSnapshot(output.ToStdWstring(), snapshot))
+    {
+        wxFprintf(stderr, "%s\n", wxString(loader.GetError()));
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Render the requested frames
+ * @param parser Parsed command line
+ * @return Exit code
+ */
+static int Render(wxCmdLineParser& parser)
+{
+    long machineNumber = 1, start = 0, end = 299, width = DefaultWidth, height = DefaultHeight;
+    long threads = wxThread::GetCPUCount(), chunk = 30;
+    double frameRate = 30, scale = 1;
+    wxString format = "png";
+    wxString output;
+    parser.Found("machine", &machineNumber);
+    parser.Found("start", &start);
+    parser.Found("end", &end);
+    parser.Found("fps", &frameRate);
+    parser.Found("scale", &scale);
+    parser.Found("width", &width);
+    parser.Found("height", &height);
+    parser.Found("threads", &threads);
+    parser.Found("chunk", &chunk);
+    parser.Found("format", &format);
+
+    bool raw = format == "raw";
+    if (!raw && format != "png")
+    {
+        wxFprintf(stderr, "Unknown format %s\n", format);
+        return 1;
+    }
+
+    if (!parser.Found("output", &output))
+    {
+        output = raw ? "-" : "frame%05d.png";
+    }
+
+    if (start < 0 || end < start || frameRate <= 0 || scale <= 0 || width <= 0 || height <= 0 ||
+        threads <= 0 || chunk <= 0)
+    {
+        wxFprintf(stderr, "Invalid frame range, rate, scale, size, threads or chunk\n");
+        return 1;
+    }
+
+    wxString resourcesDir = ResourcesDir(parser);
+
+    int frameWidth = int(width * scale);
+    int frameHeight = int(height * scale);
+    ParallelRenderer renderer(resourcesDir.ToStdWstring(), frameWidth, frameHeight);
+    renderer.SetMachineNumber(machineNumber);
+    renderer.SetFrameRate(frameRate);
+    renderer.SetScale(scale);
+    renderer.SetSoftware(parser.Found("software"));
+    renderer.SetThreads(threads);
+    renderer.SetChunkFrames(chunk);
+    renderer.SetMaxBuffered(threads * chunk * 2);
+
+    FILE* rawFile = nullptr;
+    if (raw)
+    {
+        if (output == "-")
+        {
+#ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+            rawFile = stdout;
+        }
+        else
+        {
+            rawFile = fopen(output.mb_str(), "wb");
+            if (rawFile == nullptr)
+            {
+                wxFprintf(stderr, "Unable to open %s\n", output);
+                return 1;
+            }
+        }
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    bool written = renderer.Render(start, end, [&](int frame, const wxImage& image) {
+        if (raw ? FrameRenderer::WriteRgba(image, rawFile)
+                : FrameRenderer::WritePng(image, wxString::Format(output, frame)))
+        {
+            return true;
+        }
+
+        wxFprintf(stderr, "Unable to write frame %d\n", frame);
+        return false;
+    });
+
+    if (rawFile != nullptr && rawFile != stdout)
+    {
+        fclose(rawFile);
+    }
+    else if (rawFile != nullptr)
+    {
+        fflush(rawFile);
+    }
+
+    if (!written)
+    {
+        return 1;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+    long frames = end - start + 1;
+    wxFprintf(stderr, "Rendered %ld frames at %dx%d on %ld threads in %.2f seconds, %.1f frames per second\n",
+              frames, frameWidth, frameHeight, threads,
+              elapsed.count(), frames / elapsed.count());
+
+    return 0;
+}
+
+/**
+ * Main entry point
+ * @param argc Argument count
+ * @param argv Arguments
+ * @return Exit code
+ */
+int main(int argc, char** argv)
+{
+    // Graphics contexts and fonts need the GUI library initialized,
+    // but no window or event loop is ever created
+    wxApp::SetInstance(new wxApp());
+    if (!wxEntryStart(argc, argv))
+    {
+        fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+
+    wxInitAllImageHandlers();
+
+    int result;
+    wxCmdLineParser parser(CommandLine, argc, argv);
+    switch (parser.Parse())
+    {
+    case -1:
+        result = 0;     // Help was shown
+        break;
+
+    case 0:
+    {
+        wxString snapshot;
+        result = parser.Found("snapshot", &snapshot) ? Snapshot(parser, snapshot) : Render(parser);
+        break;
+    }
+
+    default:
+        result = 1;
+        break;
+    }
+
+    wxEntryCleanup();
+    return result;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file ArenaTest.cpp
+ * @author Thomas Conley
+ *
+ * Tests of building models in a machine arena.
+ */
+
+#include "pch.h"
+#include "gtest/gtest.h"
+
+#include <MachineArena.h>
+#include <CrankModel.h>
+#include <RotatingModel.h>
+#include <CamModel.h>
+#include <BoxModel.h>
+
+/**
+ * Build a long train of shafts with cams and boxes along it
+ * @param models Receives the models so they outlive the build
+ */
+static void Build(std::vector<std::shared_ptr<ComponentModel>>& models)
+{
+    auto crank = MachineArena::Make<CrankModel>();
+    models.push_back(crank);
+    RotationSource* source = crank->GetSource();
+    for (int i = 0; i < 200; i++)
+    {
+        auto shaft = MachineArena::Make<RotatingModel>();
+        source->AddSink(shaft);
+        models.push_back(shaft);
+
+        auto cam = MachineArena::Make<CamModel>();
+        shaft->GetSource()->AddSink(cam);
+        auto box = MachineArena::Make<BoxModel>();
+        cam->AddKeyDrop(box.get());
+        models.push_back(cam);
+        models.push_back(box);
+
+        source = shaft->GetSource();
+    }
+}
+
+TEST(ArenaTest, Allocations)
+{
+    std::vector<std::shared_ptr<ComponentModel>> models;
+    models.reserve(1000);
+    auto arena = std::make_shared<MachineArena>();
+    {
+        MachineArena::Scope scope(arena);
+        Build(models);
+    }
+
+    // Every model and list would have been its own heap allocation,
+    // but the arena took only a few blocks from the heap
+    RecordProperty("ArenaAllocations", (int)arena->GetAllocations());
+    RecordProperty("HeapBlocks", (int)arena->GetBlockCount());
+    ASSERT_GE(arena->GetAllocations(), 800u);
+    ASSERT_LT(arena->GetBlockCount(), 10u);
+
+    // Tearing down the machine leaves the arena to its last owner
+    models.clear();
+    ASSERT_EQ(1, arena.use_count());
+}
+
+TEST(ArenaTest, Lifetime)
+{
+    std::shared_ptr<RotatingModel> shaft;
+    std::weak_ptr<MachineArena> weak;
+    {
+        auto arena = std::make_shared<MachineArena>();
+        weak = arena;
+        MachineArena::Scope scope(arena);
+        shaft = MachineArena::Make<RotatingModel>();
+    }
+
+    // The model keeps the arena alive
+    ASSERT_FALSE(weak.expired());
+    ASSERT_EQ(nullptr, MachineArena::Current());
+
+    // Lists grow in the arena after the scope has ended
+    shaft->GetSource()->AddSink(std::make_shared<RotatingModel>());
+    shaft->SetRotation(0.5);
+    ASSERT_EQ(1u, shaft->GetSource()->GetSinks().size());
+    ASSERT_GT(weak.lock()->GetBytes(), sizeof(RotatingModel));
+
+    shaft.reset();
+    ASSERT_TRUE(weak.expired());
+}
@@ -0,0 +1,96 @@
+/**
+ * @file CheckpointTest.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "gtest/gtest.h"
+
+#include <MachineSystem.h>
+#include <Machine.h>
+
+/**
+ * Get the complete component state of a machine system
+ * @param system Machine system to save
+ * @return Saved state
+ */
+static std::vector<double> SaveState(MachineSystem& system)
+{
+    std::vector<double> state;
+    system.GetMachine()->SaveState(state);
+    return state;
+}
+
+TEST(CheckpointTest, BackwardSeekMatchesReplay)
+{
+    MachineSystem replayed(L".");
+    replayed.SetEvaluateDirectly(false);
+    replayed.SetMachineFrame(450);
+
+    MachineSystem seeked(L".");
+    seeked.SetEvaluateDirectly(false);
+    seeked.SetCheckpointInterval(30);
+    seeked.SetMachineFrame(900);
+    ASSERT_EQ(30u, seeked.GetCheckpoints().GetCount());
+
+    seeked.SetMachineFrame(450);
+    ASSERT_NEAR(450.0 / 30.0, seeked.GetMachineTime(), 0.001);
+
+    auto expected = SaveState(replayed);
+    auto actual = SaveState(seeked);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        ASSERT_NEAR(expected[i], actual[i], 1e-9);
+    }
+}
+
+TEST(CheckpointTest, Budget)
+{
+    MachineSystem system(L".");
+    system.SetEvaluateDirectly(false);
+    system.SetCheckpointInterval(10);
+    system.SetMachineFrame(100);
+    ASSERT_EQ(10u, system.GetCheckpoints().GetCount());
+
+    // Shrinking the budget discards checkpoints until it fits
+    auto bytes = system.GetCheckpoints().GetBytes();
+    system.SetCheckpointBudget(bytes / 2);
+    ASSERT_LE(system.GetCheckpoints().GetBytes(), bytes / 2);
+    ASSERT_EQ(5u, system.GetCheckpoints().GetCount());
+
+    // The machine is stepped at the tick rate, so only a new
+    // tick rate invalidates the checkpoints
+    system.SetFrameRate(15);
+    ASSERT_EQ(5u, system.GetCheckpoints().GetCount());
+    system.SetTickRate(60);
+    ASSERT_EQ(0u, system.GetCheckpoints().GetCount());
+}
+
+TEST(CheckpointTest, MachineCache)
+{
+    MachineSystem system(L".");
+    system.SetEvaluateDirectly(false);
+    system.SetCheckpointInterval(30);
+    system.SetMachineFrame(300);
+    auto first = system.GetMachine();
+    auto expected = SaveState(system);
+
+    // Choosing another machine keeps the frame
+    system.ChooseMachine(2);
+    ASSERT_NE(first, system.GetMachine());
+    ASSERT_NEAR(300.0 / 30.0, system.GetMachineTime(), 0.001);
+    ASSERT_EQ(2u, system.GetMachineCacheCount());
+
+    // Coming back reuses the machine and its checkpoints
+    system.ChooseMachine(1);
+    ASSERT_EQ(first, system.GetMachine());
+    ASSERT_EQ(10u, system.GetCheckpoints().GetCount());
+    ASSERT_EQ(expected, SaveState(system));
+
+    // Without a cache every choice builds a new machine
+    system.SetMachineCacheSize(0);
+    ASSERT_EQ(0u, system.GetMachineCacheCount());
+    system.ChooseMachine(1);
+    ASSERT_NE(first, system.GetMachine());
+}
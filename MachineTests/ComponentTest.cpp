@@ -0,0 +1,257 @@
+/**
+ * @file ComponentTest.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "gtest/gtest.h"
+
+#include <Shaft.h>
+#include <Crank.h>
+#include <Pulley.h>
+#include <RotatingModel.h>
+#include <Sparty.h>
+#include <Cylinder.h>
+#include <SpartyModel.h>
+#include <DrawRecorder.h>
+#include <SoftwareRenderer.h>
+#include <Machine.h>
+#include <IRotationSink.h>
+#include <algorithm>
+
+TEST(ComponentTest, DirtyRect)
+{
+    Shaft shaft;
+    shaft.SetPosition(100, 50);
+    shaft.SetSize(10, 70);
+
+    // The shaft is centered 8 pixels above its position, with
+    // a pixel to spare all around
+    ASSERT_EQ(wxRect(99, 36, 72, 12), shaft.GetBoundingBox());
+
+    // Never drawn is always changed
+    ASSERT_TRUE(shaft.HasChanged());
+    shaft.MarkDrawn();
+    ASSERT_FALSE(shaft.HasChanged());
+    ASSERT_TRUE(shaft.GetDirtyRect().IsEmpty());
+
+    shaft.GetSink()->SetRotation(0.25);
+    ASSERT_TRUE(shaft.HasChanged());
+    ASSERT_EQ(shaft.GetBoundingBox(), shaft.GetDirtyRect());
+}
+
+TEST(ComponentTest, PulleyBelt)
+{
+    // A 30 pixel pulley belted to an 80 pixel pulley, slipping 10%
+    auto pulley1 = std::make_shared<Pulley>(30, 15);
+    auto pulley2 = std::make_shared<Pulley>(80, 15);
+    pulley1->BeltTo(pulley2, 0.1);
+
+    pulley1->GetSink()->SetRotation(0.8);
+    auto driven = std::dynamic_pointer_cast<RotatingModel>(pulley2->GetModel());
+    ASSERT_NEAR(0.8 * 30.0 / 80.0 * 0.9, driven->GetRotation(), 1e-12);
+}
+
+TEST(ComponentTest, MachineDirtyRect)
+{
+    auto crank = std::make_shared<Crank>();
+    crank->SetPosition(0, 0);
+    crank->SetSpeed(0.5);
+    auto shaft = std::make_shared<Shaft>();
+    shaft->SetPosition(200, 0);
+    shaft->SetSize(10, 50);
+    crank->GetSource()->AddSink(shaft->GetSink());
+
+    Machine machine;
+    machine.AddComponent(shaft);
+    machine.AddComponent(crank);
+    machine.Compile();
+    crank->MarkDrawn();
+    shaft->MarkDrawn();
+    ASSERT_TRUE(machine.GetDirtyRect().IsEmpty());
+
+    // Turning the crank dirties both the crank and the shaft
+    machine.Advance(0.1);
+    auto dirty = machine.GetDirtyRect();
+    ASSERT_TRUE(dirty.Contains(crank->GetBoundingBox()));
+    ASSERT_TRUE(dirty.Contains(shaft->GetBoundingBox()));
+}
+
+/**
+ * Draw a machine into an image
+ * @param machine Machine to draw
+ * @return Image of the machine
+ */
+static wxImage DrawImage(Machine& machine)
+{
+    wxImage image(200, 100);
+    {
+        std::shared_ptr<wxGraphicsContext> graphics(wxGraphicsContext::Create(image));
+        graphics->Translate(10.5, 50);
+        machine.Draw(graphics);
+    }
+    return image;
+}
+
+TEST(ComponentTest, Layers)
+{
+    auto crank = std::make_shared<Crank>();
+    crank->SetPosition(50, 0);
+    crank->SetSpeed(0.5);
+    auto shaft = std::make_shared<Shaft>();
+    shaft->SetPosition(100, 0);
+    shaft->SetSize(10, 50);
+
+    Machine cached;
+    cached.AddComponent(shaft);
+    cached.AddComponent(crank);
+    cached.Compile();
+
+    // Nothing is cached until the shaft has been drawn once
+    DrawImage(cached);
+    ASSERT_EQ(0u, cached.GetLayers().GetLayerCount());
+
+    // The shaft is not driven, so it never changes
+    cached.Advance(0.1);
+    auto layered = DrawImage(cached);
+    ASSERT_EQ(1u, cached.GetLayers().GetLayerCount());
+
+    cached.SetLayerCaching(false);
+    auto direct = DrawImage(cached);
+    ASSERT_EQ(0u, cached.GetLayers().GetLayerCount());
+
+    // Antialiased edges may round differently through the layer
+    for (int i = 0; i < 200 * 100 * 3; i++)
+    {
+        ASSERT_NEAR(direct.GetData()[i], layered.GetData()[i], 2);
+    }
+}
+
+/**
+ * Record Sparty at a time after the key dropped
+ * @param sparty Sparty to draw
+ * @param time Seconds since the key dropped
+ * @param list Draw list to record into
+ * @return The paths Sparty stroked, in order
+ */
+static std::vector<std::shared_ptr<const DrawList::Path>> RecordSparty(Sparty& sparty, double time, DrawList& list)
+{
+    auto model = std::dynamic_pointer_cast<SpartyModel>(sparty.GetModel());
+    model->Reset();
+    model->KeyDroppedTriggered(0);
+    model->Advance(time);
+
+    SoftwareRenderer renderer(200, 200);
+    list.Clear();
+    std::shared_ptr<wxGraphicsContext> recorder = std::make_shared<DrawRecorder>(renderer, list);
+    sparty.Draw(recorder);
+
+    std::vector<std::shared_ptr<const DrawList::Path>> paths;
+    for (auto& command : list.GetCommands())
+    {
+        if (command.mType == DrawList::Type::Stroke)
+        {
+            paths.push_back(list.GetPath(command.mIndex).mPath);
+        }
+    }
+    return paths;
+}
+
+TEST(ComponentTest, SpartySpring)
+{
+    const int Links = 5;
+    Sparty sparty(L"images/sparty.png", 100, 200, 40, Links);
+    auto model = std::dynamic_pointer_cast<SpartyModel>(sparty.GetModel());
+
+    // Bouncing on the extended spring at two different offsets
+    DrawList list;
+    auto first = RecordSparty(sparty, 1.0, list);
+    double horizontal = model->GetHorizontalOffset();
+    double bounce = model->GetBounceOffset();
+    ASSERT_EQ(2u, first.size());
+
+    auto second = RecordSparty(sparty, 2.0, list);
+    ASSERT_NE(bounce, model->GetBounceOffset());
+    ASSERT_EQ(2u, second.size());
+    ASSERT_EQ(first[1].get(), second[1].get());
+
+    // The spring is drawn as it always was, starting at the horizontal
+    // offset in its own coordinates, then again at the translation
+    double length = model->GetSpringPosition();
+    double linkLength = length / Links;
+    std::vector<wxPoint2DDouble> expected = {{horizontal, 0}};
+    double y1 = 0;
+    for (int i = 0; i < Links; i++)
+    {
+        double y2 = y1 - linkLength;
+        double y3 = y2 - linkLength / 2;
+        expected.insert(expected.end(), {{20, y1}, {20, y3}, {0, y3}, {-20, y3}, {-20, y2}, {0, y2}});
+        y1 = y2;
+    }
+
+    // The first stroke is the start of the spring, the second the rest of it
+    first = RecordSparty(sparty, 1.0, list);
+    auto points = first[0]->GetPoints();
+    auto rest = first[1]->GetPoints();
+    ASSERT_EQ(rest[0], points.back());
+    points.insert(points.end(), rest.begin() + 1, rest.end());
+    ASSERT_EQ(expected.size(), points.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        ASSERT_NEAR(expected[i].m_x, points[i].m_x, 1e-9);
+        ASSERT_NEAR(expected[i].m_y, points[i].m_y, 1e-9);
+    }
+
+    // Stretching the spring makes the path again
+    auto stretching = RecordSparty(sparty, 0.1, list);
+    ASSERT_NE(length, model->GetSpringPosition());
+    ASSERT_NE(second[1].get(), stretching[1].get());
+}
+
+TEST(ComponentTest, CylinderLines)
+{
+    const double Diameter = 20;
+    const double Length = 60;
+    const int LineWidth = 2;
+    const double Offset = 0.05;
+
+    for (int lines : {3, 7, 12})
+    {
+        cse335::Cylinder cylinder;
+        cylinder.SetSize((int)Diameter, (int)Length);
+        cylinder.SetLines(*wxBLACK, LineWidth, lines);
+        cylinder.SetOffset(Offset);
+
+        for (double rotation : {0.1, 0.37, 0.83})
+        {
+            SoftwareRenderer renderer(100, 100);
+            DrawList list;
+            std::shared_ptr<wxGraphicsContext> recorder = std::make_shared<DrawRecorder>(renderer, list);
+            cylinder.Draw(recorder, 10, 50, rotation);
+
+            // The visible lines, each with its own sine and cosine
+            std::vector<wxPoint2DDouble> expected;
+            for (int i = 0; i < lines; i++)
+            {
+                double angle = (rotation + Offset) * M_PI * 2 + M_PI * 2 * i / lines;
+                if (cos(angle) > 0)
+                {
+                    double y = 50 - sin(angle) * (Diameter - LineWidth) / 2;
+                    expected.insert(expected.end(), {{11, y}, {10 + Length, y}});
+                }
+            }
+
+            auto& commands = list.GetCommands();
+            auto stroke = std::find_if(commands.begin(), commands.end(),
+                    [](const DrawList::Command& command) {return command.mType == DrawList::Type::Stroke;});
+            ASSERT_NE(commands.end(), stroke);
+            auto& points = list.GetPath(stroke->mIndex).mPath->GetPoints();
+            ASSERT_EQ(expected.size(), points.size());
+            for (size_t i = 0; i < expected.size(); i++)
+            {
+                ASSERT_NEAR(expected[i].m_x, points[i].m_x, 1e-9);
+                ASSERT_NEAR(expected[i].m_y, points[i].m_y, 1e-9);
+            }
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/**
+ * @file DrawListTest.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "gtest/gtest.h"
+
+#include <DrawList.h>
+#include <DrawRecorder.h>
+#include <Shaft.h>
+#include <Crank.h>
+#include <Machine.h>
+
+/**
+ * Draw a few rectangles, some of them more than once
+ * @param graphics Graphics context to draw on
+ */
+static void DrawScene(std::shared_ptr<wxGraphicsContext> graphics)
+{
+    graphics->SetPen(*wxTRANSPARENT_PEN);
+    graphics->SetBrush(*wxRED_BRUSH);
+    graphics->DrawRectangle(10, 10, 20, 20);
+    graphics->SetBrush(*wxRED_BRUSH);
+    graphics->DrawRectangle(40, 10, 20, 20);
+
+    graphics->PushState();
+    graphics->Translate(0, 0);
+    graphics->PopState();
+
+    graphics->SetBrush(*wxRED_BRUSH);
+    graphics->DrawRectangle(70, 10, 20, 20);
+
+    // Overlaps the last one, so it cannot be merged with it
+    graphics->SetBrush(wxBrush(wxColour(0, 0, 255, 128)));
+    graphics->DrawRectangle(15, 15, 20, 20);
+    graphics->DrawRectangle(20, 20, 20, 20);
+}
+
+TEST(DrawListTest, Optimize)
+{
+    wxImage image(100, 50);
+    std::shared_ptr<wxGraphicsContext> graphics(wxGraphicsContext::Create(image));
+
+    DrawList list;
+    std::shared_ptr<wxGraphicsContext> recorder = std::make_shared<DrawRecorder>(graphics, list);
+    DrawScene(recorder);
+    ASSERT_EQ(13u, list.GetRecordedCount());
+
+    // The pen and a brush, the red rectangles as one fill,
+    // then a brush and the two blue rectangles
+    list.Optimize();
+    ASSERT_EQ(13u, list.GetRecordedCount());
+    ASSERT_EQ(6u, list.GetCount());
+
+    auto& commands = list.GetCommands();
+    ASSERT_EQ(DrawList::Type::Pen, commands[0].mType);
+    ASSERT_EQ(DrawList::Type::Brush, commands[1].mType);
+    ASSERT_EQ(DrawList::Type::Draw, commands[2].mType);
+    ASSERT_EQ(DrawList::Type::Brush, commands[3].mType);
+    ASSERT_EQ(DrawList::Type::Draw, commands[4].mType);
+    ASSERT_EQ(DrawList::Type::Draw, commands[5].mType);
+
+    // Three rectangles of a move, three lines and a close
+    ASSERT_EQ(15u, list.GetPath(commands[2].mIndex).mPath->GetOps().size());
+}
+
+TEST(DrawListTest, Replay)
+{
+    wxImage direct(100, 50);
+    {
+        std::shared_ptr<wxGraphicsContext> graphics(wxGraphicsContext::Create(direct));
+        DrawScene(graphics);
+    }
+
+    wxImage replayed(100, 50);
+    {
+        std::shared_ptr<wxGraphicsContext> graphics(wxGraphicsContext::Create(replayed));
+        DrawList list;
+        std::shared_ptr<wxGraphicsContext> recorder = std::make_shared<DrawRecorder>(graphics, list);
+        DrawScene(recorder);
+        list.Optimize();
+        list.Replay(graphics);
+    }
+
+    for (int i = 0; i < 100 * 50 * 3; i++)
+    {
+        ASSERT_NEAR(direct.GetData()[i], replayed.GetData()[i], 1);
+    }
+}
+
+TEST(DrawListTest, Path)
+{
+    DrawList::Path path;
+    path.Arc(50, 50, 10, 0, 2 * M_PI, true);
+    path.Close();
+
+    double left, top, right, bottom;
+    ASSERT_TRUE(path.GetBounds(&left, &top, &right, &bottom));
+    ASSERT_NEAR(40, left, 0.01);
+    ASSERT_NEAR(60, right, 0.01);
+    ASSERT_TRUE(path.Contains(50, 50, wxODDEVEN_RULE));
+    ASSERT_TRUE(path.Contains(59, 50, wxODDEVEN_RULE));
+    ASSERT_FALSE(path.Contains(58, 58, wxODDEVEN_RULE));
+
+    DrawList::Matrix matrix;
+    matrix.Translate(100, 0);
+    matrix.Scale(2, 2);
+    path.Transform(matrix);
+    ASSERT_TRUE(path.Contains(200, 100, wxODDEVEN_RULE));
+    ASSERT_FALSE(path.Contains(50, 50, wxODDEVEN_RULE));
+}
+
+TEST(DrawListTest, Machine)
+{
+    auto crank = std::make_shared<Crank>();
+    crank->SetPosition(50, 0);
+    auto shaft = std::make_shared<Shaft>();
+    shaft->SetPosition(100, 0);
+    shaft->SetSize(10, 50);
+
+    Machine machine;
+    machine.AddComponent(shaft);
+    machine.AddComponent(crank);
+    machine.Compile();
+    machine.SetLayerCaching(false);
+
+    wxImage image(200, 100);
+    std::shared_ptr<wxGraphicsContext> graphics(wxGraphicsContext::Create(image));
+    machine.Draw(graphics);
+
+    auto& list = machine.GetDrawList();
+    ASSERT_GT(list.GetRecordedCount(), 0u);
+    ASSERT_LT(list.GetCount(), list.GetRecordedCount());
+}
@@ -0,0 +1,76 @@
+/**
+ * @file ImageCacheTest.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "gtest/gtest.h"
+
+#include <ImageCache.h>
+#include <MachineSystem.h>
+#include <SoftwareRenderer.h>
+#include <memory>
+
+using namespace cse335;
+
+/// An image the tests load
+static const std::wstring KeyImage = L"images/key.png";
+
+TEST(ImageCacheTest, HitsAndMisses)
+{
+    auto& cache = ImageCache::Get();
+    cache.Evict(KeyImage);
+    cache.ResetCounters();
+
+    // The second load shares the image the first one decoded
+    auto first = cache.Load(KeyImage);
+    auto second = cache.Load(KeyImage);
+    ASSERT_NE(nullptr, first);
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(1u, cache.GetMisses());
+    ASSERT_EQ(1u, cache.GetHits());
+}
+
+TEST(ImageCacheTest, EvictUnused)
+{
+    auto& cache = ImageCache::Get();
+    auto image = cache.Load(KeyImage);
+    std::weak_ptr<const wxImage> cached = image;
+
+    // An image still in use stays
+    cache.EvictUnused();
+    ASSERT_FALSE(cached.expired());
+
+    // Once nothing uses it, it goes, and the next load decodes it again
+    image.reset();
+    cache.EvictUnused();
+    ASSERT_TRUE(cached.expired());
+
+    cache.ResetCounters();
+    cache.Load(KeyImage);
+    ASSERT_EQ(1u, cache.GetMisses());
+    ASSERT_EQ(0u, cache.GetHits());
+}
+
+TEST(ImageCacheTest, LastSystemReleasesBitmaps)
+{
+    auto& cache = ImageCache::Get();
+    SoftwareRenderer renderer(200, 200);
+    auto first = std::make_unique<MachineSystem>(L".");
+    first->DrawMachine(renderer);
+
+    // A second system shares the bitmaps the first one created
+    cache.ResetCounters();
+    auto second = std::make_unique<MachineSystem>(L".");
+    second->DrawMachine(renderer);
+    ASSERT_GT(cache.GetBitmapHits(), 0u);
+    ASSERT_EQ(0u, cache.GetBitmapMisses());
+
+    // Once the last system is gone they are released
+    second.reset();
+    first.reset();
+    cache.ResetCounters();
+    MachineSystem third(L".");
+    third.DrawMachine(renderer);
+    ASSERT_GT(cache.GetBitmapMisses(), 0u);
+}
@@ -0,0 +1,203 @@
+/**
+ * @file LoaderTest.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "gtest/gtest.h"
+
+#include <MachineLoader.h>
+#include <MachineRegistry.h>
+#include <MachineSnapshot.h>
+#include <Machine.h>
+#include <Mechanism.h>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <string>
+
+/// A small machine: a crank turning a belted cam that triggers a box
+static const char* Description =
+    "# Test machine\n"
+    "box     box     0    0     250 240\n"
+    "crank   crank   150  -180  0.5\n"
+    "shaft   shaft   90   -180  10 70 0.3   # comments may follow\n"
+    "pulley  p1      103  -180  30 15\n"
+    "pulley  p2      -80  -180  60 15\n"
+    "cam     cam     -80  -180  0.44\n"
+    "\n"
+    "drive   crank   shaft\n"
+    "drive   shaft   p1\n"
+    "belt    p1      p2\n"
+    "drive   p2      cam\n"
+    "keydrop cam     box\n"
+    "draw    box crank shaft p2 p1 cam\n";
+
+TEST(LoaderTest, Parse)
+{
+    MachineLoader loader(L".");
+    auto machine = loader.Parse(Description, strlen(Description));
+    ASSERT_NE(nullptr, machine);
+    ASSERT_TRUE(loader.GetError().empty());
+
+    machine->Compile();
+    ASSERT_EQ(6u, machine->GetMechanism()->GetModelCount());
+
+    // Everything the loader builds can be evaluated directly
+    ASSERT_TRUE(machine->GetMechanism()->CanEvaluate());
+    machine->GetMechanism()->EvaluateAt(10);
+    std::vector<double> state;
+    machine->SaveState(state);
+    ASSERT_FALSE(state.empty());
+}
+
+TEST(LoaderTest, Errors)
+{
+    MachineLoader loader(L".");
+
+    const char* unknown = "crank crank 0 0 0.5\n\ndrive crank shaft\n";
+    ASSERT_EQ(nullptr, loader.Parse(unknown, strlen(unknown)));
+    ASSERT_EQ(L"Line 3: unknown id shaft", loader.GetError());
+
+    const char* number = "crank crank 0 0 fast\n";
+    ASSERT_EQ(nullptr, loader.Parse(number, strlen(number)));
+    ASSERT_EQ(L"Line 1: expected a number", loader.GetError());
+
+    const char* count = "shaft shaft 0 0 10 70\n";
+    ASSERT_EQ(nullptr, loader.Parse(count, strlen(count)));
+    ASSERT_EQ(L"Line 1: expected 3 parameters for shaft", loader.GetError());
+}
+
+/**
+ * Turn a crank driving a 30 pixel pulley belted to an 80 pixel one
+ * @param belt Belt statement
+ * @return Saved state of the machine after two seconds
+ */
+static std::vector<double> Belted(const std::string& belt)
+{
+    auto description = "crank  crank 0 0 0.5\n"
+                       "pulley p1    0 0 30 15\n"
+                       "pulley p2    0 0 80 15\n"
+                       "drive  crank p1\n"
+                       "draw   crank p1 p2\n" + belt + "\n";
+
+    MachineLoader loader(L".");
+    auto machine = loader.Parse(description.c_str(), description.size());
+    EXPECT_NE(nullptr, machine);
+    machine->Compile();
+    machine->GetMechanism()->EvaluateAt(2);
+
+    std::vector<double> state;
+    machine->SaveState(state);
+    return state;
+}
+
+TEST(LoaderTest, BeltSlip)
+{
+    auto gripping = Belted("belt p1 p2");
+    auto slipping = Belted("belt p1 p2 0.1");
+    ASSERT_EQ(gripping.size(), slipping.size());
+
+    // Only the driven pulley changes, and it turns 10% less
+    int changed = 0;
+    for (size_t i = 0; i < gripping.size(); i++)
+    {
+        if (gripping[i] != slipping[i])
+        {
+            ASSERT_NEAR(0.375, gripping[i], 1e-12);
+            ASSERT_NEAR(0.375 * 0.9, slipping[i], 1e-12);
+            changed++;
+        }
+    }
+    ASSERT_EQ(1, changed);
+}
+
+TEST(LoaderTest, Ranges)
+{
+    MachineLoader loader(L".");
+
+    const char* diameter = "pulley p1 0 0 0 15\n";
+    ASSERT_EQ(nullptr, loader.Parse(diameter, strlen(diameter)));
+    ASSERT_EQ(L"Line 1: pulley diameter must be positive", loader.GetError());
+
+    for (const char* slip : {"-0.1", "1", "nan"})
+    {
+        auto belt = std::string("pulley p1 0 0 30 15\npulley p2 0 0 80 15\nbelt p1 p2 ") + slip + "\n";
+        ASSERT_EQ(nullptr, loader.Parse(belt.c_str(), belt.size()));
+        ASSERT_EQ(L"Line 3: belt slip must be at least 0 and less than 1", loader.GetError());
+    }
+
+    for (const char* box : {"box box 1e10 0 250 240\n", "box box 0 0 nan 240\n", "crank crank 0 0 inf\n"})
+    {
+        ASSERT_EQ(nullptr, loader.Parse(box, strlen(box)));
+        ASSERT_EQ(L"Line 1: number out of range", loader.GetError());
+    }
+}
+
+TEST(LoaderTest, Snapshot)
+{
+    MachineLoader loader(L".");
+    MachineSnapshot compiled;
+    ASSERT_TRUE(loader.Compile(Description, strlen(Description), compiled));
+    ASSERT_EQ(6u, compiled.GetComponentCount());
+    ASSERT_EQ(5u, compiled.GetLinkCount());
+    ASSERT_EQ(6u, compiled.GetDrawCount());
+
+    // Copy the bytes the way reading a file would
+    MachineSnapshot read;
+    memcpy(read.Allocate(compiled.GetSize()), compiled.GetData(), compiled.GetSize());
+    ASSERT_TRUE(read.Validate());
+
+    auto machine = loader.Build(read);
+    machine->Compile();
+    ASSERT_EQ(6u, machine->GetMechanism()->GetModelCount());
+
+    // A truncated snapshot is rejected
+    MachineSnapshot truncated;
+    memcpy(truncated.Allocate(compiled.GetSize() - 1), compiled.GetData(), compiled.GetSize() - 1);
+    ASSERT_FALSE(truncated.Validate());
+}
+
+/**
+ * Copy a snapshot the way reading a file would, corrupt the copy and validate it
+ * @param snapshot Valid snapshot to copy
+ * @param corrupt Function that changes the component and link records of the copy
+ * @return true if the corrupted copy is still valid
+ */
+static bool Corrupted(const MachineSnapshot& snapshot,
+        const std::function<void(MachineSnapshot::ComponentRecord*, MachineSnapshot::LinkRecord*)>& corrupt)
+{
+    MachineSnapshot read;
+    memcpy(read.Allocate(snapshot.GetSize()), snapshot.GetData(), snapshot.GetSize());
+    corrupt(const_cast<MachineSnapshot::ComponentRecord*>(read.GetComponents()),
+            const_cast<MachineSnapshot::LinkRecord*>(read.GetLinks()));
+    return read.Validate();
+}
+
+TEST(LoaderTest, CorruptSnapshot)
+{
+    MachineLoader loader(L".");
+    MachineSnapshot compiled;
+    ASSERT_TRUE(loader.Compile(Description, strlen(Description), compiled));
+    ASSERT_TRUE(Corrupted(compiled, [](auto components, auto links) {}));
+
+    // A snapshot is checked the way the description it came from was:
+    // the components are box, crank, shaft, p1, p2 and cam, and the
+    // links are the drives, the belt from p1 to p2 and the key drop
+    ASSERT_FALSE(Corrupted(compiled, [](auto components, auto links) {components[3].mParameters[0] = 0;}));
+    ASSERT_FALSE(Corrupted(compiled, [](auto components, auto links) {links[2].mValue = 1.5;}));
+    ASSERT_FALSE(Corrupted(compiled, [](auto components, auto links) {links[2].mTo = 5;}));
+    ASSERT_FALSE(Corrupted(compiled, [](auto components, auto links) {links[4].mTo = 1;}));
+    ASSERT_FALSE(Corrupted(compiled, [](auto components, auto links) {links[0].mFrom = 0;}));
+    ASSERT_FALSE(Corrupted(compiled, [](auto components, auto links) {components[0].mX = NAN;}));
+    ASSERT_FALSE(Corrupted(compiled, [](auto components, auto links) {components[0].mParameters[0] = 1e300;}));
+    ASSERT_FALSE(Corrupted(compiled, [](auto components, auto links) {components[1].mParameters[0] = INFINITY;}));
+}
+
+TEST(LoaderTest, Registry)
+{
+    MachineRegistry registry;
+    registry.Register(3, L"machine3.machine");
+    ASSERT_EQ(L"machine3.machine", registry.Find(3));
+    ASSERT_TRUE(registry.Find(4).empty());
+}
@@ -0,0 +1,190 @@
+/**
+ * @file MachineSystemTest.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "gtest/gtest.h"
+
+#include <MachineSystem.h>
+#include <Machine.h>
+#include <CamModel.h>
+#include <ImageCache.h>
+#include <SoftwareRenderer.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+TEST(MachineSystemTest, ChooseMachineAsync)
+{
+    MachineSystem system(L".");
+    system.SetMachineFrame(60);
+    auto first = system.GetMachine();
+
+    std::atomic<bool> ready(false);
+    system.ChooseMachineAsync(2, [&ready]() {ready = true;});
+    while (!ready)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // The old machine stays until the next frame is set
+    ASSERT_TRUE(system.IsMachinePending());
+    ASSERT_EQ(1, system.GetMachineNumber());
+    ASSERT_EQ(first, system.GetMachine());
+
+    system.SetMachineFrame(61);
+    ASSERT_FALSE(system.IsMachinePending());
+    ASSERT_EQ(2, system.GetMachineNumber());
+    ASSERT_NE(first, system.GetMachine());
+    ASSERT_NEAR(61.0 / 30.0, system.GetMachineTime(), 0.001);
+
+    // A kept machine is ready right away
+    ready = false;
+    system.ChooseMachineAsync(1, [&ready]() {ready = true;});
+    ASSERT_TRUE(ready);
+    ASSERT_EQ(first, system.GetMachine());
+}
+
+TEST(MachineSystemTest, ChooseMachineAsyncLoadsImages)
+{
+    MachineSystem system(L".");
+    system.SetMachineCacheSize(0);
+
+    auto& cache = cse335::ImageCache::Get();
+    cache.Clear();
+    cache.ResetCounters();
+
+    std::atomic<bool> ready(false);
+    system.ChooseMachineAsync(2, [&ready]() {ready = true;});
+    while (!ready)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // The builder decoded the images, so the first draw does not
+    ASSERT_GT(cache.GetMisses(), 0u);
+    auto misses = cache.GetMisses();
+
+    system.SetMachineFrame(1);
+    ASSERT_EQ(2, system.GetMachineNumber());
+    SoftwareRenderer renderer(200, 200);
+    system.DrawMachine(renderer);
+    ASSERT_EQ(misses, cache.GetMisses());
+}
+
+TEST(MachineSystemTest, ChooseMachineReplacesAsync)
+{
+    MachineSystem system(L".");
+    system.SetMachineCacheSize(0);
+    system.ChooseMachineAsync(2);
+    system.ChooseMachine(1);
+    ASSERT_FALSE(system.IsMachinePending());
+
+    system.SetMachineFrame(10);
+    ASSERT_EQ(1, system.GetMachineNumber());
+}
+
+TEST(MachineSystemTest, ChooseMachineAsyncDoesNotWait)
+{
+    // The first builder holds its thread until it is released. These
+    // outlive the system, which joins the builder when it goes away.
+    std::promise<void> entered;
+    std::promise<void> release;
+    auto released = release.get_future();
+
+    MachineSystem system(L".");
+    system.SetMachineCacheSize(0);
+    system.ChooseMachineAsync(2, [&entered, &released]() {
+        entered.set_value();
+        released.wait();
+    });
+    entered.get_future().wait();
+
+    std::thread releaser([&release]() {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        release.set_value();
+    });
+
+    // A second choice returns without waiting for the first builder
+    std::atomic<bool> ready(false);
+    auto start = std::chrono::steady_clock::now();
+    system.ChooseMachineAsync(1, [&ready]() {ready = true;});
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    releaser.join();
+    ASSERT_LT(elapsed, std::chrono::milliseconds(500));
+
+    while (!ready)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    system.SetMachineFrame(10);
+    ASSERT_FALSE(system.IsMachinePending());
+    ASSERT_EQ(1, system.GetMachineNumber());
+}
+
+TEST(MachineSystemTest, EventSchedule)
+{
+    MachineSystem system(L".");
+    system.SetEvaluateDirectly(false);
+    auto schedule = system.GetEventSchedule();
+    ASSERT_EQ(1u, schedule.size());
+    ASSERT_GT(schedule[0].mTime, 0);
+
+    // Playing the machine drops the key when the schedule says
+    int frame = (int)(schedule[0].mTime * 30) + 2;
+    system.SetMachineFrame(frame);
+    ASSERT_TRUE(schedule[0].mCam->IsKeyDropped());
+    ASSERT_NEAR(schedule[0].mTime, schedule[0].mCam->GetKeyDropTime(), 1e-9);
+}
+
+TEST(MachineSystemTest, FixedTimestep)
+{
+    auto state = [](MachineSystem& system) {
+        std::vector<double> state;
+        system.GetMachine()->SaveState(state);
+        return state;
+    };
+
+    MachineSystem expected(L".");
+    expected.SetEvaluateDirectly(false);
+    expected.SetMachineTime(6);
+
+    // Changing the frame rate part way does not change where the machine ends up
+    MachineSystem changed(L".");
+    changed.SetEvaluateDirectly(false);
+    changed.SetMachineFrame(45);
+    changed.SetFrameRate(60);
+    changed.SetMachineFrame(360);
+    ASSERT_NEAR(6.0, changed.GetMachineTime(), 1e-9);
+
+    // Nor does stopping between ticks on the way
+    MachineSystem between(L".");
+    between.SetEvaluateDirectly(false);
+    between.SetMachineTime(2.01);
+    between.SetMachineTime(4.999);
+    between.SetMachineTime(6);
+
+    auto values = state(expected);
+    auto changedValues = state(changed);
+    auto betweenValues = state(between);
+    ASSERT_EQ(values.size(), changedValues.size());
+    ASSERT_EQ(values.size(), betweenValues.size());
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        ASSERT_NEAR(values[i], changedValues[i], 1e-9);
+        ASSERT_NEAR(values[i], betweenValues[i], 1e-9);
+    }
+
+    // A faster tick rate steps to the same state
+    expected.SetTickRate(240);
+    ASSERT_EQ(240, expected.GetTickRate());
+    expected.SetMachineTime(6);
+    auto faster = state(expected);
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        ASSERT_NEAR(values[i], faster[i], 1e-6);
+    }
+}
@@ -0,0 +1,76 @@
+/**
+ * @file ParallelRendererTest.cpp
+ * @author Thomas Conley
+ *
+ * Renders on several threads at once. Configure with MACHINE_TSAN
+ * to run these under ThreadSanitizer.
+ */
+
+#include "pch.h"
+#include "gtest/gtest.h"
+
+#include <ParallelRenderer.h>
+#include <MachineSystem.h>
+#include <ImageCache.h>
+#include <algorithm>
+#include <map>
+
+/**
+ * Render a range of frames and keep them
+ * @param threads Number of worker threads
+ * @param software true to draw with the software renderer
+ * @return Frames by frame number
+ */
+static std::map<int, wxImage> Render(int threads, bool software)
+{
+    ParallelRenderer renderer(L".", 160, 120);
+    renderer.SetScale(0.25);
+    renderer.SetSoftware(software);
+    renderer.SetThreads(threads);
+    renderer.SetChunkFrames(5);
+
+    std::map<int, wxImage> frames;
+    bool written = renderer.Render(0, 39, [&frames](int frame, const wxImage& image) {
+        frames[frame] = image.Copy();
+        return true;
+    });
+    EXPECT_TRUE(written);
+    return frames;
+}
+
+TEST(ParallelRendererTest, MatchesOneThread)
+{
+    // Every worker draws the same cached images at once
+    auto expected = Render(1, true);
+    auto actual = Render(4, true);
+    ASSERT_EQ(40u, actual.size());
+
+    for (const auto& frame : expected)
+    {
+        auto& image = actual[frame.first];
+        ASSERT_EQ(frame.second.GetWidth(), image.GetWidth());
+        size_t bytes = (size_t)image.GetWidth() * image.GetHeight() * 3;
+        ASSERT_TRUE(std::equal(image.GetData(), image.GetData() + bytes, frame.second.GetData()));
+    }
+}
+
+TEST(ParallelRendererTest, GraphicsContext)
+{
+    // The wx renderer goes through the per-thread bitmap cache
+    auto frames = Render(4, false);
+    ASSERT_EQ(40u, frames.size());
+}
+
+TEST(ParallelRendererTest, WorkersReleaseBitmaps)
+{
+    // A live system keeps the cached bitmaps, except those the
+    // workers created for themselves
+    MachineSystem system(L".");
+    auto& cache = cse335::ImageCache::Get();
+    cache.ClearBitmaps();
+    cache.ResetCounters();
+
+    Render(4, true);
+    ASSERT_GT(cache.GetBitmapMisses(), 0u);
+    ASSERT_EQ(0u, cache.GetBitmapCount());
+}
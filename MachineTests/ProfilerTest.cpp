@@ -0,0 +1,119 @@
+/**
+ * @file ProfilerTest.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "gtest/gtest.h"
+
+#include <FrameProfiler.h>
+#include <thread>
+
+TEST(ProfilerTest, Stats)
+{
+    FrameProfiler profiler;
+    int crank = profiler.AddComponent(L"Crank");
+    int box = profiler.AddComponent(L"Box");
+
+    // Draw times of 1 to 100 microseconds
+    for (int i = 1; i <= 100; i++)
+    {
+        profiler.Record(box, FrameProfiler::Phase::Draw, i * 1e-6);
+    }
+
+    auto stats = profiler.GetStats(box, FrameProfiler::Phase::Draw);
+    ASSERT_EQ(L"Box", stats.mName);
+    ASSERT_EQ(100u, stats.mCount);
+    ASSERT_NEAR(50.5e-6, stats.mMean, 1e-12);
+    ASSERT_NEAR(95e-6, stats.mP95, 1e-12);
+    ASSERT_NEAR(99e-6, stats.mP99, 1e-12);
+    ASSERT_NEAR(100e-6, stats.mMax, 1e-12);
+
+    // Nothing was recorded for the crank or the box advance
+    ASSERT_EQ(0u, profiler.GetStats(crank, FrameProfiler::Phase::Draw).mCount);
+    ASSERT_EQ(0u, profiler.GetStats(box, FrameProfiler::Phase::Advance).mCount);
+}
+
+TEST(ProfilerTest, RingBuffer)
+{
+    FrameProfiler profiler;
+    int component = profiler.AddComponent(L"Sparty");
+
+    // Only the most recent samples are kept
+    size_t capacity = FrameProfiler::Capacity;
+    for (size_t i = 0; i < capacity * 3; i++)
+    {
+        profiler.Record(component, FrameProfiler::Phase::Advance, i < capacity * 2 ? 1.0 : 2.0);
+    }
+
+    auto stats = profiler.GetStats(component, FrameProfiler::Phase::Advance);
+    ASSERT_EQ(capacity, stats.mCount);
+    ASSERT_NEAR(2.0, stats.mMean, 1e-12);
+
+    profiler.Clear();
+    ASSERT_EQ(0u, profiler.GetStats(component, FrameProfiler::Phase::Advance).mCount);
+    ASSERT_EQ(1u, profiler.GetComponentCount());
+}
+
+TEST(ProfilerTest, DrawCalls)
+{
+    FrameProfiler profiler;
+    profiler.RecordDrawCalls(120, 45);
+
+    auto calls = profiler.GetDrawCalls();
+    ASSERT_EQ(120u, calls.mRecorded);
+    ASSERT_EQ(45u, calls.mReplayed);
+
+    profiler.Clear();
+    ASSERT_EQ(0u, profiler.GetDrawCalls().mRecorded);
+}
+
+TEST(ProfilerTest, FrameStats)
+{
+    FrameProfiler profiler;
+    for (int i = 1; i <= 10; i++)
+    {
+        profiler.RecordFrame(FrameProfiler::FramePhase::Replay, i * 1e-6);
+    }
+
+    // Frame timings are kept apart from every component's
+    auto replay = profiler.GetFrameStats(FrameProfiler::FramePhase::Replay);
+    ASSERT_EQ(L"replay", replay.mName);
+    ASSERT_EQ(10u, replay.mCount);
+    ASSERT_NEAR(5.5e-6, replay.mMean, 1e-12);
+    ASSERT_NEAR(10e-6, replay.mMax, 1e-12);
+    ASSERT_EQ(0u, profiler.GetFrameStats(FrameProfiler::FramePhase::Optimize).mCount);
+    ASSERT_EQ(0u, profiler.GetComponentCount());
+
+    {
+        FrameProfiler::Scope scope(profiler, FrameProfiler::FramePhase::Optimize);
+    }
+    ASSERT_EQ(1u, profiler.GetFrameStats(FrameProfiler::FramePhase::Optimize).mCount);
+
+    profiler.Clear();
+    ASSERT_EQ(0u, profiler.GetFrameStats(FrameProfiler::FramePhase::Replay).mCount);
+}
+
+TEST(ProfilerTest, ReadWhileRecording)
+{
+    FrameProfiler profiler;
+    int component = profiler.AddComponent(L"Box");
+
+    // Statistics can be read on another thread while samples are recorded
+    std::thread recorder([&profiler, component]() {
+        for (size_t i = 0; i < FrameProfiler::Capacity * 4; i++)
+        {
+            profiler.Record(component, FrameProfiler::Phase::Draw, 1e-6);
+        }
+    });
+
+    for (int i = 0; i < 100; i++)
+    {
+        auto stats = profiler.GetStats(component, FrameProfiler::Phase::Draw);
+        ASSERT_LE(stats.mCount, FrameProfiler::Capacity);
+        ASSERT_LE(stats.mMax, 1e-6);
+    }
+
+    recorder.join();
+    ASSERT_NEAR(1e-6, profiler.GetStats(component, FrameProfiler::Phase::Draw).mMean, 1e-12);
+}
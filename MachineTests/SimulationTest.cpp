@@ -0,0 +1,376 @@
+/**
+ * @file SimulationTest.cpp
+ * @author Thomas Conley
+ *
+ * Tests of the simulation core. These build mechanisms
+ * directly from models, so no wxWidgets setup is needed.
+ */
+
+#include "pch.h"
+#include "gtest/gtest.h"
+
+#include <Mechanism.h>
+#include <CrankModel.h>
+#include <RotatingModel.h>
+#include <CamModel.h>
+#include <BoxModel.h>
+#include <SpartyModel.h>
+#include <BannerModel.h>
+#include <RotationGraph.h>
+
+TEST(SimulationTest, RotationPropagates)
+{
+    auto crank = std::make_shared<CrankModel>();
+    crank->SetSpeed(0.5);
+    auto shaft = std::make_shared<RotatingModel>();
+    auto pulley = std::make_shared<RotatingModel>();
+    crank->GetSource()->AddSink(shaft);
+    shaft->GetSource()->AddSink(pulley);
+
+    Mechanism mechanism;
+    mechanism.AddModel(crank);
+    mechanism.AddModel(shaft);
+    mechanism.AddModel(pulley);
+
+    // Adding a model twice does not advance it twice
+    mechanism.AddModel(crank);
+    ASSERT_EQ(3u, mechanism.GetModelCount());
+
+    for (int i = 0; i < 60; i++)
+    {
+        mechanism.Advance(1.0 / 30.0);
+    }
+
+    ASSERT_NEAR(1.0, crank->GetRotation(), 1e-9);
+    ASSERT_NEAR(1.0, pulley->GetRotation(), 1e-9);
+
+    mechanism.Reset();
+    ASSERT_EQ(0.0, crank->GetRotation());
+}
+
+TEST(SimulationTest, KeyDrop)
+{
+    auto cam = std::make_shared<CamModel>();
+    auto box = std::make_shared<BoxModel>();
+    auto sparty = std::make_shared<SpartyModel>(260);
+    auto banner = std::make_shared<BannerModel>(400);
+    cam->AddKeyDrop(box.get());
+    cam->AddKeyDrop(sparty.get());
+    cam->AddKeyDrop(banner.get());
+
+    Mechanism mechanism;
+    mechanism.AddModel(cam);
+    mechanism.AddModel(box);
+    mechanism.AddModel(sparty);
+    mechanism.AddModel(banner);
+
+    double keyY = cam->GetKeyY();
+    cam->DropKey();
+    cam->DropKey();
+    ASSERT_TRUE(cam->IsKeyDropped());
+    ASSERT_NEAR(keyY + 10, cam->GetKeyY(), 1e-9);
+
+    for (int i = 0; i < 300; i++)
+    {
+        mechanism.Advance(1.0 / 30.0);
+    }
+
+    ASSERT_NEAR(M_PI / 2, box->GetLidAngle(), 1e-9);
+    ASSERT_NEAR(260, sparty->GetSpringPosition(), 25);
+    ASSERT_GT(banner->GetUnfurlProgress(), 0);
+
+    // State round trips through a checkpoint
+    std::vector<double> state;
+    mechanism.SaveState(state);
+    mechanism.Reset();
+    ASSERT_FALSE(cam->IsKeyDropped());
+    ASSERT_EQ(0.0, box->GetLidAngle());
+
+    mechanism.RestoreState(state);
+    ASSERT_TRUE(cam->IsKeyDropped());
+    ASSERT_NEAR(M_PI / 2, box->GetLidAngle(), 1e-9);
+}
+
+TEST(SimulationTest, EvaluateAt)
+{
+    auto crank = std::make_shared<CrankModel>();
+    crank->SetSpeed(0.5);
+    auto cam = std::make_shared<CamModel>();
+    auto box = std::make_shared<BoxModel>();
+    auto sparty = std::make_shared<SpartyModel>(260);
+    auto banner = std::make_shared<BannerModel>(400);
+    crank->GetSource()->AddSink(cam);
+    cam->AddKeyDrop(box.get());
+    cam->AddKeyDrop(sparty.get());
+    cam->AddKeyDrop(banner.get());
+
+    Mechanism mechanism;
+    mechanism.AddModel(crank);
+    mechanism.AddModel(cam);
+    mechanism.AddModel(box);
+    mechanism.AddModel(sparty);
+    mechanism.AddModel(banner);
+    ASSERT_TRUE(mechanism.CanEvaluate());
+
+    // The hole reaches the key when the cam turns to acos(-25/30)
+    double dropTime = std::acos(-25.0 / 30.0) / 0.5;
+
+    mechanism.EvaluateAt(dropTime - 0.1);
+    ASSERT_FALSE(cam->IsKeyDropped());
+    ASSERT_EQ(0.0, box->GetLidAngle());
+    ASSERT_EQ(0.0, banner->GetUnfurlProgress());
+
+    mechanism.EvaluateAt(dropTime + 1);
+    ASSERT_TRUE(cam->IsKeyDropped());
+    ASSERT_NEAR(dropTime, cam->GetKeyDropTime(), 1e-9);
+    ASSERT_NEAR(M_PI / 2, box->GetLidAngle(), 1e-9);
+    ASSERT_NEAR(41.65, banner->GetUnfurlProgress(), 1e-6);
+
+    // Going back in time undoes the drop
+    mechanism.EvaluateAt(1);
+    ASSERT_FALSE(cam->IsKeyDropped());
+    ASSERT_EQ(0.0, banner->GetUnfurlProgress());
+
+    // Stepping frame by frame finds the drop within the frame, so
+    // it matches the closed form without anything being drawn
+    mechanism.Reset();
+    for (int frame = 1; frame <= 300; frame++)
+    {
+        mechanism.Advance(1.0 / 30.0);
+    }
+    ASSERT_TRUE(cam->IsKeyDropped());
+    ASSERT_NEAR(dropTime, cam->GetKeyDropTime(), 1e-9);
+    double steppedProgress = banner->GetUnfurlProgress();
+    double steppedLid = box->GetLidAngle();
+
+    mechanism.EvaluateAt(10);
+    ASSERT_NEAR(steppedProgress, banner->GetUnfurlProgress(), 1e-6);
+    ASSERT_NEAR(steppedLid, box->GetLidAngle(), 1e-9);
+
+    // One long step finds the same time as many short ones
+    mechanism.Reset();
+    mechanism.Advance(10);
+    ASSERT_NEAR(dropTime, cam->GetKeyDropTime(), 1e-9);
+}
+
+TEST(SimulationTest, CompiledRotation)
+{
+    // A long train of shafts with a second path into the last one
+    auto crank = std::make_shared<CrankModel>();
+    crank->SetSpeed(0.5);
+    Mechanism mechanism;
+    mechanism.AddModel(crank);
+
+    std::vector<std::shared_ptr<RotatingModel>> shafts;
+    RotationSource* source = crank->GetSource();
+    for (int i = 0; i < 500; i++)
+    {
+        auto shaft = std::make_shared<RotatingModel>();
+        source->AddSink(shaft);
+        mechanism.AddModel(shaft);
+        shafts.push_back(shaft);
+        source = shaft->GetSource();
+    }
+
+    auto last = std::make_shared<RotatingModel>();
+    shafts[250]->GetSource()->AddSink(last);
+    shafts.back()->GetSource()->AddSink(last);
+    mechanism.AddModel(last);
+
+    RotationGraph graph;
+    graph.Compile(crank->GetSource());
+    ASSERT_EQ(501u, graph.GetSinkCount());
+    ASSERT_EQ(502u, graph.GetEdges().size());
+
+    // Both edges into the last shaft come after the edges into their sources
+    const auto& edges = graph.GetEdges();
+    for (size_t i = 0; i < edges.size(); i++)
+    {
+        for (size_t j = i + 1; j < edges.size(); j++)
+        {
+            ASSERT_NE(edges[i].mSource, edges[j].mSink);
+        }
+    }
+    graph.Clear();
+    ASSERT_FALSE(crank->GetSource()->IsCompiled());
+
+    mechanism.Compile();
+    ASSERT_TRUE(shafts[10]->GetSource()->IsCompiled());
+
+    mechanism.Advance(1.0);
+    ASSERT_NEAR(0.5, shafts.back()->GetRotation(), 1e-9);
+    ASSERT_NEAR(0.5, last->GetRotation(), 1e-9);
+
+    mechanism.EvaluateAt(4.0);
+    ASSERT_NEAR(2.0, shafts[100]->GetRotation(), 1e-9);
+}
+
+TEST(SimulationTest, BeltRatios)
+{
+    // The pulley train from the machines: 30 px belted to 80 px, then 15 px to 90 px
+    auto crank = std::make_shared<CrankModel>();
+    crank->SetSpeed(0.5);
+    auto pulley1 = std::make_shared<RotatingModel>();
+    auto pulley2 = std::make_shared<RotatingModel>();
+    auto pulley3 = std::make_shared<RotatingModel>();
+    auto pulley4 = std::make_shared<RotatingModel>();
+    crank->GetSource()->AddSink(pulley1);
+    pulley1->GetSource()->AddSink(pulley2, 30.0 / 80.0);
+    pulley2->GetSource()->AddSink(pulley3);
+    pulley3->GetSource()->AddSink(pulley4, 15.0 / 90.0 * 0.9);
+
+    Mechanism mechanism;
+    mechanism.AddModel(crank);
+    mechanism.AddModel(pulley1);
+    mechanism.AddModel(pulley2);
+    mechanism.AddModel(pulley3);
+    mechanism.AddModel(pulley4);
+
+    mechanism.EvaluateAt(2);
+    ASSERT_NEAR(0.375, pulley2->GetRotation(), 1e-9);
+    double recursive = pulley4->GetRotation();
+    ASSERT_NEAR(0.375 / 6 * 0.9, recursive, 1e-9);
+
+    // The compiled graph multiplies the ratios out along the path
+    RotationGraph graph;
+    graph.Compile(crank->GetSource());
+    ASSERT_NEAR(30.0 / 80.0 * 15.0 / 90.0 * 0.9, graph.GetScale(4), 1e-12);
+    graph.Clear();
+
+    mechanism.Compile();
+    mechanism.EvaluateAt(2);
+    ASSERT_NEAR(recursive, pulley4->GetRotation(), 1e-12);
+}
+
+/// A model of a type Mechanism has no pool for
+class CounterModel : public ComponentModel {
+public:
+    int mSteps = 0;     ///< Number of times advanced
+    void Reset() override {mSteps = 0;}
+    void Advance(double delta) override {mSteps++;}
+    void SaveState(std::vector<double>& state) override {state.push_back(mSteps);}
+};
+
+TEST(SimulationTest, PooledAdvance)
+{
+    // Two mechanisms of the same models, added in a mixed order
+    auto build = [](Mechanism& mechanism, std::shared_ptr<CounterModel> counter) {
+        auto box = std::make_shared<BoxModel>();
+        auto cam = std::make_shared<CamModel>();
+        auto crank = std::make_shared<CrankModel>();
+        auto shaft = std::make_shared<RotatingModel>();
+        crank->SetSpeed(0.25);
+        crank->GetSource()->AddSink(shaft);
+        shaft->GetSource()->AddSink(cam, 2);
+        cam->AddKeyDrop(box.get());
+
+        mechanism.AddModel(box);
+        mechanism.AddModel(counter);
+        mechanism.AddModel(cam);
+        mechanism.AddModel(shaft);
+        mechanism.AddModel(crank);
+        mechanism.Compile();
+    };
+
+    Mechanism pooled, single;
+    auto counter = std::make_shared<CounterModel>();
+    build(pooled, counter);
+    build(single, std::make_shared<CounterModel>());
+
+    for (int i = 0; i < 100; i++)
+    {
+        pooled.Advance(1.0 / 30.0);
+        for (auto m : single.GetAdvanceOrder())
+        {
+            single.AdvanceModel(m, 1.0 / 30.0);
+        }
+    }
+
+    std::vector<double> pooledState, singleState;
+    pooled.SaveState(pooledState);
+    single.SaveState(singleState);
+    ASSERT_EQ(singleState, pooledState);
+    ASSERT_EQ(100, counter->mSteps);
+
+    // A model added after compiling is still advanced
+    auto late = std::make_shared<CounterModel>();
+    pooled.AddModel(late);
+    pooled.Advance(1.0 / 30.0);
+    ASSERT_EQ(1, late->mSteps);
+}
+
+TEST(SimulationTest, PooledState)
+{
+    auto crank = std::make_shared<CrankModel>();
+    auto box = std::make_shared<BoxModel>();
+    crank->SetSpeed(0.5);
+    {
+        Mechanism mechanism;
+        mechanism.AddModel(crank);
+        mechanism.AddModel(box);
+        mechanism.Advance(1);
+        ASSERT_NEAR(0.5, crank->GetRotation(), 1e-12);
+
+        // The models read and write their state in the pools, and
+        // pooling again after a change carries it over
+        crank->SetSpeed(1);
+        mechanism.AddModel(std::make_shared<BannerModel>(400));
+        mechanism.Advance(1);
+        ASSERT_NEAR(1.5, crank->GetRotation(), 1e-12);
+    }
+
+    // The models take their state back when the mechanism goes
+    ASSERT_NEAR(1.5, crank->GetRotation(), 1e-12);
+    ASSERT_EQ(1.0, crank->GetSpeed());
+    std::vector<double> state;
+    box->SaveState(state);
+    ASSERT_EQ(2.0, state[0]);
+}
+
+TEST(SimulationTest, Schedule)
+{
+    // A cam turned twice as fast as the crank, a tenth of a turn ahead
+    auto crank = std::make_shared<CrankModel>();
+    crank->SetSpeed(0.5);
+    auto shaft = std::make_shared<RotatingModel>();
+    auto cam = std::make_shared<CamModel>();
+    auto box = std::make_shared<BoxModel>();
+    crank->GetSource()->AddSink(shaft);
+    shaft->GetSource()->AddSink(cam, 2, 0.1);
+    cam->AddKeyDrop(box.get());
+
+    Mechanism mechanism;
+    mechanism.AddModel(crank);
+    mechanism.AddModel(shaft);
+    mechanism.AddModel(cam);
+    mechanism.AddModel(box);
+
+    // Solved for before the mechanism is compiled
+    double dropTime = (std::acos(-25.0 / 30.0) - 0.1) / 1.0;
+    auto schedule = mechanism.GetSchedule();
+    ASSERT_EQ(1u, schedule.size());
+    ASSERT_EQ(cam.get(), schedule[0].mCam);
+    ASSERT_NEAR(dropTime, schedule[0].mTime, 1e-9);
+    ASSERT_FALSE(crank->GetSource()->IsCompiled());
+
+    // Stepping reaches the drop at the scheduled time
+    mechanism.Compile();
+    for (int frame = 1; frame <= 90; frame++)
+    {
+        mechanism.Advance(1.0 / 30.0);
+    }
+    ASSERT_NEAR(dropTime, cam->GetKeyDropTime(), 1e-9);
+    double lid = box->GetLidAngle();
+
+    // Seeking sets the box from the time since the drop
+    mechanism.EvaluateAt(1);
+    ASSERT_FALSE(cam->IsKeyDropped());
+    mechanism.EvaluateAt(3);
+    ASSERT_NEAR(lid, box->GetLidAngle(), 1e-9);
+
+    // Changing the speed solves again
+    crank->SetSpeed(0.25);
+    ASSERT_NEAR(dropTime * 2, mechanism.GetSchedule()[0].mTime, 1e-9);
+    mechanism.EvaluateAt(3);
+    ASSERT_FALSE(cam->IsKeyDropped());
+}
@@ -0,0 +1,178 @@
+/**
+ * @file SoftwareRendererTest.cpp
+ * @author Thomas Conley
+ */
+
+#include "pch.h"
+#include "gtest/gtest.h"
+
+#include <SoftwareRenderer.h>
+#include <Shaft.h>
+#include <Crank.h>
+#include <Machine.h>
+
+/**
+ * Make a path entry for a rectangle
+ * @param x Left
+ * @param y Top
+ * @param w Width
+ * @param h Height
+ * @return Path entry
+ */
+static DrawList::PathEntry Rectangle(double x, double y, double w, double h)
+{
+    auto path = std::make_shared<DrawList::Path>();
+    path->MoveTo(x, y);
+    path->LineTo(x + w, y);
+    path->LineTo(x + w, y + h);
+    path->LineTo(x, y + h);
+    path->Close();
+    return {path, wxGraphicsPath()};
+}
+
+/**
+ * Get one channel of a pixel of a software renderer
+ * @param renderer Renderer
+ * @param x X of the pixel
+ * @param y Y of the pixel
+ * @param channel 0 to 3 for red, green, blue and alpha
+ * @return Premultiplied channel value
+ */
+static int Pixel(const SoftwareRenderer& renderer, int x, int y, int channel)
+{
+    double width, height;
+    renderer.GetSize(&width, &height);
+    return renderer.GetPixels()[((size_t)y * (int)width + x) * 4 + channel];
+}
+
+TEST(SoftwareRendererTest, Fill)
+{
+    SoftwareRenderer renderer(20, 10);
+    DrawList::BrushEntry brush;
+    brush.mBrush = wxBrush(wxColour(255, 0, 0));
+    renderer.SetBrush(brush);
+    renderer.FillPath(Rectangle(2.5, 2, 5, 4), wxODDEVEN_RULE);
+
+    // Edges halfway across a pixel cover half of it
+    ASSERT_EQ(0, Pixel(renderer, 1, 3, 3));
+    ASSERT_EQ(128, Pixel(renderer, 2, 3, 3));
+    ASSERT_EQ(255, Pixel(renderer, 3, 3, 3));
+    ASSERT_EQ(255, Pixel(renderer, 6, 3, 0));
+    ASSERT_EQ(128, Pixel(renderer, 7, 3, 3));
+    ASSERT_EQ(0, Pixel(renderer, 4, 1, 3));
+    ASSERT_EQ(0, Pixel(renderer, 4, 6, 3));
+
+    // Without antialiasing a pixel is covered if its center is
+    renderer.SetAntialiasMode(wxANTIALIAS_NONE);
+    renderer.FillPath(Rectangle(10.4, 0, 3.2, 1), wxODDEVEN_RULE);
+    ASSERT_EQ(0, Pixel(renderer, 9, 0, 3));
+    ASSERT_EQ(255, Pixel(renderer, 10, 0, 3));
+    ASSERT_EQ(255, Pixel(renderer, 13, 0, 3));
+    ASSERT_EQ(0, Pixel(renderer, 14, 0, 3));
+
+    // Half transparent blue over the red
+    brush.mBrush = wxBrush(wxColour(0, 0, 255, 128));
+    renderer.SetAntialiasMode(wxANTIALIAS_DEFAULT);
+    renderer.SetBrush(brush);
+    renderer.FillPath(Rectangle(4, 2, 2, 2), wxODDEVEN_RULE);
+    ASSERT_NEAR(127, Pixel(renderer, 4, 2, 0), 1);
+    ASSERT_NEAR(128, Pixel(renderer, 4, 2, 2), 1);
+    ASSERT_EQ(255, Pixel(renderer, 4, 2, 3));
+}
+
+TEST(SoftwareRendererTest, Stroke)
+{
+    SoftwareRenderer renderer(20, 20);
+    DrawList::PenEntry pen;
+    pen.mNull = false;
+    pen.mInfo = wxGraphicsPenInfo(*wxBLACK, 2).Join(wxJOIN_MITER).Cap(wxCAP_BUTT);
+    renderer.SetPen(pen);
+    renderer.StrokePath(Rectangle(5, 5, 10, 10));
+
+    // A two pixel line centered on the edge, with square corners
+    ASSERT_EQ(255, Pixel(renderer, 4, 4, 3));
+    ASSERT_EQ(255, Pixel(renderer, 5, 10, 3));
+    ASSERT_EQ(0, Pixel(renderer, 3, 10, 3));
+    ASSERT_EQ(0, Pixel(renderer, 6, 10, 3));
+    ASSERT_EQ(0, Pixel(renderer, 10, 10, 3));
+}
+
+TEST(SoftwareRendererTest, ClipAndLayer)
+{
+    SoftwareRenderer renderer(20, 4);
+    DrawList::BrushEntry brush;
+    brush.mBrush = wxBrush(wxColour(255, 0, 0));
+    renderer.SetBrush(brush);
+
+    renderer.PushState();
+    renderer.Clip(0, 0, 10, 4);
+    renderer.BeginLayer(0.5);
+    renderer.FillPath(Rectangle(0, 0, 20, 4), wxODDEVEN_RULE);
+    renderer.EndLayer();
+    renderer.PopState();
+
+    ASSERT_EQ(128, Pixel(renderer, 9, 1, 3));
+    ASSERT_EQ(0, Pixel(renderer, 10, 1, 3));
+}
+
+TEST(SoftwareRendererTest, Bitmap)
+{
+    wxImage image(2, 2);
+    image.InitAlpha();
+    image.SetRGB(wxRect(0, 0, 2, 2), 0, 200, 0);
+    image.SetAlpha(1, 1, 0);
+
+    DrawList::BitmapEntry bitmap;
+    bitmap.mBitmap = std::make_shared<DrawList::Bitmap>(std::make_shared<const wxImage>(image));
+
+    // At its own size the bitmap is copied pixel for pixel
+    SoftwareRenderer renderer(8, 8);
+    renderer.DrawBitmap(bitmap, 1, 1, 2, 2);
+    ASSERT_EQ(0, Pixel(renderer, 0, 1, 1));
+    ASSERT_EQ(200, Pixel(renderer, 1, 1, 1));
+    ASSERT_EQ(255, Pixel(renderer, 1, 2, 3));
+    ASSERT_EQ(0, Pixel(renderer, 2, 2, 3));
+
+    // Scaled up it covers four times the pixels
+    renderer.SetInterpolationQuality(wxINTERPOLATION_NONE);
+    renderer.Scale(2, 2);
+    renderer.DrawBitmap(bitmap, 2, 0, 2, 2);
+    ASSERT_EQ(200, Pixel(renderer, 4, 0, 1));
+    ASSERT_EQ(200, Pixel(renderer, 7, 1, 1));
+    ASSERT_EQ(255, Pixel(renderer, 5, 3, 3));
+    ASSERT_EQ(0, Pixel(renderer, 6, 3, 3));
+}
+
+TEST(SoftwareRendererTest, Machine)
+{
+    auto crank = std::make_shared<Crank>();
+    crank->SetPosition(50, 0);
+    auto shaft = std::make_shared<Shaft>();
+    shaft->SetPosition(100, 0);
+    shaft->SetSize(10, 50);
+
+    Machine machine;
+    machine.AddComponent(shaft);
+    machine.AddComponent(crank);
+    machine.Compile();
+
+    SoftwareRenderer renderer(200, 100);
+    renderer.Translate(0, 50);
+    machine.Draw(renderer);
+
+    // Draw again from the cached layers, which must look the same
+    auto first = renderer.GetPixels();
+    ASSERT_TRUE(std::any_of(first.begin(), first.end(), [](unsigned char value) {return value != 0;}));
+
+    SoftwareRenderer again(200, 100);
+    again.Translate(0, 50);
+    machine.Draw(again);
+    for (size_t i = 0; i < first.size(); i++)
+    {
+        ASSERT_NEAR(first[i], again.GetPixels()[i], 2);
+    }
+
+    auto image = renderer.ToImage();
+    ASSERT_EQ(200, image.GetWidth());
+    ASSERT_TRUE(image.HasAlpha());
+}